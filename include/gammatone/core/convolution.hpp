@@ -22,12 +22,14 @@
 
 #include <gammatone/filter.hpp>
 #include <gammatone/detail/impulse_response.hpp>
+#include <gammatone/detail/ir_cache.hpp>
+#include <gammatone/detail/partitioned_convolution.hpp>
 #include <gammatone/detail/utils.hpp>
 #include <algorithm>
+#include <complex>
 #include <numeric>
 #include <memory>
 #include <vector>
-#include <deque>
 
 namespace gammatone
 {
@@ -37,6 +39,26 @@ namespace gammatone
     /*!
       \class convolution
 
+      The impulse response is convolved by a
+      detail::partitioned_convolution: the first block_size() samples
+      directly, the remaining ones by a uniformly partitioned
+      overlap-save FFT convolution. The core thus keeps a null
+      latency, at a cost of about block_size() multiply-adds per
+      sample plus the FFT work, instead of the whole impulse response
+      length.
+
+      With a block size of 0, or larger than the impulse response,
+      the whole impulse response is convolved directly by a SIMD dot
+      product. This is the fastest mode for short impulse responses,
+      it is thus always used for those of high frequency channels
+      (see detail::partitioned_convolution::direct_size). FFT results
+      differ from the direct convolution by rounding errors.
+
+      The impulse response and its convolution are only built on the
+      first computation. The filters of a filterbank, whose channels
+      are computed by a core::convolution_bank, thus only hold their
+      parameters.
+
       \tparam Scalar  Type of scalar values
     */
     template<class Scalar,
@@ -48,9 +70,22 @@ namespace gammatone
 
     public:
 
+      //! Default partition length of the impulse response
+      static constexpr std::size_t default_block_size = 64;
+
+      //! Creates a convolution core
+      /*!
+        \param sample_frequency  The sample frequency (Hz).
+        \param center_frequency  The center frequency (Hz).
+        \param bandwidth         The bandwidth (Hz).
+        \param block_size        Length of the impulse response
+        partitions, rounded up to a power of 2. 0 for a direct
+        convolution.
+      */
       convolution(const Scalar& sample_frequency,
 		  const Scalar& center_frequency,
-		  const Scalar& bandwidth);
+		  const Scalar& bandwidth,
+                  const std::size_t& block_size = default_block_size);
 
       convolution(const this_type& other);
       convolution(this_type&& other) noexcept;
@@ -64,15 +99,71 @@ namespace gammatone
 
         inline void compute(const Scalar& input, Scalar& output);
 
+      //! Compute a block of samples
+      /*!
+        Statically dispatched equivalent of *size* successive calls
+        to compute().
+
+        \param input   Pointer to *size* input scalars
+        \param output  Pointer to *size* output scalars, may be equal to input
+        \param size    Number of samples to process
+      */
+      inline void compute_block(const Scalar* input, Scalar* output, const std::size_t& size);
+
+      //! Compute the analytic output of a block of samples
+      /*!
+        The imaginary part is the convolution by the quadrature
+        impulse response (see
+        detail::impulse_response::theorical_quadrature), the real
+        part being the output of compute_block(). The quadrature
+        impulse response is convolved from the first call on, at
+        about the cost of the impulse response itself, the forward
+        transforms of the input being shared.
+
+        \param input   Pointer to *size* input scalars
+        \param output  Pointer to *size* output values
+        \param size    Number of samples to process
+      */
+      inline void compute_block_complex(const Scalar* input, std::complex<Scalar>* output,
+                                        const std::size_t& size);
+
+      //! Length of the directly convolved partition
+      /*!
+        The whole impulse response length in direct mode.
+      */
+      inline std::size_t block_size() const;
+
+      //! Number of partitions of the impulse response, 1 in direct mode
+      inline std::size_t nb_partitions() const;
+
+      //! The impulse response
+      inline std::vector<Scalar> impulse_response() const;
+
     private:
+      //! Build the impulse response and its convolution, if not done yet
+      inline void prepare();
+
       //! Find impulse response cutoff at a given dB
       void cutoff(const Scalar db = -30);
 
+      //! Push the input samples, calling output(i, current) for each sample i
+      template<class Output>
+      inline void run(const Scalar* input, const std::size_t& size, const Output& output);
+
+      //! Filter parameters, for the impulse responses
+      Scalar m_sample_frequency, m_center_frequency, m_bandwidth;
+
+      //! Requested partitions length
+      std::size_t m_block_size;
+
       //! The underlying impulse response
       std::vector<Scalar> m_ir;
 
-      //! History of the input signal
-      std::deque<Scalar> m_input;
+      //! The convolution engine
+      detail::partitioned_convolution<Scalar> m_convolution;
+
+      //! The last block of input followed by the current one
+      std::vector<Scalar> m_history;
 
       //! Convolution core doesn't use find_factor for gain computation
       inline Scalar find_factor(const Scalar&, const Scalar&, const Scalar&){}
@@ -81,34 +172,48 @@ namespace gammatone
 }
 
 
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+constexpr std::size_t gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::default_block_size;
+
 
 template<class Scalar, class GainPolicy, class ClippingPolicy>
 gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
 convolution(const Scalar& sample_frequency,
             const Scalar& center_frequency,
-            const Scalar& bandwidth)
+            const Scalar& bandwidth,
+            const std::size_t& block_size)
   : base<Scalar, GainPolicy>(sample_frequency,center_frequency,bandwidth),
-  //! \todo remove -60db magic number !
-  m_ir(gammatone::detail::impulse_response::theorical_attenuate(center_frequency,bandwidth,sample_frequency,-60.0))
-{
-  reset();
-}
+  m_sample_frequency(sample_frequency),
+  m_center_frequency(center_frequency),
+  m_bandwidth(bandwidth),
+  m_block_size(block_size)
+{}
 
 
 template<class Scalar, class GainPolicy, class ClippingPolicy>
 gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
 convolution(const convolution<Scalar, GainPolicy,ClippingPolicy>& other)
   : base<Scalar, GainPolicy>(other),
+  m_sample_frequency( other.m_sample_frequency ),
+  m_center_frequency( other.m_center_frequency ),
+  m_bandwidth( other.m_bandwidth ),
+  m_block_size( other.m_block_size ),
   m_ir( other.m_ir ),
-  m_input( other.m_input )
+  m_convolution( other.m_convolution ),
+  m_history( other.m_history )
 {}
 
 template<class Scalar, class GainPolicy, class ClippingPolicy>
 gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
 convolution(convolution<Scalar, GainPolicy,ClippingPolicy>&& other) noexcept
   : base<Scalar, GainPolicy>(std::move(other)),
+  m_sample_frequency( other.m_sample_frequency ),
+  m_center_frequency( other.m_center_frequency ),
+  m_bandwidth( other.m_bandwidth ),
+  m_block_size( other.m_block_size ),
   m_ir( std::move(other.m_ir) ),
-  m_input( std::move(other.m_input) )
+  m_convolution( std::move(other.m_convolution) ),
+  m_history( std::move(other.m_history) )
 {}
 
 
@@ -119,8 +224,13 @@ operator=(const convolution<Scalar, GainPolicy,ClippingPolicy>& other)
 {
   convolution<Scalar, GainPolicy,ClippingPolicy> tmp(other);
   base<Scalar, GainPolicy>::operator=(tmp);
+  std::swap(m_sample_frequency, tmp.m_sample_frequency);
+  std::swap(m_center_frequency, tmp.m_center_frequency);
+  std::swap(m_bandwidth, tmp.m_bandwidth);
+  std::swap(m_block_size, tmp.m_block_size);
   std::swap(m_ir, tmp.m_ir);
-  std::swap(m_input, tmp.m_input);
+  std::swap(m_convolution, tmp.m_convolution);
+  std::swap(m_history, tmp.m_history);
 
   return *this;
 }
@@ -131,8 +241,13 @@ gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
 operator=(convolution<Scalar, GainPolicy,ClippingPolicy>&& other)
 {
   base<Scalar, GainPolicy>::operator=(other);
+  m_sample_frequency = other.m_sample_frequency;
+  m_center_frequency = other.m_center_frequency;
+  m_bandwidth = other.m_bandwidth;
+  m_block_size = other.m_block_size;
   m_ir = std::move(other.m_ir);
-  m_input = std::move(other.m_input);
+  m_convolution = std::move(other.m_convolution);
+  m_history = std::move(other.m_history);
 
   return *this;
 }
@@ -148,7 +263,68 @@ void
 gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
 reset()
 {
-  m_input.assign(m_ir.size(), 0.0);
+  if(m_ir.empty())
+    return;
+
+  m_convolution.reset();
+  m_history.assign(2*m_convolution.block_size(), 0.0);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void
+gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
+prepare()
+{
+  if(! m_ir.empty())
+    return;
+
+  //! \todo remove -60db magic number !
+  m_ir = gammatone::detail::ir_cache<Scalar>::attenuate(
+    m_center_frequency, m_bandwidth, m_sample_frequency, -60.0);
+  m_convolution = gammatone::detail::partitioned_convolution<Scalar>(m_ir, m_block_size);
+  reset();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t
+gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
+block_size() const
+{
+  if(! m_ir.empty())
+    return m_convolution.block_size();
+
+  return gammatone::detail::partitioned_convolution<Scalar>::partition_size(
+    impulse_response().size(), m_block_size);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t
+gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
+nb_partitions() const
+{
+  if(! m_ir.empty())
+    return m_convolution.nb_partitions();
+
+  const std::size_t n = impulse_response().size();
+  const std::size_t block =
+    gammatone::detail::partitioned_convolution<Scalar>::partition_size(n, m_block_size);
+  return (n + block - 1) / block;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::vector<Scalar>
+gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
+impulse_response() const
+{
+  if(! m_ir.empty())
+    return m_ir;
+
+  return gammatone::detail::ir_cache<Scalar>::attenuate(
+    m_center_frequency, m_bandwidth, m_sample_frequency, -60.0);
 }
 
 
@@ -157,9 +333,59 @@ void
 gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
 compute(const Scalar& input, Scalar& output)
 {
-  m_input.pop_front();
-  m_input.push_back(input);
-  output = std::inner_product(m_input.begin(), m_input.end(), m_ir.rbegin(), 0.0);
+  compute_block(&input, &output, 1);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void
+gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
+compute_block(const Scalar* input, Scalar* output, const std::size_t& size)
+{
+  prepare();
+  run(input, size, [&](const std::size_t& i, const Scalar* current)
+      {
+        output[i] = m_convolution.compute(current);
+      });
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void
+gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
+compute_block_complex(const Scalar* input, std::complex<Scalar>* output, const std::size_t& size)
+{
+  prepare();
+  if(! m_convolution.analytic())
+    m_convolution.set_quadrature(
+      gammatone::detail::impulse_response::theorical_quadrature(
+        m_center_frequency, m_bandwidth, m_sample_frequency, m_ir.size()));
+
+  run(input, size, [&](const std::size_t& i, const Scalar* current)
+      {
+        output[i] = m_convolution.compute_complex(current);
+      });
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+template<class Output>
+void
+gammatone::core::convolution<Scalar, GainPolicy, ClippingPolicy>::
+run(const Scalar* input, const std::size_t& size, const Output& output)
+{
+  // the history is [previous block, current block], so that the
+  // windows read by the convolution are contiguous
+  const std::size_t block = m_convolution.block_size();
+  for(std::size_t i = 0; i < size; ++i)
+    {
+      Scalar* current = m_history.data() + block + m_convolution.position();
+      *current = input[i];
+      output(i, current);
+
+      if(m_convolution.position() == 0)
+        std::copy(m_history.begin() + block, m_history.end(), m_history.begin());
+    }
 }
 
 #endif // GAMMATONE_CORE_CONVOLUTION_HPP
@@ -0,0 +1,460 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_CORE_CONVOLUTION_BANK_HPP
+#define GAMMATONE_CORE_CONVOLUTION_BANK_HPP
+
+#include <gammatone/core/convolution.hpp>
+#include <gammatone/detail/impulse_response.hpp>
+#include <gammatone/detail/ir_cache.hpp>
+#include <gammatone/detail/partitioned_convolution.hpp>
+#include <gammatone/policy/gain.hpp>
+#include <gammatone/policy/clipping.hpp>
+#include <gammatone/layout.hpp>
+#include <algorithm>
+#include <complex>
+#include <vector>
+
+namespace gammatone
+{
+  namespace core
+  {
+    //! Multi-channel implementation of core::convolution
+    /*!
+      \class convolution_bank
+
+      All the channels convolve the same input, so its history is
+      stored once for the whole bank, in a mirrored ring: each sample
+      is written twice, C samples apart, so that the window of the
+      C last samples is always contiguous. Each channel then reads
+      its window from the ring (see detail::partitioned_convolution).
+      The ring holds as many samples as the longest window, whatever
+      the number of channels.
+
+      The spectrum of an input window only depends on the input:
+      the channels convolved by FFT with the same block size share
+      one forward transform per block, each channel then multiplying
+      it by its own frequency response and computing its own inverse
+      transform. For large banks this divides the number of forward
+      transforms by the number of channels.
+
+      compute_strided() computes a slice of channels without updating
+      the shared history, so that concurrent calls on disjoint slices
+      are safe. Once all the channels are computed, advance() appends
+      the input to the history. The results are the ones of
+      core::convolution on each channel.
+
+      \tparam Scalar         Type of scalar values
+      \tparam GainPolicy     Unused, as in core::convolution .
+      \tparam ClippingPolicy Unused, as in core::convolution .
+    */
+    template
+    <
+      class Scalar,
+      class GainPolicy = policy::gain::forall_0dB,
+      class ClippingPolicy = policy::clipping::off
+      >
+    class convolution_bank
+    {
+    public:
+      //! Type of the scalars
+      using scalar_type = Scalar;
+
+      //! Type of the equivalent single channel core
+      using core_type = convolution<Scalar,GainPolicy,ClippingPolicy>;
+
+      //! Creates a bank of cores from explicit parameters
+      /*!
+        \param sample_frequency   The sample frequency (Hz).
+        \param center_frequencies The center frequency of each channel (Hz).
+        \param bandwidths         The bandwidth of each channel (Hz).
+        \param block_size         Partitions length, see core::convolution.
+
+        \attention center_frequencies and bandwidths must have the same size.
+      */
+      convolution_bank(const Scalar& sample_frequency,
+                       const std::vector<Scalar>& center_frequencies,
+                       const std::vector<Scalar>& bandwidths,
+                       const std::size_t& block_size = core_type::default_block_size);
+
+      //! The number of channels in the bank
+      inline std::size_t nb_channels() const;
+
+      //! Number of input samples stored in the shared history
+      inline std::size_t history_size() const;
+
+      //! Set all the channels at their initial state
+      inline void reset();
+
+      //! Compute one output per channel from a scalar input
+      inline void compute(const Scalar& input, Scalar* output);
+
+      //! Compute interleaved outputs from pointers, see cooke1993_bank::compute_ptr()
+      inline void compute_ptr(const std::size_t& size,
+                              const Scalar* input,
+                              Scalar* output);
+
+      //! Compute a slice of channels with explicit output strides
+      /*!
+        The output of channel j at sample i is stored in
+        output[i*sample_stride + j*channel_stride]. The shared history
+        is not updated, see advance().
+      */
+      inline void compute_strided(const std::size_t& size,
+                                  const Scalar* input,
+                                  Scalar* output,
+                                  const std::size_t& sample_stride,
+                                  const std::size_t& channel_stride,
+                                  const std::size_t& first,
+                                  const std::size_t& last);
+
+      //! Compute the analytic outputs of all channels
+      /*!
+        See convolution::compute_block_complex(). The output of
+        channel j at sample i is stored in output[i*nb_channels()+j],
+        and the shared history is updated. The quadrature channels
+        share the forward transforms of the input with the others.
+      */
+      inline void compute_ptr_complex(const std::size_t& size,
+                                      const Scalar* input,
+                                      std::complex<Scalar>* output);
+
+      //! Append *size* input samples to the shared history
+      /*!
+        To be called once all the channels have computed that input
+        with compute_strided().
+      */
+      inline void advance(const std::size_t& size, const Scalar* input);
+
+      //! Granularity of channel slices, see compute_strided()
+      static constexpr std::size_t alignment(){
+        return 1;
+      }
+
+    private:
+      //! Append a sample to the shared history
+      inline void push(const Scalar& input);
+
+      //! Pointer on the last sample of the shared history
+      inline const Scalar* last() const;
+
+      //! Run the channels in [first, last), calling output(j, i, current, spectrum)
+      /*!
+        output() computes the channel j at the sample i of the input,
+        from the arguments of partitioned_convolution::compute().
+        A run on all the channels cannot be concurrent with another
+        one, it reuses the scratch of the bank instead of allocating
+        it, so that compute_ptr() does not allocate once warm.
+      */
+      template<class Output>
+      inline void run(const std::size_t& size,
+                      const Scalar* input,
+                      const std::size_t& first,
+                      const std::size_t& last,
+                      const Output& output);
+
+      //! Channels convolved by FFT with the same block size
+      struct group
+      {
+        //! The block size of the channels
+        std::size_t block;
+
+        //! The channels, in increasing order
+        std::vector<std::size_t> channels;
+
+        //! Spectrum of the last window, for compute()
+        std::vector<Scalar> spectrum;
+      };
+
+      //! Number of samples computed by compute_strided() between transforms
+      static constexpr std::size_t segment_size = 4096;
+
+      //! The convolution of each channel
+      std::vector<detail::partitioned_convolution<Scalar> > m_channels;
+
+      //! Parameters of the channels, for the quadrature impulse responses
+      Scalar m_sample_frequency;
+      std::vector<Scalar> m_center_frequencies, m_bandwidths;
+
+      //! The groups of channels sharing their input spectra
+      std::vector<group> m_groups;
+
+      //! Group of each channel, m_groups.size() for direct ones
+      std::vector<std::size_t> m_group_of;
+
+      //! Longest window read by a channel
+      std::size_t m_window;
+
+      //! Capacity C of the history, a power of 2
+      std::size_t m_capacity;
+
+      //! The mirrored history (2C samples)
+      std::vector<Scalar> m_history;
+
+      //! Position of the next sample in the history
+      std::size_t m_next;
+
+      //! Scratch of run() on all the channels, see run()
+      std::vector<Scalar> m_buffer, m_spectra;
+      std::vector<std::size_t> m_offsets;
+    };
+  }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+constexpr std::size_t gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::segment_size;
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+convolution_bank(const Scalar& sample_frequency,
+                 const std::vector<Scalar>& center_frequencies,
+                 const std::vector<Scalar>& bandwidths,
+                 const std::size_t& block_size)
+  : m_sample_frequency(sample_frequency),
+    m_center_frequencies(center_frequencies),
+    m_bandwidths(bandwidths),
+    m_window(1)
+{
+  // impulse responses are the ones of the single channel core
+  m_channels.reserve(center_frequencies.size());
+  for(std::size_t j = 0; j < center_frequencies.size(); ++j)
+    {
+      m_channels.emplace_back(
+        detail::ir_cache<Scalar>::attenuate(
+          center_frequencies[j], bandwidths[j], sample_frequency, -60.0),
+        block_size);
+      m_window = std::max(m_window, m_channels.back().window_size());
+
+      const auto& c = m_channels.back();
+      if(c.nb_partitions() > 1)
+        {
+          std::size_t g = 0;
+          while(g < m_groups.size() && m_groups[g].block != c.block_size()) ++g;
+          if(g == m_groups.size())
+            m_groups.push_back(group{c.block_size(), {}, std::vector<Scalar>(c.spectrum_size())});
+          m_groups[g].channels.push_back(j);
+        }
+    }
+
+  m_group_of.assign(m_channels.size(), m_groups.size());
+  for(std::size_t g = 0; g < m_groups.size(); ++g)
+    for(const auto& j : m_groups[g].channels)
+      m_group_of[j] = g;
+
+  m_capacity = 1;
+  while(m_capacity < m_window) m_capacity *= 2;
+
+  reset();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+nb_channels() const
+{
+  return m_channels.size();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+history_size() const
+{
+  return m_capacity;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+reset()
+{
+  for(auto& c : m_channels) c.reset();
+  m_history.assign(2*m_capacity, 0.0);
+  m_next = 0;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+push(const Scalar& input)
+{
+  m_history[m_next] = input;
+  m_history[m_next + m_capacity] = input;
+  m_next = (m_next + 1) & (m_capacity - 1);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+const Scalar* gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+last() const
+{
+  // the copy in the upper half has C-1 samples before it
+  return m_history.data() + ((m_next + m_capacity - 1) & (m_capacity - 1)) + m_capacity;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute(const Scalar& input, Scalar* output)
+{
+  push(input);
+  const Scalar* current = last();
+
+  // a single transform per group at the end of a block
+  for(auto& g : m_groups)
+    {
+      auto& c = m_channels[g.channels.front()];
+      if(c.position() == g.block - 1)
+        c.transform(current + 1 - 2*g.block, g.spectrum.data());
+    }
+
+  for(std::size_t j = 0; j < nb_channels(); ++j)
+    {
+      const std::size_t g = m_group_of[j];
+      output[j] = m_channels[j].compute(
+        current, g < m_groups.size() ? m_groups[g].spectrum.data() : nullptr);
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_ptr(const std::size_t& size, const Scalar* input, Scalar* output)
+{
+  compute_strided(size, input, output, nb_channels(), 1, 0, nb_channels());
+  advance(size, input);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_strided(const std::size_t& size, const Scalar* input, Scalar* output,
+                const std::size_t& sample_stride, const std::size_t& channel_stride,
+                const std::size_t& first, const std::size_t& last)
+{
+  run(size, input, first, last,
+      [&](const std::size_t& j, const std::size_t& i, const Scalar* current, const Scalar* spectrum)
+      {
+        output[i*sample_stride + j*channel_stride] = m_channels[j].compute(current, spectrum);
+      });
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_ptr_complex(const std::size_t& size, const Scalar* input, std::complex<Scalar>* output)
+{
+  for(std::size_t j = 0; j < nb_channels(); ++j)
+    if(! m_channels[j].analytic())
+      m_channels[j].set_quadrature(
+        detail::impulse_response::theorical_quadrature(
+          m_center_frequencies[j], m_bandwidths[j], m_sample_frequency, m_channels[j].size()));
+
+  const std::size_t channels = nb_channels();
+  run(size, input, 0, channels,
+      [&](const std::size_t& j, const std::size_t& i, const Scalar* current, const Scalar* spectrum)
+      {
+        output[i*channels + j] = m_channels[j].compute_complex(current, spectrum);
+      });
+  advance(size, input);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+template<class Output>
+void gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+run(const std::size_t& size, const Scalar* input,
+    const std::size_t& first, const std::size_t& last, const Output& output)
+{
+  if(size == 0 || first == last)
+    return;
+
+  // concurrent slices have their own scratch
+  std::vector<Scalar> slice_buffer, slice_spectra;
+  std::vector<std::size_t> slice_offsets;
+  const bool whole = first == 0 && last == nb_channels();
+  std::vector<Scalar>& buffer = whole ? m_buffer : slice_buffer;
+  std::vector<Scalar>& spectra = whole ? m_spectra : slice_spectra;
+  std::vector<std::size_t>& offsets = whole ? m_offsets : slice_offsets;
+
+  // the end of the history followed by the input, so that the
+  // windows of all the samples are contiguous
+  const std::size_t past = m_window - 1;
+  buffer.resize(past + size);
+  std::copy(this->last() + 1 - past, this->last() + 1, buffer.begin());
+  std::copy(input, input + size, buffer.begin() + past);
+
+  // spectra of the windows ending a block in a segment, for each
+  // group having channels in the slice
+  offsets.assign(m_groups.size() + 1, 0);
+
+  for(std::size_t s = 0; s < size; s += segment_size)
+    {
+      const std::size_t length = std::min(segment_size, size - s);
+
+      spectra.clear();
+      for(std::size_t g = 0; g < m_groups.size(); ++g)
+        {
+          const auto& channels = m_groups[g].channels;
+          const auto j = std::lower_bound(channels.begin(), channels.end(), first);
+          offsets[g] = spectra.size();
+          if(j == channels.end() || *j >= last) continue;
+
+          // the channels of a group are at the same position
+          auto& c = m_channels[*j];
+          const std::size_t block = m_groups[g].block, n = c.spectrum_size();
+          const std::size_t ends = (c.position() + length) / block;
+          spectra.resize(spectra.size() + ends*n);
+          for(std::size_t e = 0; e < ends; ++e)
+            {
+              const std::size_t i = s + (e + 1)*block - c.position() - 1;
+              c.transform(buffer.data() + past + i + 1 - 2*block,
+                          spectra.data() + offsets[g] + e*n);
+            }
+        }
+
+      for(std::size_t j = first; j < last; ++j)
+        {
+          auto& c = m_channels[j];
+          const std::size_t g = m_group_of[j], n = c.spectrum_size();
+          const Scalar* spectrum = g < m_groups.size() ? spectra.data() + offsets[g] : nullptr;
+
+          for(std::size_t i = 0; i < length; ++i)
+            {
+              output(j, s + i, buffer.data() + past + s + i, spectrum);
+              if(spectrum && c.position() == 0) spectrum += n;
+            }
+        }
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::convolution_bank<Scalar,GainPolicy,ClippingPolicy>::
+advance(const std::size_t& size, const Scalar* input)
+{
+  // older samples would be overwritten
+  const std::size_t first = size > m_capacity ? size - m_capacity : 0;
+  for(std::size_t i = first; i < size; ++i)
+    push(input[i]);
+}
+
+#endif // GAMMATONE_CORE_CONVOLUTION_BANK_HPP
@@ -0,0 +1,853 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_CORE_COOKE1993_BANK_HPP
+#define GAMMATONE_CORE_COOKE1993_BANK_HPP
+
+#include <gammatone/core/cooke1993.hpp>
+#include <gammatone/core/cooke1993_coefficients.hpp>
+#include <gammatone/policy/gain.hpp>
+#include <gammatone/policy/clipping.hpp>
+#include <gammatone/detail/simd.hpp>
+#include <gammatone/detail/cooke1993_simd.hpp>
+#include <gammatone/detail/decimator.hpp>
+#include <gammatone/detail/phasor.hpp>
+#include <gammatone/detail/state_space.hpp>
+#include <gammatone/layout.hpp>
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <type_traits>
+#include <vector>
+
+namespace gammatone
+{
+  namespace core
+  {
+    //! Multi-channel implementation of core::cooke1993
+    /*!
+      \class cooke1993_bank
+
+      This class computes a whole bank of core::cooke1993 channels at
+      once. Instead of storing an array of cores, each field of the
+      core (coefficients \f$ r \f$, \f$ c \f$ and factor, shared
+      in a core::cooke1993_coefficients, states \f$ q \f$ and
+      \f$ v_1 \f$ to \f$ v_4 \f$) is stored in a contiguous array
+      indexed by channel, with real and imaginary parts split in
+      separate arrays.
+
+      The per-sample update is then a single loop across channels
+      without any indirection, which the compiler is able to
+      vectorize. Each channel computes exactly the same operations as
+      core::cooke1993::compute().
+
+      compute_ptr() additionally uses explicit SIMD kernels processing
+      2, 4 or 8 double channels (4, 8 or 16 float channels) at once
+      with SSE2, AVX2 or AVX-512. The widest kernel supported by the
+      CPU is selected at construction and can be forced by
+      set_kernel(). Kernels are bypassed when clipping is enabled.
+
+      Inputs are computed by segments ending at the resynchronizations
+      of the phasors (see detail::phasor), as in core::cooke1993.
+
+      \tparam Scalar         Type of scalar values
+      \tparam GainPolicy     Policy for gain computation, see policy::gain .
+      \tparam ClippingPolicy Policy for clipping small values, see policy::clipping .
+    */
+    template
+    <
+      class Scalar,
+      class GainPolicy = policy::gain::forall_0dB,
+      class ClippingPolicy = policy::clipping::off
+      >
+    class cooke1993_bank
+    {
+      using this_type = cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>;
+
+      //! Type of the per-channel arrays, aligned for SIMD kernels
+      using array_type = std::vector<Scalar, detail::simd::aligned_allocator<Scalar> >;
+
+    public:
+      //! Type of the scalars
+      using scalar_type = Scalar;
+
+      //! Type of the equivalent single channel core
+      using core_type = cooke1993<Scalar,GainPolicy,ClippingPolicy>;
+
+      //! Type of the instruction sets for which kernels are available
+      using kernel_type = detail::simd::isa;
+
+      //! Creates a bank of cores from explicit parameters
+      /*!
+        \param sample_frequency   The sample frequency (Hz).
+        \param center_frequencies The center frequency of each channel (Hz).
+        \param bandwidths         The bandwidth of each channel (Hz).
+
+        \attention center_frequencies and bandwidths must have the same size.
+      */
+      cooke1993_bank(const Scalar& sample_frequency,
+                     const std::vector<Scalar>& center_frequencies,
+                     const std::vector<Scalar>& bandwidths);
+
+      cooke1993_bank(const this_type& other);
+      cooke1993_bank(this_type&& other) noexcept;
+
+      this_type& operator=(const this_type& other);
+      this_type& operator=(this_type&& other);
+
+      virtual ~cooke1993_bank();
+
+      //! The number of channels in the bank
+      inline std::size_t nb_channels() const;
+
+      //! Set all the channels at their initial state
+      inline void reset();
+
+      //! The kernel used by compute_ptr()
+      inline kernel_type kernel() const;
+
+      //! Force the kernel used by compute_ptr()
+      /*!
+        \param kernel  The instruction set to be used.
+
+        \return false if the kernel is not supported by the CPU, or
+        not available for this bank, in which case the current kernel
+        is kept. kernel_type::scalar is always available.
+      */
+      inline bool set_kernel(const kernel_type& kernel);
+
+      //! The widest kernel available for this bank on the running CPU
+      static inline kernel_type default_kernel();
+
+      //! Compute one output per channel from a scalar input
+      /*!
+        \param input   The scalar value to be processed
+        \param output  The computed values, one per channel. Must
+        point to at least nb_channels() allocated scalars.
+      */
+      inline void compute(const Scalar& input, Scalar* output);
+
+      //! Compute scalar values from/to pointers
+      /*!
+        \param size    Number of input samples.
+        \param input   Pointer to the input range of *size* scalars.
+        \param output  Pointer to the output range of *size x
+        nb_channels()* scalars. The output of channel j at sample i
+        is stored in output[i*nb_channels()+j].
+      */
+      inline void compute_ptr(const std::size_t& size,
+                              const Scalar* input,
+                              Scalar* output);
+
+      //! Compute a slice of channels from/to pointers
+      /*!
+        Only the channels in [first, last) are computed and their
+        state updated. Concurrent calls on disjoint slices are safe as
+        long as slice boundaries are multiples of alignment(), states
+        of different slices being then on different cache lines.
+
+        \param size    Number of input samples.
+        \param input   Pointer to the input range of *size* scalars.
+        \param output  Pointer to the output range of *size x
+        nb_channels()* scalars, with the given layout.
+        \param l       The layout of output.
+        \param first   First channel to compute.
+        \param last    Past the last channel to compute.
+      */
+      inline void compute_ptr(const std::size_t& size,
+                              const Scalar* input,
+                              Scalar* output,
+                              const layout& l,
+                              const std::size_t& first,
+                              const std::size_t& last);
+
+      //! Compute a slice of channels with explicit output strides
+      /*!
+        As compute_ptr(), the output of channel j at sample i being
+        stored in output[i*sample_stride + j*channel_stride].
+      */
+      inline void compute_strided(const std::size_t& size,
+                                  const Scalar* input,
+                                  Scalar* output,
+                                  const std::size_t& sample_stride,
+                                  const std::size_t& channel_stride,
+                                  const std::size_t& first,
+                                  const std::size_t& last);
+
+      //! Compute the analytic outputs of all channels
+      /*!
+        See cooke1993::compute_block_complex(). The real parts are the
+        outputs of compute_ptr(), results are identical to those of
+        the single channel cores.
+
+        \param size    Number of input samples.
+        \param input   Pointer to the input range of *size* scalars.
+        \param output  Pointer to the output range of *size x
+        nb_channels()* values. The output of channel j at sample i
+        is stored in output[i*nb_channels()+j].
+      */
+      inline void compute_ptr_complex(const std::size_t& size,
+                                      const Scalar* input,
+                                      std::complex<Scalar>* output);
+
+      //! Compute the decimated base-band output of all channels
+      /*!
+        See cooke1993::compute_baseband(). The base-band outputs are
+        computed by blocks with the kernel of compute_ptr() before
+        being decimated, results are identical to those of the single
+        channel cores.
+
+        \param size    Number of input samples.
+        \param input   Pointer to the input range of *size* scalars.
+        \param output  Pointer to the output frames, at least *(size /
+        decimation() + 1) x nb_channels()*. Frame m of channel j is
+        stored in output[m*nb_channels()+j].
+        \return The number of frames written for each channel.
+      */
+      inline std::size_t compute_baseband(const std::size_t& size,
+                                          const Scalar* input,
+                                          std::complex<Scalar>* output);
+
+      //! As compute_baseband(), for the envelopes, see cooke1993::compute_envelope()
+      inline std::size_t compute_envelope(const std::size_t& size,
+                                          const Scalar* input,
+                                          Scalar* output);
+
+      //! Set the decimation factor of compute_baseband() and compute_envelope()
+      inline void set_decimation(const std::size_t& factor);
+
+      //! The decimation factor of compute_baseband() and compute_envelope()
+      inline std::size_t decimation() const;
+
+      //! The recursion state of all channels
+      /*!
+        Real parts of the state of the section 4 of the cascade for
+        all channels, then its imaginary parts, and so on down to the
+        section 1, see cooke1993::state().
+      */
+      inline std::vector<Scalar> state() const;
+
+      //! Set the recursion state of all channels, see state()
+      inline void set_state(const std::vector<Scalar>& state);
+
+      //! Advance the phasors by n samples, leaving the state unchanged
+      inline void seek(const std::size_t& n);
+
+      //! Type of the state transitions over several samples
+      /*!
+        The transition matrix of each channel, see
+        cooke1993::transition().
+      */
+      using transition_type = std::vector<detail::square_matrix<Scalar> >;
+
+      //! The state transitions over n samples of null input, see cooke1993::transition()
+      inline transition_type transition(const std::size_t& n) const;
+
+      //! Apply transitions to a state, see transition()
+      inline void propagate(const transition_type& t, std::vector<Scalar>& state) const;
+
+      //! Granularity of channel slices, see compute_ptr()
+      static constexpr std::size_t alignment(){
+        return detail::simd::max_lanes<Scalar>();
+      }
+
+    private:
+
+      //! Rotate the phasor of channel j by one sample
+      inline void rotate(const std::size_t& j, std::complex<Scalar>& q) const;
+
+      //! Kernel or scalar implementation of compute_strided(), between resynchronizations
+      inline void compute_segment(const std::size_t& size,
+                                  const Scalar* input,
+                                  Scalar* output,
+                                  const std::size_t& sample_stride,
+                                  const std::size_t& channel_stride,
+                                  const std::size_t& first,
+                                  const std::size_t& last);
+
+      //! Compute the base-band or analytic outputs of all channels, calling row(i, re, im)
+      /*!
+        row() is called at each sample i with the real and imaginary
+        parts of the outputs of all channels, that it may overwrite.
+        Outputs are the base-band ones u, or the analytic ones of
+        compute_ptr_complex() if *analytic* is true.
+      */
+      template<class Row>
+      inline void run_rows(const std::size_t& size,
+                           const Scalar* input,
+                           const bool& analytic,
+                           const Row& row);
+
+      //! Scalar implementation of compute_ptr()
+      inline void compute_scalar(const std::size_t& size,
+                                 const Scalar* input,
+                                 Scalar* output,
+                                 const std::size_t& sample_stride,
+                                 const std::size_t& channel_stride,
+                                 const std::size_t& first,
+                                 const std::size_t& last);
+
+      //! Run the recursion of channels [first, last)
+      /*!
+        output(i, j, ure, uim, qre, qim) is called for each sample i
+        and channel j with the base-band output u and the phasor q.
+      */
+      template<class Output>
+      inline void run_scalar(const std::size_t& size,
+                             const Scalar* input,
+                             const std::size_t& first,
+                             const std::size_t& last,
+                             const Output& output);
+
+      //! Raw view on the arrays for the SIMD kernels
+      inline detail::cooke1993_arrays<Scalar> arrays();
+
+      //! Number of channels, arrays below are padded beyond it
+      std::size_t m_channels;
+
+      //! Kernel used in compute_ptr()
+      kernel_type m_kernel;
+
+      //! Filter coefficients
+      cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy> m_coefficients;
+
+      // Filter states
+
+      //! Real and imaginary parts of the phasor \f$ q \f$
+      array_type m_qre, m_qim;
+
+      //! Resynchronization of the phasors
+      std::vector<detail::phasor<Scalar> > m_phasors;
+
+      //! Decimation of the base-band outputs and of the envelopes
+      detail::decimator_bank<Scalar> m_baseband_re, m_baseband_im, m_envelope;
+
+      //! Number of samples of the blocks of run_rows()
+      static constexpr std::size_t baseband_block = 64;
+
+      //! Outputs of a block of run_rows(), channel j at sample i in [i*stride + j]
+      array_type m_ure, m_uim;
+
+      //! Real and imaginary parts of the states of the sections 4 to 1
+      std::array<array_type,4> m_vre, m_vim;
+    };
+  }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+constexpr std::size_t gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::baseband_block;
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+cooke1993_bank(const Scalar& sample_frequency,
+               const std::vector<Scalar>& center_frequencies,
+               const std::vector<Scalar>& bandwidths)
+  : m_channels(center_frequencies.size()),
+    m_kernel(default_kernel()),
+    m_coefficients(sample_frequency, center_frequencies, bandwidths),
+    m_phasors(m_coefficients.phasors())
+{
+  const std::size_t size = m_coefficients.padded_size();
+
+  m_qre.resize(size);
+  m_qim.resize(size);
+  set_decimation(1);
+  m_ure.resize(baseband_block*size);
+  m_uim.resize(baseband_block*size);
+  for(auto& v : m_vre) v.resize(size);
+  for(auto& v : m_vim) v.resize(size);
+
+  reset();
+}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+cooke1993_bank(const cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>& other)
+  : m_channels(other.m_channels),
+    m_kernel(other.m_kernel),
+    m_coefficients(other.m_coefficients),
+    m_qre(other.m_qre),
+    m_qim(other.m_qim),
+    m_phasors(other.m_phasors),
+    m_baseband_re(other.m_baseband_re),
+    m_baseband_im(other.m_baseband_im),
+    m_envelope(other.m_envelope),
+    m_ure(other.m_ure),
+    m_uim(other.m_uim),
+    m_vre(other.m_vre),
+    m_vim(other.m_vim)
+{}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+cooke1993_bank(cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>&& other) noexcept
+  : m_channels(other.m_channels),
+    m_kernel(other.m_kernel),
+    m_coefficients(std::move(other.m_coefficients)),
+    m_qre(std::move(other.m_qre)),
+    m_qim(std::move(other.m_qim)),
+    m_phasors(std::move(other.m_phasors)),
+    m_baseband_re(std::move(other.m_baseband_re)),
+    m_baseband_im(std::move(other.m_baseband_im)),
+    m_envelope(std::move(other.m_envelope)),
+    m_ure(std::move(other.m_ure)),
+    m_uim(std::move(other.m_uim)),
+    m_vre(std::move(other.m_vre)),
+    m_vim(std::move(other.m_vim))
+{}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>&
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+operator=(const cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>& other)
+{
+  cooke1993_bank<Scalar,GainPolicy,ClippingPolicy> tmp(other);
+  std::swap(m_channels, tmp.m_channels);
+  std::swap(m_kernel, tmp.m_kernel);
+  std::swap(m_coefficients, tmp.m_coefficients);
+  std::swap(m_qre, tmp.m_qre);
+  std::swap(m_qim, tmp.m_qim);
+  std::swap(m_phasors, tmp.m_phasors);
+  std::swap(m_baseband_re, tmp.m_baseband_re);
+  std::swap(m_baseband_im, tmp.m_baseband_im);
+  std::swap(m_envelope, tmp.m_envelope);
+  std::swap(m_ure, tmp.m_ure);
+  std::swap(m_uim, tmp.m_uim);
+  std::swap(m_vre, tmp.m_vre);
+  std::swap(m_vim, tmp.m_vim);
+
+  return *this;
+}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>&
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+operator=(cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>&& other)
+{
+  m_channels = other.m_channels;
+  m_kernel = other.m_kernel;
+  m_coefficients = std::move(other.m_coefficients);
+  m_qre = std::move(other.m_qre);
+  m_qim = std::move(other.m_qim);
+  m_phasors = std::move(other.m_phasors);
+  m_baseband_re = std::move(other.m_baseband_re);
+  m_baseband_im = std::move(other.m_baseband_im);
+  m_envelope = std::move(other.m_envelope);
+  m_ure = std::move(other.m_ure);
+  m_uim = std::move(other.m_uim);
+  m_vre = std::move(other.m_vre);
+  m_vim = std::move(other.m_vim);
+
+  return *this;
+}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+~cooke1993_bank()
+{}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+nb_channels() const
+{
+  return m_channels;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+reset()
+{
+  for(auto& v : m_vre) std::fill(v.begin(), v.end(), 0.0);
+  for(auto& v : m_vim) std::fill(v.begin(), v.end(), 0.0);
+  std::fill(m_qre.begin(), m_qre.end(), 1.0);
+  std::fill(m_qim.begin(), m_qim.end(), 0.0);
+  for(auto& p : m_phasors) p.reset();
+  m_baseband_re.reset();
+  m_baseband_im.reset();
+  m_envelope.reset();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::kernel_type
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+kernel() const
+{
+  return m_kernel;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+bool gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+set_kernel(const kernel_type& kernel)
+{
+  if(kernel != kernel_type::scalar)
+    {
+      if(default_kernel() == kernel_type::scalar || !detail::simd::supported(kernel))
+        return false;
+    }
+
+  m_kernel = kernel;
+  return true;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::kernel_type
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+default_kernel()
+{
+  // kernels do not implement clipping
+  if(std::is_same<ClippingPolicy,policy::clipping::on>::value ||
+     !detail::simd::is_vectorizable<Scalar>::value)
+    return kernel_type::scalar;
+
+  return detail::simd::best();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::detail::cooke1993_arrays<Scalar>
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+arrays()
+{
+  detail::cooke1993_arrays<Scalar> s;
+  m_coefficients.view(s);
+  s.qre = m_qre.data(); s.qim = m_qim.data();
+  s.v4re = m_vre[0].data(); s.v4im = m_vim[0].data();
+  s.v3re = m_vre[1].data(); s.v3im = m_vim[1].data();
+  s.v2re = m_vre[2].data(); s.v2im = m_vim[2].data();
+  s.v1re = m_vre[3].data(); s.v1im = m_vim[3].data();
+  return s;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute(const Scalar& input, Scalar* output)
+{
+  if(nb_channels() == 0)
+    return;
+
+  compute_scalar(1, &input, output, 0, 1, 0, nb_channels());
+  for(std::size_t j = 0; j < nb_channels(); ++j)
+    m_phasors[j].advance(1, m_qre[j], m_qim[j]);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_ptr(const std::size_t& size, const Scalar* input, Scalar* output)
+{
+  compute_ptr(size, input, output, layout::interleaved, 0, nb_channels());
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_ptr(const std::size_t& size, const Scalar* input, Scalar* output,
+            const layout& l, const std::size_t& first, const std::size_t& last)
+{
+  compute_strided(size, input, output,
+                  detail::sample_stride(l, size, nb_channels()),
+                  detail::channel_stride(l, size, nb_channels()),
+                  first, last);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_strided(const std::size_t& size, const Scalar* input, Scalar* output,
+                const std::size_t& sample_stride, const std::size_t& channel_stride,
+                const std::size_t& first, const std::size_t& last)
+{
+  if(first >= last)
+    return;
+
+  // the channels of the slice are resynchronized together
+  for(std::size_t done = 0; done < size; )
+    {
+      const std::size_t n = std::min(size - done, m_phasors[first].remaining());
+      compute_segment(n, input + done, output + done*sample_stride,
+                      sample_stride, channel_stride, first, last);
+      for(std::size_t j = first; j < last; ++j)
+        m_phasors[j].advance(n, m_qre[j], m_qim[j]);
+      done += n;
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_ptr_complex(const std::size_t& size, const Scalar* input, std::complex<Scalar>* output)
+{
+  const std::size_t channels = nb_channels();
+  run_rows(size, input, true, [&](const std::size_t& i, Scalar* re, Scalar* im)
+           {
+             std::complex<Scalar>* y = output + i*channels;
+             for(std::size_t j = 0; j < channels; ++j)
+               y[j] = std::complex<Scalar>(re[j], im[j]);
+           });
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_baseband(const std::size_t& size, const Scalar* input, std::complex<Scalar>* output)
+{
+  const std::size_t channels = nb_channels();
+  const Scalar* factor = m_coefficients.factor().data();
+  std::size_t frames = 0;
+  run_rows(size, input, false, [&](const std::size_t&, Scalar* ure, Scalar* uim)
+           {
+             // frames are written over the samples
+             m_baseband_re.push(ure, ure);
+             if(! m_baseband_im.push(uim, uim))
+               return;
+
+             std::complex<Scalar>* y = output + frames*channels;
+             for(std::size_t j = 0; j < channels; ++j)
+               y[j] = std::complex<Scalar>(ure[j]*factor[j], uim[j]*factor[j]);
+             ++frames;
+           });
+  return frames;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_envelope(const std::size_t& size, const Scalar* input, Scalar* output)
+{
+  const std::size_t channels = nb_channels();
+  const Scalar* factor = m_coefficients.factor().data();
+  std::size_t frames = 0;
+  run_rows(size, input, false, [&](const std::size_t&, Scalar* ure, Scalar* uim)
+           {
+             for(std::size_t j = 0; j < channels; ++j)
+               ure[j] = std::sqrt(ure[j]*ure[j] + uim[j]*uim[j]);
+
+             if(! m_envelope.push(ure, ure))
+               return;
+
+             Scalar* y = output + frames*channels;
+             for(std::size_t j = 0; j < channels; ++j)
+               y[j] = ure[j]*factor[j];
+             ++frames;
+           });
+  return frames;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+set_decimation(const std::size_t& factor)
+{
+  m_baseband_re = detail::decimator_bank<Scalar>(m_channels, factor);
+  m_baseband_im = detail::decimator_bank<Scalar>(m_channels, factor);
+  m_envelope = detail::decimator_bank<Scalar>(m_channels, factor);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+decimation() const
+{
+  return m_envelope.factor();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+template<class Row>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+run_rows(const std::size_t& size, const Scalar* input, const bool& analytic, const Row& row)
+{
+  const std::size_t channels = nb_channels();
+  const std::size_t stride = detail::simd::padded_size<Scalar>(channels);
+  const Scalar* factor = m_coefficients.factor().data();
+  if(channels == 0)
+    return;
+
+  // outputs are computed by blocks ending at the phasors
+  // resynchronizations, then passed sample by sample
+  for(std::size_t done = 0; done < size; )
+    {
+      const std::size_t n = std::min(std::min(size - done, m_phasors[0].remaining()), baseband_block);
+
+      if(m_kernel == kernel_type::scalar ||
+         ! detail::cooke1993_baseband_dispatch(m_kernel, arrays(), n, input + done,
+                                               m_ure.data(), m_uim.data(), stride,
+                                               0, channels, analytic))
+        run_scalar(n, input + done, 0, channels,
+                   [&](const std::size_t& i, const std::size_t& j,
+                       const Scalar& ure, const Scalar& uim, const Scalar& qre, const Scalar& qim)
+                   {
+                     // as in the kernels
+                     if(analytic)
+                       {
+                         m_ure[i*stride + j] = factor[j] * (ure*qre + uim*qim);
+                         m_uim[i*stride + j] = factor[j] * (uim*qre - ure*qim);
+                       }
+                     else
+                       {
+                         m_ure[i*stride + j] = ure;
+                         m_uim[i*stride + j] = uim;
+                       }
+                   });
+
+      for(std::size_t j = 0; j < channels; ++j)
+        m_phasors[j].advance(n, m_qre[j], m_qim[j]);
+
+      for(std::size_t i = 0; i < n; ++i)
+        row(done + i, m_ure.data() + i*stride, m_uim.data() + i*stride);
+
+      done += n;
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_segment(const std::size_t& size, const Scalar* input, Scalar* output,
+                const std::size_t& sample_stride, const std::size_t& channel_stride,
+                const std::size_t& first, const std::size_t& last)
+{
+  if(m_kernel != kernel_type::scalar &&
+     detail::cooke1993_dispatch(m_kernel, arrays(), size, input, output,
+                                sample_stride, channel_stride, first, last))
+    return;
+
+  compute_scalar(size, input, output, sample_stride, channel_stride, first, last);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+rotate(const std::size_t& j, std::complex<Scalar>& q) const
+{
+  // same update as in compute_scalar()
+  const Scalar cre = m_coefficients.cre()[j], cim = m_coefficients.cim()[j];
+  q = std::complex<Scalar>(cre*q.real() + cim*q.imag(),
+                           cre*q.imag() - cim*q.real());
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::vector<Scalar> gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+state() const
+{
+  const std::size_t n = nb_channels();
+  std::vector<Scalar> s(8*n);
+  for(std::size_t k = 0; k < 4; ++k)
+    {
+      std::copy(m_vre[k].begin(), m_vre[k].begin() + n, s.begin() + 2*k*n);
+      std::copy(m_vim[k].begin(), m_vim[k].begin() + n, s.begin() + (2*k+1)*n);
+    }
+  return s;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+set_state(const std::vector<Scalar>& state)
+{
+  const std::size_t n = nb_channels();
+  for(std::size_t k = 0; k < 4; ++k)
+    {
+      std::copy(state.begin() + 2*k*n, state.begin() + (2*k+1)*n, m_vre[k].begin());
+      std::copy(state.begin() + (2*k+1)*n, state.begin() + (2*k+2)*n, m_vim[k].begin());
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+seek(const std::size_t& n)
+{
+  // as in cooke1993::seek
+  for(std::size_t j = 0; j < nb_channels(); ++j)
+    {
+      std::complex<Scalar> q(m_qre[j], m_qim[j]);
+      m_phasors[j].seek(n, q, [&](std::complex<Scalar>& x){rotate(j, x);});
+      m_qre[j] = q.real();
+      m_qim[j] = q.imag();
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::transition_type
+gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+transition(const std::size_t& n) const
+{
+  transition_type t(nb_channels());
+  for(std::size_t j = 0; j < t.size(); ++j)
+    t[j] = detail::repeated_pole::transition<Scalar,4>(m_coefficients.r()[j], n);
+  return t;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+propagate(const transition_type& t, std::vector<Scalar>& state) const
+{
+  const std::size_t channels = nb_channels();
+
+  // state[(2k+part)*channels + j] is the section 4-k of channel j
+  std::vector<Scalar> v(4);
+  for(std::size_t j = 0; j < channels; ++j)
+    for(std::size_t part = 0; part < 2; ++part)
+      {
+        Scalar* s = state.data() + part*channels + j;
+        for(std::size_t k = 0; k < 4; ++k) v[k] = s[2*k*channels];
+        v = t[j] * v;
+        for(std::size_t k = 0; k < 4; ++k) s[2*k*channels] = v[k];
+      }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_scalar(const std::size_t& size, const Scalar* input, Scalar* output,
+               const std::size_t& sample_stride, const std::size_t& channel_stride,
+               const std::size_t& first, const std::size_t& last)
+{
+  const Scalar* factor = m_coefficients.factor().data();
+  run_scalar(size, input, first, last,
+             [&](const std::size_t& i, const std::size_t& j,
+                 const Scalar& ure, const Scalar& uim, const Scalar& qre, const Scalar& qim)
+             {
+               output[i*sample_stride + j*channel_stride] = factor[j] * (ure*qre + uim*qim);
+             });
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+template<class Output>
+void gammatone::core::cooke1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+run_scalar(const std::size_t& size, const Scalar* input,
+           const std::size_t& first, const std::size_t& last, const Output& output)
+{
+  detail::cooke1993_scalar<ClippingPolicy>(arrays(), size, input, first, last, output);
+}
+
+#endif // GAMMATONE_CORE_COOKE1993_BANK_HPP
@@ -0,0 +1,196 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_CORE_COOKE1993_COEFFICIENTS_HPP
+#define GAMMATONE_CORE_COOKE1993_COEFFICIENTS_HPP
+
+#include <gammatone/core/cooke1993.hpp>
+#include <gammatone/detail/simd.hpp>
+#include <gammatone/detail/cooke1993_simd.hpp>
+#include <gammatone/detail/phasor.hpp>
+#include <vector>
+
+namespace gammatone
+{
+  namespace core
+  {
+    //! Structure-of-arrays coefficients of several core::cooke1993 channels
+    /*!
+      \class cooke1993_coefficients
+
+      The coefficients shared by core::cooke1993_bank,
+      core::cooke1993_streams and core::cooke1993_design. They are
+      taken from the single channel core, so that all these
+      implementations stay strictly equivalent to it.
+
+      The arrays are padded to detail::simd::padded_size(nb_channels())
+      scalars, padding channels having null coefficients.
+
+      \tparam Scalar         Type of scalar values
+      \tparam GainPolicy     Policy for gain computation, see policy::gain .
+      \tparam ClippingPolicy Policy for clipping small values, see policy::clipping .
+    */
+    template<class Scalar, class GainPolicy, class ClippingPolicy>
+    class cooke1993_coefficients
+    {
+    public:
+      //! Type of the per-channel arrays, aligned for SIMD kernels
+      using array_type = std::vector<Scalar, detail::simd::aligned_allocator<Scalar> >;
+
+      //! Type of the equivalent single channel core
+      using core_type = cooke1993<Scalar,GainPolicy,ClippingPolicy>;
+
+      //! Computes the coefficients of each channel
+      cooke1993_coefficients(const Scalar& sample_frequency,
+                             const std::vector<Scalar>& center_frequencies,
+                             const std::vector<Scalar>& bandwidths);
+
+      //! The number of channels
+      inline std::size_t nb_channels() const;
+
+      //! The padded size of the arrays
+      inline std::size_t padded_size() const;
+
+      //! Inverse of the gain of each channel
+      inline const array_type& factor() const;
+
+      //! Real part of \f$ c = e^{2i\pi f_c/f_s} \f$
+      inline const array_type& cre() const;
+
+      //! Imaginary part of \f$ c = e^{2i\pi f_c/f_s} \f$
+      inline const array_type& cim() const;
+
+      //! Fourfold pole \f$ r \f$ of the base-band filter
+      inline const array_type& r() const;
+
+      //! Phasors at their initial state, one per channel
+      inline const std::vector<detail::phasor<Scalar> >& phasors() const;
+
+      //! Point the coefficients of a kernel view on our arrays
+      inline void view(detail::cooke1993_arrays<Scalar>& s) const;
+
+    private:
+      std::size_t m_channels;
+      array_type m_factor, m_cre, m_cim, m_r;
+      std::vector<detail::phasor<Scalar> > m_phasors;
+    };
+  }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+cooke1993_coefficients(const Scalar& sample_frequency,
+                       const std::vector<Scalar>& center_frequencies,
+                       const std::vector<Scalar>& bandwidths)
+  : m_channels(center_frequencies.size())
+{
+  const std::size_t size = detail::simd::padded_size<Scalar>(m_channels);
+
+  m_factor.resize(size);
+  m_cre.resize(size);
+  m_cim.resize(size);
+  m_r.resize(size);
+  m_phasors.resize(m_channels);
+
+  for(std::size_t j = 0; j < m_channels; ++j)
+    {
+      const core_type core(sample_frequency, center_frequencies[j], bandwidths[j]);
+
+      m_factor[j] = core.factor();
+      m_cre[j] = core.c.real();
+      m_cim[j] = core.c.imag();
+      m_phasors[j] = core.m_phasor;
+      m_r[j] = core.r;
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+nb_channels() const
+{
+  return m_channels;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+padded_size() const
+{
+  return m_factor.size();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+const typename gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::array_type&
+gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+factor() const
+{
+  return m_factor;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+const typename gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::array_type&
+gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+cre() const
+{
+  return m_cre;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+const typename gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::array_type&
+gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+cim() const
+{
+  return m_cim;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+const typename gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::array_type&
+gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+r() const
+{
+  return m_r;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+const std::vector<gammatone::detail::phasor<Scalar> >&
+gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+phasors() const
+{
+  return m_phasors;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+view(detail::cooke1993_arrays<Scalar>& s) const
+{
+  s.channels = m_channels;
+  s.factor = m_factor.data();
+  s.cre = m_cre.data(); s.cim = m_cim.data();
+  s.r = m_r.data();
+}
+
+#endif // GAMMATONE_CORE_COOKE1993_COEFFICIENTS_HPP
@@ -0,0 +1,317 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_CORE_COOKE1993_DESIGN_HPP
+#define GAMMATONE_CORE_COOKE1993_DESIGN_HPP
+
+#include <gammatone/core/cooke1993.hpp>
+#include <gammatone/core/cooke1993_coefficients.hpp>
+#include <gammatone/policy/gain.hpp>
+#include <gammatone/policy/clipping.hpp>
+#include <gammatone/detail/simd.hpp>
+#include <gammatone/detail/cooke1993_simd.hpp>
+#include <gammatone/detail/phasor.hpp>
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <vector>
+
+namespace gammatone
+{
+  namespace core
+  {
+    //! Coefficients of a core::cooke1993_bank, apart from its state
+    /*!
+      \class cooke1993_design
+
+      This class holds the coefficients of a bank of core::cooke1993
+      channels, while the recursion states are held by separate
+      state_type objects. A design is never modified by
+      compute_strided(), so that a single design can be shared by
+      several threads, each one computing its own states. A state
+      only holds the phasors and the cascade states of the channels.
+
+      The arrays and kernels are those of core::cooke1993_bank, the
+      results being identical.
+
+      \tparam Scalar         Type of scalar values
+      \tparam GainPolicy     Policy for gain computation, see policy::gain .
+      \tparam ClippingPolicy Policy for clipping small values, see policy::clipping .
+    */
+    template
+    <
+      class Scalar,
+      class GainPolicy = policy::gain::forall_0dB,
+      class ClippingPolicy = policy::clipping::off
+      >
+    class cooke1993_design
+    {
+      //! Type of the per-channel arrays, aligned for SIMD kernels
+      using array_type = std::vector<Scalar, detail::simd::aligned_allocator<Scalar> >;
+
+    public:
+      //! Type of the scalars
+      using scalar_type = Scalar;
+
+      //! Type of the equivalent single channel core
+      using core_type = cooke1993<Scalar,GainPolicy,ClippingPolicy>;
+
+      //! Type of the instruction sets for which kernels are available
+      using kernel_type = detail::simd::isa;
+
+      //! Recursion state of all the channels of a design
+      class state_type
+      {
+      public:
+        //! The number of channels
+        inline std::size_t nb_channels() const{
+          return m_phasors.size();
+        }
+
+        //! Set all the channels at their initial state
+        inline void reset(){
+          for(auto& v : m_vre) std::fill(v.begin(), v.end(), 0.0);
+          for(auto& v : m_vim) std::fill(v.begin(), v.end(), 0.0);
+          std::fill(m_qre.begin(), m_qre.end(), 1.0);
+          std::fill(m_qim.begin(), m_qim.end(), 0.0);
+          for(auto& p : m_phasors) p.reset();
+        }
+
+      private:
+        friend class cooke1993_design;
+
+        //! Real and imaginary parts of the phasor \f$ q \f$
+        array_type m_qre, m_qim;
+
+        //! Resynchronization of the phasors
+        std::vector<detail::phasor<Scalar> > m_phasors;
+
+        //! Real and imaginary parts of the states of the sections 4 to 1
+        std::array<array_type,4> m_vre, m_vim;
+      };
+
+      //! Creates a design from explicit parameters, see cooke1993_bank::cooke1993_bank()
+      cooke1993_design(const Scalar& sample_frequency,
+                       const std::vector<Scalar>& center_frequencies,
+                       const std::vector<Scalar>& bandwidths);
+
+      //! The number of channels in the design
+      inline std::size_t nb_channels() const;
+
+      //! The kernel used by compute_strided()
+      inline kernel_type kernel() const;
+
+      //! Force the kernel used by compute_strided(), see cooke1993_bank::set_kernel()
+      inline bool set_kernel(const kernel_type& kernel);
+
+      //! The widest kernel available on the running CPU
+      static inline kernel_type default_kernel();
+
+      //! A new state of the design, at its initial value
+      inline state_type make_state() const;
+
+      //! Compute all the channels from a given state
+      /*!
+        As cooke1993_bank::compute_strided() on all the channels,
+        the state being updated.
+
+        \attention state must have been made by this design, or by
+        a design with the same channels.
+      */
+      inline void compute_strided(state_type& state,
+                                  const std::size_t& size,
+                                  const Scalar* input,
+                                  Scalar* output,
+                                  const std::size_t& sample_stride,
+                                  const std::size_t& channel_stride) const;
+
+      //! Compute a slice of channels from a given state
+      /*!
+        Only the channels in [first, last) are computed and their
+        state updated, see cooke1993_bank::compute_strided().
+        Concurrent calls on disjoint slices of a single state are
+        safe as long as slice boundaries are multiples of
+        alignment().
+      */
+      inline void compute_strided(state_type& state,
+                                  const std::size_t& size,
+                                  const Scalar* input,
+                                  Scalar* output,
+                                  const std::size_t& sample_stride,
+                                  const std::size_t& channel_stride,
+                                  const std::size_t& first,
+                                  const std::size_t& last) const;
+
+      //! Granularity of channel slices, see compute_strided()
+      static constexpr std::size_t alignment(){
+        return detail::simd::max_lanes<Scalar>();
+      }
+
+    private:
+
+      //! Raw view on the coefficients and the arrays of a state for the kernels
+      inline detail::cooke1993_arrays<Scalar> arrays(state_type& state) const;
+
+      //! Filter coefficients, the phasors being the initial ones of the states
+      cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy> m_coefficients;
+
+      //! Kernel used in compute_strided()
+      kernel_type m_kernel;
+    };
+  }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::
+cooke1993_design(const Scalar& sample_frequency,
+                 const std::vector<Scalar>& center_frequencies,
+                 const std::vector<Scalar>& bandwidths)
+  : m_coefficients(sample_frequency, center_frequencies, bandwidths),
+    m_kernel(default_kernel())
+{}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::
+nb_channels() const
+{
+  return m_coefficients.nb_channels();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::kernel_type
+gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::
+kernel() const
+{
+  return m_kernel;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+bool gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::
+set_kernel(const kernel_type& kernel)
+{
+  if(kernel != kernel_type::scalar)
+    {
+      if(default_kernel() == kernel_type::scalar || !detail::simd::supported(kernel))
+        return false;
+    }
+
+  m_kernel = kernel;
+  return true;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::kernel_type
+gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::
+default_kernel()
+{
+  // kernels do not implement clipping
+  if(std::is_same<ClippingPolicy,policy::clipping::on>::value ||
+     !detail::simd::is_vectorizable<Scalar>::value)
+    return kernel_type::scalar;
+
+  return detail::simd::best();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::state_type
+gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::
+make_state() const
+{
+  const std::size_t size = m_coefficients.padded_size();
+
+  state_type state;
+  state.m_qre.resize(size);
+  state.m_qim.resize(size);
+  state.m_phasors = m_coefficients.phasors();
+  for(auto& v : state.m_vre) v.resize(size);
+  for(auto& v : state.m_vim) v.resize(size);
+  state.reset();
+  return state;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::detail::cooke1993_arrays<Scalar>
+gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::
+arrays(state_type& state) const
+{
+  detail::cooke1993_arrays<Scalar> s;
+  m_coefficients.view(s);
+  s.qre = state.m_qre.data(); s.qim = state.m_qim.data();
+  s.v4re = state.m_vre[0].data(); s.v4im = state.m_vim[0].data();
+  s.v3re = state.m_vre[1].data(); s.v3im = state.m_vim[1].data();
+  s.v2re = state.m_vre[2].data(); s.v2im = state.m_vim[2].data();
+  s.v1re = state.m_vre[3].data(); s.v1im = state.m_vim[3].data();
+  return s;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::
+compute_strided(state_type& state, const std::size_t& size, const Scalar* input, Scalar* output,
+                const std::size_t& sample_stride, const std::size_t& channel_stride) const
+{
+  compute_strided(state, size, input, output, sample_stride, channel_stride,
+                  0, m_coefficients.nb_channels());
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_design<Scalar,GainPolicy,ClippingPolicy>::
+compute_strided(state_type& state, const std::size_t& size, const Scalar* input, Scalar* output,
+                const std::size_t& sample_stride, const std::size_t& channel_stride,
+                const std::size_t& first, const std::size_t& last) const
+{
+  if(first >= last)
+    return;
+
+  const detail::cooke1993_arrays<Scalar> s = arrays(state);
+  const Scalar* factor = m_coefficients.factor().data();
+
+  // as cooke1993_bank::compute_strided
+  for(std::size_t done = 0; done < size; )
+    {
+      const std::size_t n = std::min(size - done, state.m_phasors[first].remaining());
+      const Scalar* x = input + done;
+      Scalar* y = output + done*sample_stride;
+
+      if(m_kernel == kernel_type::scalar ||
+         ! detail::cooke1993_dispatch(m_kernel, s, n, x, y, sample_stride, channel_stride,
+                                      first, last))
+        detail::cooke1993_scalar<ClippingPolicy>(
+          s, n, x, first, last,
+          [&](const std::size_t& i, const std::size_t& j,
+              const Scalar& ure, const Scalar& uim, const Scalar& qre, const Scalar& qim)
+          {
+            y[i*sample_stride + j*channel_stride] = factor[j] * (ure*qre + uim*qim);
+          });
+
+      for(std::size_t j = first; j < last; ++j)
+        state.m_phasors[j].advance(n, state.m_qre[j], state.m_qim[j]);
+      done += n;
+    }
+}
+
+#endif // GAMMATONE_CORE_COOKE1993_DESIGN_HPP
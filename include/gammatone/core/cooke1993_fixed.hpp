@@ -0,0 +1,322 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_CORE_COOKE1993_FIXED_HPP
+#define GAMMATONE_CORE_COOKE1993_FIXED_HPP
+
+#include <gammatone/core/cooke1993.hpp>
+#include <gammatone/detail/fixed_point.hpp>
+#include <gammatone/detail/phasor.hpp>
+#include <gammatone/policy/rounding.hpp>
+#include <array>
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+namespace gammatone
+{
+  namespace core
+  {
+    //! Fixed-point implementation of core::cooke1993
+    /*!
+      \class cooke1993_fixed
+
+      Integer-only variant of cooke1993 for Q15 (16 bits PCM) or Q31
+      signals. Coefficients are computed in double precision and
+      quantized at construction. The processing is then done on
+      integers, products being computed in the wide type of
+      detail::fixed_point and shifted back by RoundingPolicy. Each
+      intermediate value is saturated to full scale.
+
+      To keep the states in the range of Integer, each section of the
+      base-band cascade is normalized to a unit gain at DC,
+      \f$ v_k(t) = (1-r) v_{k-1}(t) + r v_k(t-1) \f$, the \f$ (1-r)^4
+      \f$ factor being moved to the numerator. The quantized pole is
+      used both in the cascade and in the numerator, so that the
+      normalization is exact. The rounding error of each section is
+      fed back in its next update (error feedback, or fraction
+      saving), which puts a zero at DC in the transfer of the
+      rounding noise: otherwise this noise would be amplified by
+      \f$ 1/(1-r) \f$, up to 200 for low frequency channels, which
+      is fatal in Q15.
+
+      The gain is 0 dB at the center frequency, so that a full scale
+      input at the center frequency gives a full scale output, the
+      envelope of the output saturating at full scale. The output is
+      thus the one of cooke1993<double> multiplied by scale().
+
+      The phasor \f$ q_n = e^{-j\omega n} \f$ is not rotated sample
+      by sample, it is the product of a quantized table of \f$
+      e^{-j\omega n} \f$ along a detail::phasor::period with a
+      reference computed in double precision once per period. The
+      phasor error is thus bounded by a few quantization steps, for
+      one floating-point complex product every 256 samples.
+
+      Measured SNR against scale() times cooke1993<double>, over 10
+      seconds of white noise at -6 dBFS, on the 30 channels of
+      channels::fixed_size between 50 Hz and 8 kHz at 44.1 kHz (the
+      lowest one being at 83 Hz), see the cooke1993_fixed_snr
+      standalone test:
+
+      | Format | Rounding   | SNR at 83 Hz | Worst SNR | SNR at 8 kHz |
+      |--------|------------|--------------|-----------|--------------|
+      | Q15    | nearest    | 53 dB        | 52 dB     | 68 dB        |
+      | Q15    | truncate   | 46 dB        | 46 dB     | 61 dB        |
+      | Q31    | nearest    | 148 dB       | 147 dB    | 165 dB       |
+      | Q31    | truncate   | 142 dB       | 142 dB    | 157 dB       |
+
+      convergent rounding gives the same results than nearest.
+
+      \tparam Integer         std::int16_t for Q15, std::int32_t for Q31.
+      \tparam RoundingPolicy  Policy for rounding, see policy::rounding .
+    */
+    template
+    <
+      class Integer = std::int16_t,
+      class RoundingPolicy = policy::rounding::nearest
+      >
+    class cooke1993_fixed
+    {
+    public:
+      //! Type of the samples
+      using integer_type = Integer;
+
+      //! Type of the products, see detail::fixed_point
+      using wide_type = typename detail::fixed_point<Integer>::wide_type;
+
+      //! Creates a fixed-point core
+      /*!
+        \param sample_frequency  The sample frequency (Hz).
+        \param center_frequency  The center frequency (Hz).
+        \param bandwidth         The bandwidth (Hz).
+      */
+      cooke1993_fixed(const double& sample_frequency,
+                      const double& center_frequency,
+                      const double& bandwidth);
+
+      //! Set the core at its initial state
+      inline void reset();
+
+      //! Compute an output from an input sample
+      inline void compute(const Integer& input, Integer& output);
+
+      //! Compute a block of samples
+      /*!
+        \param input   Pointer to *size* input samples
+        \param output  Pointer to *size* output samples, may be equal to input
+        \param size    Number of samples to process
+      */
+      inline void compute_block(const Integer* input, Integer* output, const std::size_t& size);
+
+      //! The quantized pole \f$ r \f$ of the base-band filter
+      inline double pole() const;
+
+      //! Ratio of the output to the one of cooke1993<double>
+      inline double scale() const;
+
+    private:
+
+      //! Product of two Integers shifted back by *bits*
+      static inline wide_type shift(const wide_type& x, const std::size_t& bits);
+
+      //! One section of the cascade, v = (1-r) x + r v, e being its rounding error
+      inline void section(const Integer& x, Integer& v, wide_type& e) const;
+
+      // Filter coefficients
+
+      //! The pole \f$ r \f$ and \f$ 1-r \f$, on fraction_bits
+      Integer m_r, m_g;
+
+      //! Numerator coefficients, including the inverse gain, on fraction_bits - 3
+      std::array<Integer,3> m_b;
+
+      //! See scale()
+      double m_scale;
+
+      //! Real and imaginary parts of \f$ e^{-j\omega n} \f$ for n < period
+      std::vector<Integer> m_tre, m_tim;
+
+      // Filter states
+
+      //! Reference phasor at the beginning of the current period
+      detail::phasor<double> m_phasor;
+      Integer m_refre, m_refim;
+
+      //! Real and imaginary parts of the states of the sections 4 to 1
+      std::array<Integer,4> m_vre, m_vim;
+
+      //! Rounding errors of the sections, on 2*fraction_bits
+      std::array<wide_type,4> m_ere, m_eim;
+    };
+  }
+}
+
+
+template<class Integer, class RoundingPolicy>
+gammatone::core::cooke1993_fixed<Integer, RoundingPolicy>::
+cooke1993_fixed(const double& sample_frequency,
+                const double& center_frequency,
+                const double& bandwidth)
+  : m_phasor(2.0*M_PI / sample_frequency * center_frequency)
+{
+  using detail::quantize;
+  constexpr std::size_t bits = detail::fixed_point<Integer>::fraction_bits;
+
+  // coefficients of the floating-point implementation
+  const cooke1993<double> core(sample_frequency, center_frequency, bandwidth);
+
+  // the pole in ]0,1[, 1-r being exact
+  const wide_type one = wide_type(1) << bits;
+  m_r = quantize<Integer>(core.r);
+  if(m_r < 1) m_r = 1;
+  m_g = static_cast<Integer>(one - m_r);
+
+  // Numerator of cooke1993::compute() on the normalized cascade,
+  // whose gain at DC is 1 + 4r + 4r^2. A sine at the center
+  // frequency gives a base-band DC of half its amplitude.
+  const double r = detail::dequantize(m_r), g = detail::dequantize(m_g);
+  const double f = 2 / (1 + 4*r + 4*r*r);
+  m_b[0] = quantize<Integer>(f, bits - 3);
+  m_b[1] = quantize<Integer>(8*r*f, bits - 3);
+  m_b[2] = quantize<Integer>(4*r*g*f, bits - 3);
+
+  // same gain for the floating-point pole
+  const double r0 = core.r;
+  m_scale = 2*std::pow(1 - r0, 4) / (core.factor() * (1 + 4*r0 + 4*r0*r0));
+
+  const std::size_t period = detail::phasor<double>::period;
+  const double omega = 2.0*M_PI / sample_frequency * center_frequency;
+  m_tre.resize(period);
+  m_tim.resize(period);
+  for(std::size_t n = 0; n < period; ++n)
+    {
+      m_tre[n] = quantize<Integer>(std::cos(omega*n));
+      m_tim[n] = quantize<Integer>(-std::sin(omega*n));
+    }
+
+  reset();
+}
+
+
+template<class Integer, class RoundingPolicy>
+void gammatone::core::cooke1993_fixed<Integer, RoundingPolicy>::
+reset()
+{
+  m_phasor.reset();
+  m_refre = detail::quantize<Integer>(1.0);
+  m_refim = 0;
+  m_vre.fill(0);
+  m_vim.fill(0);
+  m_ere.fill(0);
+  m_eim.fill(0);
+}
+
+
+template<class Integer, class RoundingPolicy>
+double gammatone::core::cooke1993_fixed<Integer, RoundingPolicy>::
+pole() const
+{
+  return detail::dequantize(m_r);
+}
+
+
+template<class Integer, class RoundingPolicy>
+double gammatone::core::cooke1993_fixed<Integer, RoundingPolicy>::
+scale() const
+{
+  return m_scale;
+}
+
+
+template<class Integer, class RoundingPolicy>
+typename gammatone::core::cooke1993_fixed<Integer, RoundingPolicy>::wide_type
+gammatone::core::cooke1993_fixed<Integer, RoundingPolicy>::
+shift(const wide_type& x, const std::size_t& bits)
+{
+  return RoundingPolicy::shift(x, bits);
+}
+
+
+template<class Integer, class RoundingPolicy>
+void gammatone::core::cooke1993_fixed<Integer, RoundingPolicy>::
+section(const Integer& x, Integer& v, wide_type& e) const
+{
+  constexpr std::size_t bits = detail::fixed_point<Integer>::fraction_bits;
+
+  // g + r = 1, so that |v| stays below full scale
+  const wide_type a = wide_type(m_g)*x + wide_type(m_r)*v + e;
+  const wide_type y = shift(a, bits);
+  v = detail::saturate<Integer>(y);
+
+  // the error is dropped on saturation
+  e = (y == v) ? a - y*(wide_type(1) << bits) : 0;
+}
+
+
+template<class Integer, class RoundingPolicy>
+void gammatone::core::cooke1993_fixed<Integer, RoundingPolicy>::
+compute(const Integer& input, Integer& output)
+{
+  using detail::saturate;
+  using W = wide_type;
+  constexpr std::size_t bits = detail::fixed_point<Integer>::fraction_bits;
+
+  // q = reference * e^{-j omega n}
+  const std::size_t n = detail::phasor<double>::period - m_phasor.remaining();
+  const Integer qre = saturate<Integer>(shift(W(m_refre)*m_tre[n] - W(m_refim)*m_tim[n], bits));
+  const Integer qim = saturate<Integer>(shift(W(m_refre)*m_tim[n] + W(m_refim)*m_tre[n], bits));
+
+  // demodulated input
+  const Integer wre = saturate<Integer>(shift(W(qre)*input, bits));
+  const Integer wim = saturate<Integer>(shift(W(qim)*input, bits));
+
+  // cascade, as in cooke1993::compute()
+  const Integer p1re = m_vre[0], p1im = m_vim[0], w1re = m_vre[1], w1im = m_vim[1];
+  section(wre, m_vre[3], m_ere[3]); section(wim, m_vim[3], m_eim[3]);
+  section(m_vre[3], m_vre[2], m_ere[2]); section(m_vim[3], m_vim[2], m_eim[2]);
+  section(m_vre[2], m_vre[1], m_ere[1]); section(m_vim[2], m_vim[1], m_eim[1]);
+  section(m_vre[1], m_vre[0], m_ere[0]); section(m_vim[1], m_vim[0], m_eim[0]);
+
+  // envelope, saturated at full scale
+  const Integer ure = saturate<Integer>(
+    shift(W(m_b[0])*m_vre[0] + W(m_b[1])*p1re - W(m_b[2])*w1re, bits - 3));
+  const Integer uim = saturate<Integer>(
+    shift(W(m_b[0])*m_vim[0] + W(m_b[1])*p1im - W(m_b[2])*w1im, bits - 3));
+
+  output = saturate<Integer>(shift(W(ure)*qre + W(uim)*qim, bits));
+
+  // next period
+  std::complex<double> reference;
+  if(m_phasor.advance(1, reference))
+    {
+      m_refre = detail::quantize<Integer>(reference.real());
+      m_refim = detail::quantize<Integer>(reference.imag());
+    }
+}
+
+
+template<class Integer, class RoundingPolicy>
+void gammatone::core::cooke1993_fixed<Integer, RoundingPolicy>::
+compute_block(const Integer* input, Integer* output, const std::size_t& size)
+{
+  for(std::size_t i = 0; i < size; ++i)
+    compute(input[i], output[i]);
+}
+
+#endif // GAMMATONE_CORE_COOKE1993_FIXED_HPP
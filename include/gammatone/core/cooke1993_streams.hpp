@@ -0,0 +1,378 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_CORE_COOKE1993_STREAMS_HPP
+#define GAMMATONE_CORE_COOKE1993_STREAMS_HPP
+
+#include <gammatone/core/cooke1993.hpp>
+#include <gammatone/core/cooke1993_coefficients.hpp>
+#include <gammatone/policy/gain.hpp>
+#include <gammatone/policy/clipping.hpp>
+#include <gammatone/detail/simd.hpp>
+#include <gammatone/detail/cooke1993_simd.hpp>
+#include <gammatone/detail/phasor.hpp>
+#include <algorithm>
+#include <array>
+#include <complex>
+#include <type_traits>
+#include <vector>
+
+namespace gammatone
+{
+  namespace core
+  {
+    //! Bank of core::cooke1993 channels computed on several input streams
+    /*!
+      \class cooke1993_streams
+
+      This class computes the same bank of channels as
+      core::cooke1993_bank on K independent inputs, as K banks would
+      do. The coefficients of the channels are stored once, and so is
+      their phasor \f$ q \f$, which does not depend on the input. Only
+      the states of the cascade are duplicated, in arrays laid out as
+      those of core::cooke1993_bank for each stream.
+
+      The SIMD kernels compute a group of 2, 4 or 8 double channels
+      (4, 8 or 16 float channels) on pairs of streams: the
+      coefficients are loaded once per group, the phasor is rotated
+      once per sample for both streams, and the two independent
+      cascades overlap their latencies, which bound the throughput of
+      a single bank. The outputs are written in place with the
+      strides of the caller.
+
+      Each stream computes exactly the same operations as
+      core::cooke1993::compute(). Inputs are computed by segments
+      ending at the resynchronizations of the phasors. Kernels are
+      bypassed when clipping is enabled.
+
+      \tparam Scalar         Type of scalar values
+      \tparam GainPolicy     Policy for gain computation, see policy::gain .
+      \tparam ClippingPolicy Policy for clipping small values, see policy::clipping .
+    */
+    template
+    <
+      class Scalar,
+      class GainPolicy = policy::gain::forall_0dB,
+      class ClippingPolicy = policy::clipping::off
+      >
+    class cooke1993_streams
+    {
+      //! Type of the per-channel arrays, aligned for SIMD kernels
+      using array_type = std::vector<Scalar, detail::simd::aligned_allocator<Scalar> >;
+
+    public:
+      //! Type of the scalars
+      using scalar_type = Scalar;
+
+      //! Type of the equivalent single channel core
+      using core_type = cooke1993<Scalar,GainPolicy,ClippingPolicy>;
+
+      //! Type of the instruction sets for which kernels are available
+      using kernel_type = detail::simd::isa;
+
+      //! Creates a bank of cores on several streams
+      /*!
+        \param sample_frequency   The sample frequency (Hz).
+        \param center_frequencies The center frequency of each channel (Hz).
+        \param bandwidths         The bandwidth of each channel (Hz).
+        \param nb_streams         The number of input streams.
+
+        \attention center_frequencies and bandwidths must have the same size.
+      */
+      cooke1993_streams(const Scalar& sample_frequency,
+                        const std::vector<Scalar>& center_frequencies,
+                        const std::vector<Scalar>& bandwidths,
+                        const std::size_t& nb_streams);
+
+      //! The number of channels computed on each stream
+      inline std::size_t nb_channels() const;
+
+      //! The number of input streams
+      inline std::size_t nb_streams() const;
+
+      //! Set all the channels of all the streams at their initial state
+      inline void reset();
+
+      //! The kernel used by compute_strided()
+      inline kernel_type kernel() const;
+
+      //! Force the kernel used by compute_strided(), see cooke1993_bank::set_kernel()
+      inline bool set_kernel(const kernel_type& kernel);
+
+      //! The widest kernel available on the running CPU
+      static inline kernel_type default_kernel();
+
+      //! Compute all the channels of all the streams
+      /*!
+        \param size                 Number of input samples per stream.
+        \param input                Pointer to the input scalars, sample i
+        of stream k being input[i*input_sample_stride + k*input_stream_stride].
+        \param input_sample_stride  Distance between two samples of a stream.
+        \param input_stream_stride  Distance between two streams of a sample.
+        \param output               Pointer to the output scalars, the output
+        of channel j of stream k at sample i being stored in
+        output[i*sample_stride + j*channel_stride + k*stream_stride].
+        \param sample_stride        Distance between two output samples.
+        \param channel_stride       Distance between two output channels.
+        \param stream_stride        Distance between two output streams.
+      */
+      inline void compute_strided(const std::size_t& size,
+                                  const Scalar* input,
+                                  const std::size_t& input_sample_stride,
+                                  const std::size_t& input_stream_stride,
+                                  Scalar* output,
+                                  const std::size_t& sample_stride,
+                                  const std::size_t& channel_stride,
+                                  const std::size_t& stream_stride);
+
+    private:
+
+      //! Scalar implementation of compute_strided(), between resynchronizations
+      inline void compute_scalar(const std::size_t& size,
+                                 const Scalar* input,
+                                 const std::size_t& input_sample_stride,
+                                 const std::size_t& input_stream_stride,
+                                 Scalar* output,
+                                 const std::size_t& sample_stride,
+                                 const std::size_t& channel_stride,
+                                 const std::size_t& stream_stride);
+
+      //! Raw view on the arrays for the SIMD kernels
+      inline detail::cooke1993_arrays<Scalar> arrays();
+
+      //! Number of channels and of streams
+      std::size_t m_channels, m_streams;
+
+      //! Number of channels padded for the kernels, distance between the states of two streams
+      std::size_t m_padded;
+
+      //! Kernel used in compute_strided()
+      kernel_type m_kernel;
+
+      //! Filter coefficients
+      cooke1993_coefficients<Scalar,GainPolicy,ClippingPolicy> m_coefficients;
+
+      // Filter states
+
+      //! Real and imaginary parts of the phasor \f$ q \f$, shared by the streams
+      array_type m_qre, m_qim;
+
+      //! Resynchronization of the phasors
+      std::vector<detail::phasor<Scalar> > m_phasors;
+
+      //! Real and imaginary parts of the states of the sections 4 to 1, channel j of stream k in [k*m_padded + j]
+      std::array<array_type,4> m_vre, m_vim;
+    };
+  }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::
+cooke1993_streams(const Scalar& sample_frequency,
+                  const std::vector<Scalar>& center_frequencies,
+                  const std::vector<Scalar>& bandwidths,
+                  const std::size_t& nb_streams)
+  : m_channels(center_frequencies.size()),
+    m_streams(nb_streams),
+    m_padded(detail::simd::padded_size<Scalar>(m_channels)),
+    m_kernel(default_kernel()),
+    m_coefficients(sample_frequency, center_frequencies, bandwidths),
+    m_phasors(m_coefficients.phasors())
+{
+  m_qre.resize(m_padded);
+  m_qim.resize(m_padded);
+  for(auto& v : m_vre) v.resize(m_streams*m_padded);
+  for(auto& v : m_vim) v.resize(m_streams*m_padded);
+
+  reset();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::
+nb_channels() const
+{
+  return m_channels;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::
+nb_streams() const
+{
+  return m_streams;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::
+reset()
+{
+  for(auto& v : m_vre) std::fill(v.begin(), v.end(), 0.0);
+  for(auto& v : m_vim) std::fill(v.begin(), v.end(), 0.0);
+  std::fill(m_qre.begin(), m_qre.end(), 1.0);
+  std::fill(m_qim.begin(), m_qim.end(), 0.0);
+  for(auto& p : m_phasors) p.reset();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::kernel_type
+gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::
+kernel() const
+{
+  return m_kernel;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+bool gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::
+set_kernel(const kernel_type& kernel)
+{
+  if(kernel != kernel_type::scalar)
+    {
+      if(default_kernel() == kernel_type::scalar || !detail::simd::supported(kernel))
+        return false;
+    }
+
+  m_kernel = kernel;
+  return true;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::kernel_type
+gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::
+default_kernel()
+{
+  // kernels do not implement clipping
+  if(std::is_same<ClippingPolicy,policy::clipping::on>::value ||
+     !detail::simd::is_vectorizable<Scalar>::value)
+    return kernel_type::scalar;
+
+  return detail::simd::best();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::detail::cooke1993_arrays<Scalar>
+gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::
+arrays()
+{
+  detail::cooke1993_arrays<Scalar> s;
+  m_coefficients.view(s);
+  s.qre = m_qre.data(); s.qim = m_qim.data();
+  s.v4re = m_vre[0].data(); s.v4im = m_vim[0].data();
+  s.v3re = m_vre[1].data(); s.v3im = m_vim[1].data();
+  s.v2re = m_vre[2].data(); s.v2im = m_vim[2].data();
+  s.v1re = m_vre[3].data(); s.v1im = m_vim[3].data();
+  return s;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::
+compute_strided(const std::size_t& size, const Scalar* input,
+                const std::size_t& input_sample_stride, const std::size_t& input_stream_stride,
+                Scalar* output, const std::size_t& sample_stride,
+                const std::size_t& channel_stride, const std::size_t& stream_stride)
+{
+  if(m_channels == 0 || m_streams == 0)
+    return;
+
+  // all the phasors are resynchronized together
+  for(std::size_t done = 0; done < size; )
+    {
+      const std::size_t n = std::min(size - done, m_phasors[0].remaining());
+      const Scalar* x = input + done*input_sample_stride;
+      Scalar* y = output + done*sample_stride;
+
+      if(m_kernel == kernel_type::scalar ||
+         ! detail::cooke1993_streams_dispatch(m_kernel, arrays(), m_padded, m_streams, n,
+                                              x, input_sample_stride, input_stream_stride,
+                                              y, sample_stride, channel_stride, stream_stride))
+        compute_scalar(n, x, input_sample_stride, input_stream_stride,
+                       y, sample_stride, channel_stride, stream_stride);
+
+      for(std::size_t j = 0; j < m_channels; ++j)
+        m_phasors[j].advance(n, m_qre[j], m_qim[j]);
+      done += n;
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::cooke1993_streams<Scalar,GainPolicy,ClippingPolicy>::
+compute_scalar(const std::size_t& size, const Scalar* input,
+               const std::size_t& input_sample_stride, const std::size_t& input_stream_stride,
+               Scalar* output, const std::size_t& sample_stride,
+               const std::size_t& channel_stride, const std::size_t& stream_stride)
+{
+  const detail::cooke1993_arrays<Scalar> s = arrays();
+
+  for(std::size_t j = 0; j < m_channels; ++j)
+    {
+      const Scalar r = s.r[j], cre = s.cre[j], cim = s.cim[j];
+      Scalar qre = s.qre[j], qim = s.qim[j];
+
+      // every stream starts from the same phasor
+      for(std::size_t k = 0; k < m_streams; ++k)
+        {
+          const std::size_t l = k*m_padded + j;
+          qre = s.qre[j];
+          qim = s.qim[j];
+
+          for(std::size_t i = 0; i < size; ++i)
+            {
+              const Scalar x = input[i*input_sample_stride + k*input_stream_stride];
+
+              // update the cascade and u, as in cooke1993::compute
+              const Scalar p1re = s.v4re[l], p1im = s.v4im[l];
+              const Scalar w1re = s.v3re[l], w1im = s.v3im[l];
+              std::complex<Scalar> w;
+              w = ClippingPolicy::clip(std::complex<Scalar>(qre*x + r*s.v1re[l], qim*x + r*s.v1im[l]));
+              s.v1re[l] = w.real(); s.v1im[l] = w.imag();
+              w = ClippingPolicy::clip(std::complex<Scalar>(s.v1re[l] + r*s.v2re[l], s.v1im[l] + r*s.v2im[l]));
+              s.v2re[l] = w.real(); s.v2im[l] = w.imag();
+              w = ClippingPolicy::clip(std::complex<Scalar>(s.v2re[l] + r*s.v3re[l], s.v2im[l] + r*s.v3im[l]));
+              s.v3re[l] = w.real(); s.v3im[l] = w.imag();
+              w = ClippingPolicy::clip(std::complex<Scalar>(s.v3re[l] + r*s.v4re[l], s.v3im[l] + r*s.v4im[l]));
+              s.v4re[l] = w.real(); s.v4im[l] = w.imag();
+
+              const Scalar ure = s.v4re[l] + (8*r)*p1re - (4*r)*w1re;
+              const Scalar uim = s.v4im[l] + (8*r)*p1im - (4*r)*w1im;
+
+              output[i*sample_stride + j*channel_stride + k*stream_stride] =
+                s.factor[j] * (ure*qre + uim*qim);
+
+              // update q
+              const Scalar re = cre*qre + cim*qim;
+              const Scalar im = cre*qim - cim*qre;
+              qre = re;
+              qim = im;
+            }
+        }
+
+      s.qre[j] = qre;
+      s.qim[j] = qim;
+    }
+}
+
+#endif // GAMMATONE_CORE_COOKE1993_STREAMS_HPP
@@ -22,8 +22,11 @@
 
 #include <gammatone/core/base.hpp>
 #include <gammatone/core/slaney1993_iir.hpp>
+#include <gammatone/detail/slaney1993_simd.hpp>
+#include <gammatone/detail/state_space.hpp>
 #include <gammatone/policy/clipping.hpp>
 #include <array>
+#include <vector>
 
 namespace gammatone
 {
@@ -66,8 +69,50 @@ namespace gammatone
       inline void reset();
         inline void compute(const Scalar& input, Scalar& output);
 
+      //! Compute a block of samples
+      /*!
+        Statically dispatched equivalent of *size* successive calls
+        to compute(). When SIMD kernels are available the four stages
+        run together in a skewed pipeline (see
+        detail::simd::slaney1993_pipeline_kernel), otherwise they are run one
+        after the other on the whole block, in place in output. Both
+        give the same results as compute().
+
+        \param input   Pointer to *size* input scalars
+        \param output  Pointer to *size* output scalars, may be equal to input
+        \param size    Number of samples to process
+      */
+      inline void compute_block(const Scalar* input, Scalar* output, const std::size_t& size);
+
+      //! The recursion state, \f$ (z_1, z_2) \f$ of each stage
+      inline std::vector<Scalar> state() const;
+
+      //! Set the recursion state, see state()
+      inline void set_state(const std::vector<Scalar>& state);
+
+      //! Time invariant core, does nothing
+      inline void seek(const std::size_t&){}
+
+      //! Type of the state transition over several samples
+      using transition_type = detail::square_matrix<Scalar>;
+
+      //! The state transition over n samples of null input
+      /*!
+        Power of the cascade transition matrix, computed by squaring.
+      */
+      inline transition_type transition(const std::size_t& n) const;
+
+      //! Apply a transition to a state, see transition()
+      inline void propagate(const transition_type& t, std::vector<Scalar>& state) const;
+
     private:
 
+      // The multi-channel implementations reuse our coefficients
+      template<class, class, class> friend class slaney1993_coefficients;
+
+      //! Copy of the stages coefficients and states
+      inline detail::slaney1993_cascade<Scalar> cascade() const;
+
       inline std::array<slaney1993_iir<Scalar>,4> find_filters(const Scalar& sample_frequency,
                                                                const Scalar& center_frequency,
 							       const Scalar& bandwidth);
@@ -168,6 +213,78 @@ void gammatone::core::slaney1993<Scalar,GainPolicy,ClippingPolicy>::compute(cons
                         input, this->factor()))));
 }
 
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993<Scalar,GainPolicy,ClippingPolicy>::
+compute_block(const Scalar* input, Scalar* output, const std::size_t& size)
+{
+  detail::slaney1993_cascade<Scalar> c = cascade();
+  if(detail::slaney1993_pipeline_dispatch(detail::simd::best(), c, input, output, size))
+    {
+      for(std::size_t k = 0; k < m_filter.size(); ++k)
+        m_filter[k].set_state({{c.z1[k], c.z2[k]}});
+      return;
+    }
+
+  m_filter[0].compute_block(input, output, size, this->factor());
+  m_filter[1].compute_block(output, output, size);
+  m_filter[2].compute_block(output, output, size);
+  m_filter[3].compute_block(output, output, size);
+}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::detail::slaney1993_cascade<Scalar>
+gammatone::core::slaney1993<Scalar,GainPolicy,ClippingPolicy>::
+cascade() const
+{
+  detail::slaney1993_cascade<Scalar> c;
+  c.gain = this->factor();
+  for(std::size_t k = 0; k < m_filter.size(); ++k)
+    {
+      const auto& f = m_filter[k];
+      c.a0[k] = f.m_a[0]; c.a1[k] = f.m_a[1]; c.a2[k] = f.m_a[2];
+      c.b1[k] = f.m_b[1]; c.b2[k] = f.m_b[2];
+      c.z1[k] = f.m_z1; c.z2[k] = f.m_z2;
+    }
+  return c;
+}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::vector<Scalar> gammatone::core::slaney1993<Scalar,GainPolicy,ClippingPolicy>::
+state() const
+{
+  std::vector<Scalar> s;
+  s.reserve(2*m_filter.size());
+  for(const auto& f : m_filter)
+    {
+      const auto z = f.state();
+      s.insert(s.end(), z.begin(), z.end());
+    }
+  return s;
+}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993<Scalar,GainPolicy,ClippingPolicy>::
+set_state(const std::vector<Scalar>& state)
+{
+  for(std::size_t k = 0; k < m_filter.size(); ++k)
+    m_filter[k].set_state({{state[2*k], state[2*k+1]}});
+}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::slaney1993<Scalar,GainPolicy,ClippingPolicy>::transition_type
+gammatone::core::slaney1993<Scalar,GainPolicy,ClippingPolicy>::
+transition(const std::size_t& n) const
+{
+  return detail::power(detail::transition_matrix<Scalar>(*this), n);
+}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993<Scalar,GainPolicy,ClippingPolicy>::
+propagate(const transition_type& t, std::vector<Scalar>& state) const
+{
+  state = t * state;
+}
+
 
 template<class Scalar, class GainPolicy, class ClippingPolicy>
 std::array<gammatone::core::slaney1993_iir<Scalar>,4>
@@ -186,10 +303,10 @@ find_filters(const Scalar& sample_frequency,
   // filters coefficients
   const Scalar A0 = 1.0 / sample_frequency;
   const std::array<Scalar,4> A1 =
-      {{-std::sqrt(3.0 + b)*c - d,
-        std::sqrt( 3.0 + b)*c - d,
-        -std::sqrt(3.0 - b)*c - d,
-        std::sqrt( 3.0 - b)*c - d}};
+      {{-std::sqrt(Scalar(3.0) + b)*c - d,
+        std::sqrt( Scalar(3.0) + b)*c - d,
+        -std::sqrt(Scalar(3.0) - b)*c - d,
+        std::sqrt( Scalar(3.0) - b)*c - d}};
   const Scalar A2 = 0.0;
 
   const Scalar B0 = 1.0;
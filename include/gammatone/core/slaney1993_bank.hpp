@@ -0,0 +1,406 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_CORE_SLANEY1993_BANK_HPP
+#define GAMMATONE_CORE_SLANEY1993_BANK_HPP
+
+#include <gammatone/core/slaney1993.hpp>
+#include <gammatone/core/slaney1993_coefficients.hpp>
+#include <gammatone/policy/gain.hpp>
+#include <gammatone/policy/clipping.hpp>
+#include <gammatone/detail/simd.hpp>
+#include <gammatone/detail/slaney1993_simd.hpp>
+#include <gammatone/detail/state_space.hpp>
+#include <gammatone/layout.hpp>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace gammatone
+{
+  namespace core
+  {
+    //! Multi-channel implementation of core::slaney1993
+    /*!
+      \class slaney1993_bank
+
+      This class computes a whole bank of core::slaney1993 channels
+      at once, the cascades of several channels running side by side.
+      As in core::cooke1993_bank, each coefficient and state of the
+      four stages is stored in a contiguous array indexed by channel.
+      Each channel computes exactly the same operations as
+      core::slaney1993::compute().
+
+      compute_ptr() uses explicit SIMD kernels processing 2, 4 or 8
+      double channels (4, 8 or 16 float channels) at once with SSE2,
+      AVX2 or AVX-512, see kernel() and set_kernel().
+
+      \tparam Scalar         Type of scalar values
+      \tparam GainPolicy     Policy for gain computation, see policy::gain .
+      \tparam ClippingPolicy Unused, as in core::slaney1993 .
+    */
+    template
+    <
+      class Scalar,
+      class GainPolicy = policy::gain::forall_0dB,
+      class ClippingPolicy = policy::clipping::off
+      >
+    class slaney1993_bank
+    {
+      using this_type = slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>;
+
+      //! Type of the per-channel arrays, aligned for SIMD kernels
+      using array_type = std::vector<Scalar, detail::simd::aligned_allocator<Scalar> >;
+
+      //! Type of the per-stage arrays
+      using stage_arrays = std::array<array_type,4>;
+
+    public:
+      //! Type of the scalars
+      using scalar_type = Scalar;
+
+      //! Type of the equivalent single channel core
+      using core_type = slaney1993<Scalar,GainPolicy,ClippingPolicy>;
+
+      //! Type of the instruction sets for which kernels are available
+      using kernel_type = detail::simd::isa;
+
+      //! Creates a bank of cores from explicit parameters
+      /*!
+        \param sample_frequency   The sample frequency (Hz).
+        \param center_frequencies The center frequency of each channel (Hz).
+        \param bandwidths         The bandwidth of each channel (Hz).
+
+        \attention center_frequencies and bandwidths must have the same size.
+      */
+      slaney1993_bank(const Scalar& sample_frequency,
+                      const std::vector<Scalar>& center_frequencies,
+                      const std::vector<Scalar>& bandwidths);
+
+      //! The number of channels in the bank
+      inline std::size_t nb_channels() const;
+
+      //! Set all the channels at their initial state
+      inline void reset();
+
+      //! The kernel used by compute_ptr()
+      inline kernel_type kernel() const;
+
+      //! Force the kernel used by compute_ptr(), see cooke1993_bank::set_kernel()
+      inline bool set_kernel(const kernel_type& kernel);
+
+      //! The widest kernel available for this bank on the running CPU
+      static inline kernel_type default_kernel();
+
+      //! Compute one output per channel from a scalar input
+      inline void compute(const Scalar& input, Scalar* output);
+
+      //! Compute interleaved outputs from pointers, see cooke1993_bank::compute_ptr()
+      inline void compute_ptr(const std::size_t& size,
+                              const Scalar* input,
+                              Scalar* output);
+
+      //! Compute a slice of channels, see cooke1993_bank::compute_ptr()
+      inline void compute_ptr(const std::size_t& size,
+                              const Scalar* input,
+                              Scalar* output,
+                              const layout& l,
+                              const std::size_t& first,
+                              const std::size_t& last);
+
+      //! Compute a slice of channels with explicit output strides
+      inline void compute_strided(const std::size_t& size,
+                                  const Scalar* input,
+                                  Scalar* output,
+                                  const std::size_t& sample_stride,
+                                  const std::size_t& channel_stride,
+                                  const std::size_t& first,
+                                  const std::size_t& last);
+
+      //! The recursion state of all channels
+      /*!
+        \f$ z_1 \f$ of the first stage for all channels, then \f$ z_2
+        \f$, and so on up to the fourth stage.
+      */
+      inline std::vector<Scalar> state() const;
+
+      //! Set the recursion state of all channels, see state()
+      inline void set_state(const std::vector<Scalar>& state);
+
+      //! Time invariant core, does nothing
+      inline void seek(const std::size_t&){}
+
+      //! Type of the state transitions over several samples, one per channel
+      using transition_type = std::vector<detail::square_matrix<Scalar> >;
+
+      //! The state transitions over n samples of null input, see slaney1993::transition()
+      inline transition_type transition(const std::size_t& n) const;
+
+      //! Apply transitions to a state, see transition()
+      inline void propagate(const transition_type& t, std::vector<Scalar>& state) const;
+
+      //! Granularity of channel slices, see compute_ptr()
+      static constexpr std::size_t alignment(){
+        return detail::simd::max_lanes<Scalar>();
+      }
+
+    private:
+
+      //! Scalar implementation of compute_ptr()
+      inline void compute_scalar(const std::size_t& size,
+                                 const Scalar* input,
+                                 Scalar* output,
+                                 const std::size_t& sample_stride,
+                                 const std::size_t& channel_stride,
+                                 const std::size_t& first,
+                                 const std::size_t& last);
+
+      //! Raw view on the arrays for the SIMD kernels
+      inline detail::slaney1993_arrays<Scalar> arrays();
+
+      //! Number of channels, arrays below are padded beyond it
+      std::size_t m_channels;
+
+      //! Kernel used in compute_ptr()
+      kernel_type m_kernel;
+
+      //! Filter coefficients
+      slaney1993_coefficients<Scalar,GainPolicy,ClippingPolicy> m_coefficients;
+
+      //! States of each stage
+      stage_arrays m_z1, m_z2;
+    };
+  }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+slaney1993_bank(const Scalar& sample_frequency,
+                const std::vector<Scalar>& center_frequencies,
+                const std::vector<Scalar>& bandwidths)
+  : m_channels(center_frequencies.size()),
+    m_kernel(default_kernel()),
+    m_coefficients(sample_frequency, center_frequencies, bandwidths)
+{
+  for(auto* arrays : {&m_z1, &m_z2})
+    for(auto& a : *arrays) a.resize(m_coefficients.padded_size());
+
+  reset();
+}
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+nb_channels() const
+{
+  return m_channels;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+reset()
+{
+  for(auto& z : m_z1) std::fill(z.begin(), z.end(), 0.0);
+  for(auto& z : m_z2) std::fill(z.begin(), z.end(), 0.0);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::kernel_type
+gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+kernel() const
+{
+  return m_kernel;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+bool gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+set_kernel(const kernel_type& kernel)
+{
+  if(kernel != kernel_type::scalar)
+    {
+      if(default_kernel() == kernel_type::scalar || !detail::simd::supported(kernel))
+        return false;
+    }
+
+  m_kernel = kernel;
+  return true;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::kernel_type
+gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+default_kernel()
+{
+  if(!detail::simd::is_vectorizable<Scalar>::value)
+    return kernel_type::scalar;
+
+  return detail::simd::best();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::detail::slaney1993_arrays<Scalar>
+gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+arrays()
+{
+  detail::slaney1993_arrays<Scalar> s;
+  m_coefficients.view(s);
+  for(std::size_t k = 0; k < 4; ++k)
+    {
+      s.z1[k] = m_z1[k].data(); s.z2[k] = m_z2[k].data();
+    }
+  return s;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute(const Scalar& input, Scalar* output)
+{
+  compute_scalar(1, &input, output, 0, 1, 0, nb_channels());
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_ptr(const std::size_t& size, const Scalar* input, Scalar* output)
+{
+  compute_ptr(size, input, output, layout::interleaved, 0, nb_channels());
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_ptr(const std::size_t& size, const Scalar* input, Scalar* output,
+            const layout& l, const std::size_t& first, const std::size_t& last)
+{
+  compute_strided(size, input, output,
+                  detail::sample_stride(l, size, nb_channels()),
+                  detail::channel_stride(l, size, nb_channels()),
+                  first, last);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_strided(const std::size_t& size, const Scalar* input, Scalar* output,
+                const std::size_t& sample_stride, const std::size_t& channel_stride,
+                const std::size_t& first, const std::size_t& last)
+{
+  if(m_kernel != kernel_type::scalar &&
+     detail::slaney1993_dispatch(m_kernel, arrays(), size, input, output,
+                                 sample_stride, channel_stride, first, last))
+    return;
+
+  compute_scalar(size, input, output, sample_stride, channel_stride, first, last);
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::vector<Scalar> gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+state() const
+{
+  const std::size_t n = nb_channels();
+  std::vector<Scalar> s(8*n);
+  for(std::size_t k = 0; k < 4; ++k)
+    {
+      std::copy(m_z1[k].begin(), m_z1[k].begin() + n, s.begin() + 2*k*n);
+      std::copy(m_z2[k].begin(), m_z2[k].begin() + n, s.begin() + (2*k+1)*n);
+    }
+  return s;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+set_state(const std::vector<Scalar>& state)
+{
+  const std::size_t n = nb_channels();
+  for(std::size_t k = 0; k < 4; ++k)
+    {
+      std::copy(state.begin() + 2*k*n, state.begin() + (2*k+1)*n, m_z1[k].begin());
+      std::copy(state.begin() + (2*k+1)*n, state.begin() + (2*k+2)*n, m_z2[k].begin());
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::transition_type
+gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+transition(const std::size_t& n) const
+{
+  transition_type t(nb_channels());
+  for(std::size_t j = 0; j < t.size(); ++j)
+    {
+      // one step of null input from each basis state
+      detail::square_matrix<Scalar> a(8);
+      for(std::size_t e = 0; e < 8; ++e)
+        {
+          detail::slaney1993_cascade<Scalar> c = m_coefficients.cascade(j);
+          for(std::size_t k = 0; k < 4; ++k)
+            {
+              c.z1[k] = e == 2*k ? 1 : 0;
+              c.z2[k] = e == 2*k+1 ? 1 : 0;
+            }
+
+          Scalar y = 0;
+          for(std::size_t k = 0; k < 4; ++k) y = c.step(k, y);
+
+          for(std::size_t k = 0; k < 4; ++k)
+            {
+              a(2*k,e) = c.z1[k];
+              a(2*k+1,e) = c.z2[k];
+            }
+        }
+      t[j] = detail::power(a, n);
+    }
+  return t;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+propagate(const transition_type& t, std::vector<Scalar>& state) const
+{
+  // state[i*channels + j] is the i-th state of channel j
+  const std::size_t channels = nb_channels();
+  std::vector<Scalar> v(8);
+  for(std::size_t j = 0; j < channels; ++j)
+    {
+      for(std::size_t i = 0; i < 8; ++i) v[i] = state[i*channels + j];
+      v = t[j] * v;
+      for(std::size_t i = 0; i < 8; ++i) state[i*channels + j] = v[i];
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_bank<Scalar,GainPolicy,ClippingPolicy>::
+compute_scalar(const std::size_t& size, const Scalar* input, Scalar* output,
+               const std::size_t& sample_stride, const std::size_t& channel_stride,
+               const std::size_t& first, const std::size_t& last)
+{
+  detail::slaney1993_scalar(arrays(), size, input, output, sample_stride, channel_stride, first, last);
+}
+
+#endif // GAMMATONE_CORE_SLANEY1993_BANK_HPP
@@ -0,0 +1,158 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_CORE_SLANEY1993_COEFFICIENTS_HPP
+#define GAMMATONE_CORE_SLANEY1993_COEFFICIENTS_HPP
+
+#include <gammatone/core/slaney1993.hpp>
+#include <gammatone/detail/simd.hpp>
+#include <gammatone/detail/slaney1993_simd.hpp>
+#include <array>
+#include <vector>
+
+namespace gammatone
+{
+  namespace core
+  {
+    //! Structure-of-arrays coefficients of several core::slaney1993 channels
+    /*!
+      \class slaney1993_coefficients
+
+      As core::cooke1993_coefficients, shared by
+      core::slaney1993_bank and core::slaney1993_design. Padding
+      channels have null coefficients and a unit gain.
+
+      \tparam Scalar         Type of scalar values
+      \tparam GainPolicy     Policy for gain computation, see policy::gain .
+      \tparam ClippingPolicy Policy for clipping small values, see policy::clipping .
+    */
+    template<class Scalar, class GainPolicy, class ClippingPolicy>
+    class slaney1993_coefficients
+    {
+    public:
+      //! Type of the per-channel arrays, aligned for SIMD kernels
+      using array_type = std::vector<Scalar, detail::simd::aligned_allocator<Scalar> >;
+
+      //! Type of the equivalent single channel core
+      using core_type = slaney1993<Scalar,GainPolicy,ClippingPolicy>;
+
+      //! Computes the coefficients of each channel
+      slaney1993_coefficients(const Scalar& sample_frequency,
+                              const std::vector<Scalar>& center_frequencies,
+                              const std::vector<Scalar>& bandwidths);
+
+      //! The number of channels
+      inline std::size_t nb_channels() const;
+
+      //! The padded size of the arrays
+      inline std::size_t padded_size() const;
+
+      //! The cascade of channel j, with null states
+      inline detail::slaney1993_cascade<Scalar> cascade(const std::size_t& j) const;
+
+      //! Point the coefficients of a kernel view on our arrays
+      inline void view(detail::slaney1993_arrays<Scalar>& s) const;
+
+    private:
+      std::size_t m_channels;
+
+      //! Input gain of each channel
+      array_type m_gain;
+
+      //! Coefficients of each stage, see core::slaney1993_iir
+      std::array<array_type,4> m_a0, m_a1, m_a2, m_b1, m_b2;
+    };
+  }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::slaney1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+slaney1993_coefficients(const Scalar& sample_frequency,
+                        const std::vector<Scalar>& center_frequencies,
+                        const std::vector<Scalar>& bandwidths)
+  : m_channels(center_frequencies.size())
+{
+  const std::size_t size = detail::simd::padded_size<Scalar>(m_channels);
+
+  m_gain.resize(size, 1.0);
+  for(auto* arrays : {&m_a0, &m_a1, &m_a2, &m_b1, &m_b2})
+    for(auto& a : *arrays) a.resize(size);
+
+  for(std::size_t j = 0; j < m_channels; ++j)
+    {
+      const auto c = core_type(sample_frequency, center_frequencies[j], bandwidths[j]).cascade();
+
+      m_gain[j] = c.gain;
+      for(std::size_t k = 0; k < 4; ++k)
+        {
+          m_a0[k][j] = c.a0[k]; m_a1[k][j] = c.a1[k]; m_a2[k][j] = c.a2[k];
+          m_b1[k][j] = c.b1[k]; m_b2[k][j] = c.b2[k];
+        }
+    }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::slaney1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+nb_channels() const
+{
+  return m_channels;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::slaney1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+padded_size() const
+{
+  return m_gain.size();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::detail::slaney1993_cascade<Scalar>
+gammatone::core::slaney1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+cascade(const std::size_t& j) const
+{
+  detail::slaney1993_cascade<Scalar> c;
+  c.gain = m_gain[j];
+  for(std::size_t k = 0; k < 4; ++k)
+    {
+      c.a0[k] = m_a0[k][j]; c.a1[k] = m_a1[k][j]; c.a2[k] = m_a2[k][j];
+      c.b1[k] = m_b1[k][j]; c.b2[k] = m_b2[k][j];
+      c.z1[k] = 0; c.z2[k] = 0;
+    }
+  return c;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_coefficients<Scalar,GainPolicy,ClippingPolicy>::
+view(detail::slaney1993_arrays<Scalar>& s) const
+{
+  s.channels = m_channels;
+  s.gain = m_gain.data();
+  for(std::size_t k = 0; k < 4; ++k)
+    {
+      s.a0[k] = m_a0[k].data(); s.a1[k] = m_a1[k].data(); s.a2[k] = m_a2[k].data();
+      s.b1[k] = m_b1[k].data(); s.b2[k] = m_b2[k].data();
+    }
+}
+
+#endif // GAMMATONE_CORE_SLANEY1993_COEFFICIENTS_HPP
@@ -0,0 +1,266 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_CORE_SLANEY1993_DESIGN_HPP
+#define GAMMATONE_CORE_SLANEY1993_DESIGN_HPP
+
+#include <gammatone/core/slaney1993.hpp>
+#include <gammatone/core/slaney1993_coefficients.hpp>
+#include <gammatone/policy/gain.hpp>
+#include <gammatone/policy/clipping.hpp>
+#include <gammatone/detail/simd.hpp>
+#include <gammatone/detail/slaney1993_simd.hpp>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace gammatone
+{
+  namespace core
+  {
+    //! Coefficients of a core::slaney1993_bank, apart from its state
+    /*!
+      \class slaney1993_design
+
+      As core::cooke1993_design for core::slaney1993_bank: the
+      design holds the coefficients of the biquads, a state_type
+      only holds their states \f$ z_1 \f$ and \f$ z_2 \f$. Results
+      are identical to those of the bank.
+
+      \tparam Scalar         Type of scalar values
+      \tparam GainPolicy     Policy for gain computation, see policy::gain .
+      \tparam ClippingPolicy Unused, as in core::slaney1993 .
+    */
+    template
+    <
+      class Scalar,
+      class GainPolicy = policy::gain::forall_0dB,
+      class ClippingPolicy = policy::clipping::off
+      >
+    class slaney1993_design
+    {
+      //! Type of the per-channel arrays, aligned for SIMD kernels
+      using array_type = std::vector<Scalar, detail::simd::aligned_allocator<Scalar> >;
+
+      //! Type of the per-stage arrays
+      using stage_arrays = std::array<array_type,4>;
+
+    public:
+      //! Type of the scalars
+      using scalar_type = Scalar;
+
+      //! Type of the equivalent single channel core
+      using core_type = slaney1993<Scalar,GainPolicy,ClippingPolicy>;
+
+      //! Type of the instruction sets for which kernels are available
+      using kernel_type = detail::simd::isa;
+
+      //! States of the biquads of all the channels of a design
+      class state_type
+      {
+      public:
+        //! The number of channels
+        inline std::size_t nb_channels() const{
+          return m_channels;
+        }
+
+        //! Set all the channels at their initial state
+        inline void reset(){
+          for(auto& z : m_z1) std::fill(z.begin(), z.end(), 0.0);
+          for(auto& z : m_z2) std::fill(z.begin(), z.end(), 0.0);
+        }
+
+      private:
+        friend class slaney1993_design;
+
+        //! Number of channels, arrays below are padded beyond it
+        std::size_t m_channels;
+
+        //! States of each stage
+        stage_arrays m_z1, m_z2;
+      };
+
+      //! Creates a design from explicit parameters, see slaney1993_bank::slaney1993_bank()
+      slaney1993_design(const Scalar& sample_frequency,
+                        const std::vector<Scalar>& center_frequencies,
+                        const std::vector<Scalar>& bandwidths);
+
+      //! The number of channels in the design
+      inline std::size_t nb_channels() const;
+
+      //! The kernel used by compute_strided()
+      inline kernel_type kernel() const;
+
+      //! Force the kernel used by compute_strided(), see cooke1993_bank::set_kernel()
+      inline bool set_kernel(const kernel_type& kernel);
+
+      //! The widest kernel available on the running CPU
+      static inline kernel_type default_kernel();
+
+      //! A new state of the design, at its initial value
+      inline state_type make_state() const;
+
+      //! Compute all the channels from a given state, see cooke1993_design::compute_strided()
+      inline void compute_strided(state_type& state,
+                                  const std::size_t& size,
+                                  const Scalar* input,
+                                  Scalar* output,
+                                  const std::size_t& sample_stride,
+                                  const std::size_t& channel_stride) const;
+
+      //! Compute a slice of channels from a given state, see cooke1993_design::compute_strided()
+      inline void compute_strided(state_type& state,
+                                  const std::size_t& size,
+                                  const Scalar* input,
+                                  Scalar* output,
+                                  const std::size_t& sample_stride,
+                                  const std::size_t& channel_stride,
+                                  const std::size_t& first,
+                                  const std::size_t& last) const;
+
+      //! Granularity of channel slices, see compute_strided()
+      static constexpr std::size_t alignment(){
+        return detail::simd::max_lanes<Scalar>();
+      }
+
+    private:
+
+      //! Raw view on the coefficients and the arrays of a state for the kernels
+      inline detail::slaney1993_arrays<Scalar> arrays(state_type& state) const;
+
+      //! Filter coefficients
+      slaney1993_coefficients<Scalar,GainPolicy,ClippingPolicy> m_coefficients;
+
+      //! Kernel used in compute_strided()
+      kernel_type m_kernel;
+    };
+  }
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::
+slaney1993_design(const Scalar& sample_frequency,
+                  const std::vector<Scalar>& center_frequencies,
+                  const std::vector<Scalar>& bandwidths)
+  : m_coefficients(sample_frequency, center_frequencies, bandwidths),
+    m_kernel(default_kernel())
+{}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+std::size_t gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::
+nb_channels() const
+{
+  return m_coefficients.nb_channels();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::kernel_type
+gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::
+kernel() const
+{
+  return m_kernel;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+bool gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::
+set_kernel(const kernel_type& kernel)
+{
+  if(kernel != kernel_type::scalar)
+    {
+      if(default_kernel() == kernel_type::scalar || !detail::simd::supported(kernel))
+        return false;
+    }
+
+  m_kernel = kernel;
+  return true;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::kernel_type
+gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::
+default_kernel()
+{
+  if(!detail::simd::is_vectorizable<Scalar>::value)
+    return kernel_type::scalar;
+
+  return detail::simd::best();
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+typename gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::state_type
+gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::
+make_state() const
+{
+  state_type state;
+  state.m_channels = m_coefficients.nb_channels();
+  for(auto& z : state.m_z1) z.resize(m_coefficients.padded_size());
+  for(auto& z : state.m_z2) z.resize(m_coefficients.padded_size());
+  state.reset();
+  return state;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+gammatone::detail::slaney1993_arrays<Scalar>
+gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::
+arrays(state_type& state) const
+{
+  detail::slaney1993_arrays<Scalar> s;
+  m_coefficients.view(s);
+  for(std::size_t k = 0; k < 4; ++k)
+    {
+      s.z1[k] = state.m_z1[k].data(); s.z2[k] = state.m_z2[k].data();
+    }
+  return s;
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::
+compute_strided(state_type& state, const std::size_t& size, const Scalar* input, Scalar* output,
+                const std::size_t& sample_stride, const std::size_t& channel_stride) const
+{
+  compute_strided(state, size, input, output, sample_stride, channel_stride,
+                  0, m_coefficients.nb_channels());
+}
+
+
+template<class Scalar, class GainPolicy, class ClippingPolicy>
+void gammatone::core::slaney1993_design<Scalar,GainPolicy,ClippingPolicy>::
+compute_strided(state_type& state, const std::size_t& size, const Scalar* input, Scalar* output,
+                const std::size_t& sample_stride, const std::size_t& channel_stride,
+                const std::size_t& first, const std::size_t& last) const
+{
+  const detail::slaney1993_arrays<Scalar> s = arrays(state);
+
+  if(m_kernel != kernel_type::scalar &&
+     detail::slaney1993_dispatch(m_kernel, s, size, input, output,
+                                 sample_stride, channel_stride, first, last))
+    return;
+
+  detail::slaney1993_scalar(s, size, input, output, sample_stride, channel_stride, first, last);
+}
+
+#endif // GAMMATONE_CORE_SLANEY1993_DESIGN_HPP
@@ -23,6 +23,7 @@
 
 #include <utility>
 #include <array>
+#include <cstddef>
 
 namespace gammatone
 {
@@ -47,7 +48,24 @@ namespace gammatone
       inline Scalar compute(const Scalar& input);
       inline Scalar compute(const Scalar& input, const Scalar& gain);
 
+      //! The filter state \f$ (z_1, z_2) \f$
+      inline std::array<Scalar,2> state() const;
+
+      //! Set the filter state
+      inline void set_state(const std::array<Scalar,2>& state);
+
+      //! Compute a block of samples, output may be equal to input
+      inline void compute_block(const Scalar* input, Scalar* output, const std::size_t& size);
+
+      //! Compute a block of samples divided by gain
+      inline void compute_block(const Scalar* input, Scalar* output, const std::size_t& size,
+                                const Scalar& gain);
+
     private:
+      // The cascade and multi-channel kernels reuse our coefficients
+      template<class, class, class> friend class slaney1993;
+      template<class, class, class> friend class slaney1993_bank;
+
       std::array<Scalar,3> m_a;
       std::array<Scalar,3> m_b;
 
@@ -123,6 +141,21 @@ reset()
   m_z1 = m_z2 = 0.0;
 }
 
+template<class Scalar>
+std::array<Scalar,2> gammatone::core::slaney1993_iir<Scalar>::
+state() const
+{
+  return {{m_z1, m_z2}};
+}
+
+template<class Scalar>
+void gammatone::core::slaney1993_iir<Scalar>::
+set_state(const std::array<Scalar,2>& state)
+{
+  m_z1 = state[0];
+  m_z2 = state[1];
+}
+
 template<class Scalar>
 Scalar gammatone::core::slaney1993_iir<Scalar>::
 compute(const Scalar& input)
@@ -140,4 +173,44 @@ compute(const Scalar& input, const Scalar& gain)
   return compute(input/gain);
 }
 
+template<class Scalar>
+void gammatone::core::slaney1993_iir<Scalar>::
+compute_block(const Scalar* input, Scalar* output, const std::size_t& size)
+{
+  const Scalar a0 = m_a[0], a1 = m_a[1], a2 = m_a[2], b1 = m_b[1], b2 = m_b[2];
+  Scalar z1 = m_z1, z2 = m_z2;
+
+  for(std::size_t i = 0; i < size; ++i)
+    {
+      const Scalar in = input[i];
+      const Scalar out = a0*in + z1;
+      z1 = a1*in - b1*out + z2;
+      z2 = a2*in - b2*out;
+      output[i] = out;
+    }
+
+  m_z1 = z1;
+  m_z2 = z2;
+}
+
+template<class Scalar>
+void gammatone::core::slaney1993_iir<Scalar>::
+compute_block(const Scalar* input, Scalar* output, const std::size_t& size, const Scalar& gain)
+{
+  const Scalar a0 = m_a[0], a1 = m_a[1], a2 = m_a[2], b1 = m_b[1], b2 = m_b[2];
+  Scalar z1 = m_z1, z2 = m_z2;
+
+  for(std::size_t i = 0; i < size; ++i)
+    {
+      const Scalar in = input[i]/gain;
+      const Scalar out = a0*in + z1;
+      z1 = a1*in - b1*out + z2;
+      z2 = a2*in - b2*out;
+      output[i] = out;
+    }
+
+  m_z1 = z1;
+  m_z2 = z2;
+}
+
 #endif // GAMMATONE_CORE_SLANEY1993_IIR_HPP
@@ -0,0 +1,313 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DESIGN_CACHE_HPP
+#define GAMMATONE_DESIGN_CACHE_HPP
+
+#include <gammatone/detail/ir_cache.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <typeinfo>
+#include <vector>
+#include <unistd.h>
+
+namespace gammatone
+{
+    //! Process-wide cache of filterbank designs
+    /*!
+      \class design_cache gammatone/design_cache.hpp
+
+      Building a design computes the center frequencies, bandwidths,
+      gains and coefficients of all its channels and, with
+      core::convolution, their impulse responses, which takes
+      seconds for large banks. The cache builds each design once per
+      process, keyed on its type (scalar, core and policies) and its
+      parameters, and shares it read-only between the callers, see
+      filterbank_design::cached(). Designs are built one at a time.
+
+      With a directory set, the impulse responses requested while
+      building a design are saved in a file of that directory, named
+      after the key of the design, and loaded back by the next
+      processes building it, so that they are not computed again.
+      Files are in a native binary format of version
+      format_version. A file of another version, scalar size or byte
+      order, or not matching the key, is ignored and rewritten.
+    */
+    class design_cache
+    {
+    public:
+        //! Version of the format of the files in the directory
+        static constexpr std::uint32_t format_version = 1;
+
+        //! The design of given parameters, built once per process
+        /*!
+          \tparam Design  A filterbank_design type.
+          \return A design constructed from the given parameters, see
+          filterbank_design::filterbank_design().
+        */
+        template<class Design>
+        static std::shared_ptr<const Design> get(
+            const typename Design::scalar_type& sample_frequency,
+            const typename Design::scalar_type& low_frequency,
+            const typename Design::scalar_type& high_frequency,
+            const typename Design::channels::param_type& channels_parameter){
+            using scalar_type = typename Design::scalar_type;
+            using irs = detail::ir_cache<scalar_type>;
+
+            const std::string key = make_key<Design>(
+                sample_frequency, low_frequency, high_frequency, channels_parameter);
+
+            std::lock_guard<std::mutex> lock(mutex());
+            const auto it = designs().find(key);
+            if(it != designs().end())
+                return std::static_pointer_cast<const Design>(it->second);
+
+            // impulse responses saved by a previous process
+            const std::string path = directory_path().empty() ? "" :
+                directory_path() + "/" + file_name(key);
+            const bool loaded = ! path.empty() && load<scalar_type>(path, key);
+
+            // record the impulse responses computed by the design
+            std::vector<typename irs::key_type> requested;
+            std::shared_ptr<const Design> design;
+            {
+                const recording<scalar_type> guard(requested);
+                design = std::make_shared<Design>(
+                    sample_frequency, low_frequency, high_frequency, channels_parameter);
+            }
+
+            if(! path.empty() && ! loaded && ! requested.empty())
+                save<scalar_type>(path, key, requested);
+
+            designs()[key] = design;
+            return design;
+        }
+
+        //! Set the directory of the files, empty to disable them (the default)
+        /*!
+          The directory must exist. Failures to read or write files
+          are not errors, the designs being then computed.
+        */
+        static void set_directory(const std::string& directory){
+            std::lock_guard<std::mutex> lock(mutex());
+            directory_path() = directory;
+        }
+
+        //! The directory of the files, empty if disabled
+        static std::string directory(){
+            std::lock_guard<std::mutex> lock(mutex());
+            return directory_path();
+        }
+
+        //! Forget the designs and impulse responses in memory
+        /*!
+          The impulse responses of the float, double and long double
+          scalar types are forgotten. The designs already returned by
+          get() remain valid.
+        */
+        static void clear(){
+            std::lock_guard<std::mutex> lock(mutex());
+            designs().clear();
+            detail::ir_cache<float>::clear();
+            detail::ir_cache<double>::clear();
+            detail::ir_cache<long double>::clear();
+        }
+
+        //! Number of designs in memory
+        static std::size_t size(){
+            std::lock_guard<std::mutex> lock(mutex());
+            return designs().size();
+        }
+
+        //! Name of the file of a design key in the directory
+        static std::string file_name(const std::string& key){
+            // 64 bits FNV-1a hash, stable across processes
+            std::uint64_t hash = 14695981039346656037ull;
+            for(const char& c : key)
+            {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
+            }
+
+            std::ostringstream name;
+            name << "gammatone-" << std::hex << std::setw(16) << std::setfill('0')
+                 << hash << ".design";
+            return name.str();
+        }
+
+        //! Key of a design of given parameters
+        template<class Design>
+        static std::string make_key(const typename Design::scalar_type& sample_frequency,
+                                    const typename Design::scalar_type& low_frequency,
+                                    const typename Design::scalar_type& high_frequency,
+                                    const typename Design::channels::param_type& channels_parameter){
+            std::ostringstream key;
+            key << typeid(Design).name()
+                << std::setprecision(std::numeric_limits<long double>::max_digits10)
+                << ' ' << sample_frequency << ' ' << low_frequency
+                << ' ' << high_frequency << ' ' << channels_parameter;
+            return key.str();
+        }
+
+    private:
+        //! Header of the files, followed by the version
+        static const char* magic(){
+            return "GTDESIGN";
+        }
+
+        //! Written as a native integer to check the byte order
+        static constexpr std::uint32_t byte_order = 0x01020304;
+
+        //! Record the requests of the calling thread to the impulse responses cache during its lifetime
+        template<class Scalar>
+        struct recording
+        {
+            explicit recording(std::vector<typename detail::ir_cache<Scalar>::key_type>& keys){
+                detail::ir_cache<Scalar>::record(&keys);
+            }
+
+            ~recording(){
+                detail::ir_cache<Scalar>::record(nullptr);
+            }
+        };
+
+        template<class T>
+        static void write(std::ostream& out, const T* data, const std::size_t& n = 1){
+            out.write(reinterpret_cast<const char*>(data), n*sizeof(T));
+        }
+
+        template<class T>
+        static bool read(std::istream& in, T* data, const std::size_t& n = 1){
+            in.read(reinterpret_cast<char*>(data), n*sizeof(T));
+            return static_cast<bool>(in);
+        }
+
+        //! Save the impulse responses of given keys in a file
+        /*!
+          The file is written aside, in a temporary file named after
+          the process id, and renamed, so that concurrent processes
+          neither read a partial file nor write the same temporary
+          one. Saves of a process are serialized by get().
+        */
+        template<class Scalar>
+        static bool save(const std::string& path,
+                         const std::string& key,
+                         const std::vector<typename detail::ir_cache<Scalar>::key_type>& keys){
+            const std::string temporary = path + "." + std::to_string(::getpid()) + ".tmp";
+            {
+                std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+                if(! out) return false;
+
+                const std::uint32_t header[3] = {format_version, byte_order, sizeof(Scalar)};
+                const std::uint64_t key_size = key.size(), count = keys.size();
+                out.write(magic(), 8);
+                write(out, header, 3);
+                write(out, &key_size);
+                out.write(key.data(), key.size());
+                write(out, &count);
+
+                typename detail::ir_cache<Scalar>::ir_type ir;
+                for(const auto& k : keys)
+                {
+                    if(! detail::ir_cache<Scalar>::find(k, ir)) ir.clear();
+                    const std::uint64_t size = ir.size();
+                    write(out, k.data(), k.size());
+                    write(out, &size);
+                    write(out, ir.data(), ir.size());
+                }
+
+                if(! out)
+                {
+                    out.close();
+                    std::remove(temporary.c_str());
+                    return false;
+                }
+            }
+            return std::rename(temporary.c_str(), path.c_str()) == 0;
+        }
+
+        //! Load the impulse responses of a file in the cache, false if invalid
+        template<class Scalar>
+        static bool load(const std::string& path, const std::string& key){
+            std::ifstream in(path, std::ios::binary | std::ios::ate);
+            if(! in) return false;
+            const std::uint64_t file_size = in.tellg();
+            in.seekg(0);
+
+            char m[8];
+            std::uint32_t header[3];
+            std::uint64_t key_size, count;
+            if(! read(in, m, 8) || std::string(m, 8) != magic() ||
+               ! read(in, header, 3) || header[0] != format_version ||
+               header[1] != byte_order || header[2] != sizeof(Scalar) ||
+               ! read(in, &key_size) || key_size != key.size())
+                return false;
+
+            std::string k(key_size, '\0');
+            if(! read(in, &k[0], key_size) || k != key || ! read(in, &count) ||
+               count > file_size / sizeof(std::uint64_t))
+                return false;
+
+            // all the entries are read before insertion in the cache
+            using irs = detail::ir_cache<Scalar>;
+            std::vector<std::pair<typename irs::key_type, typename irs::ir_type> > entries(count);
+            for(auto& e : entries)
+            {
+                std::uint64_t size;
+                if(! read(in, e.first.data(), e.first.size()) || ! read(in, &size) ||
+                   size > file_size / sizeof(Scalar))
+                    return false;
+
+                e.second.resize(size);
+                if(! read(in, e.second.data(), size))
+                    return false;
+            }
+
+            for(const auto& e : entries)
+                if(! e.second.empty()) irs::insert(e.first, e.second);
+            return true;
+        }
+
+        static std::mutex& mutex(){
+            static std::mutex m;
+            return m;
+        }
+
+        static std::map<std::string, std::shared_ptr<const void> >& designs(){
+            static std::map<std::string, std::shared_ptr<const void> > d;
+            return d;
+        }
+
+        static std::string& directory_path(){
+            static std::string d;
+            return d;
+        }
+    };
+}
+
+#endif // GAMMATONE_DESIGN_CACHE_HPP
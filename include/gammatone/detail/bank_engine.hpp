@@ -0,0 +1,412 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_BANK_ENGINE_HPP
+#define GAMMATONE_DETAIL_BANK_ENGINE_HPP
+
+#include <gammatone/core/convolution.hpp>
+#include <gammatone/core/convolution_bank.hpp>
+#include <gammatone/core/cooke1993.hpp>
+#include <gammatone/core/cooke1993_bank.hpp>
+#include <gammatone/core/slaney1993.hpp>
+#include <gammatone/core/slaney1993_bank.hpp>
+#include <gammatone/detail/thread_pool.hpp>
+#include <gammatone/detail/time_parallel.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Processing engine of a filterbank
+        /*!
+          \class bank_engine gammatone/detail/bank_engine.hpp
+
+          A filterbank delegates the processing of its channels to a
+          bank engine. This generic engine simply holds a copy of each
+          filter and computes them one after the other, block by block
+          on whole inputs in compute_ptr(). Specializations
+          of this class for a given core provide dedicated multi-channel
+          implementations.
+
+          \tparam Filter  Type of the filters in the bank.
+          \tparam Core    Type of the filters core, used for specialization.
+        */
+        template<class Filter, class Core = typename Filter::core>
+        class bank_engine
+        {
+        public:
+            //! Type of the scalars
+            using scalar_type = typename Filter::scalar_type;
+
+            //! Creates an engine from an array of filters
+            explicit bank_engine(const std::vector<Filter>& filters)
+                : m_filters(filters)
+                {}
+
+            //! The number of channels in the engine
+            std::size_t nb_channels() const{
+                return m_filters.size();
+            }
+
+            //! Restore the initial state of all channels
+            void reset(){
+                std::for_each(m_filters.begin(), m_filters.end(),
+                              [](Filter& f){f.reset();});
+            }
+
+            //! Compute one output per channel from a scalar input
+            inline void compute(const scalar_type& input, scalar_type* output){
+                for(std::size_t j=0; j<nb_channels(); ++j){
+                    m_filters[j].compute(input, output[j]);
+                }
+            }
+
+            //! Compute interleaved outputs from pointers, see filterbank::compute_ptr
+            inline void compute_ptr(const std::size_t& size,
+                                    const scalar_type* input,
+                                    scalar_type* output){
+                compute_ptr(size, input, output, nb_channels(), 1, 0, nb_channels());
+            }
+
+            //! Compute the channels in [first, last) from pointers
+            /*!
+              The output of channel j at sample i is stored in
+              output[i*sample_stride + j*channel_stride]. Concurrent
+              calls on disjoint slices are safe.
+            */
+            inline void compute_ptr(const std::size_t& size,
+                                    const scalar_type* input,
+                                    scalar_type* output,
+                                    const std::size_t& sample_stride,
+                                    const std::size_t& channel_stride,
+                                    const std::size_t& first,
+                                    const std::size_t& last){
+                process(first, last, size, output, sample_stride, channel_stride,
+                        [&](Filter& f, scalar_type* out){f.compute_ptr(size, input, out);});
+            }
+
+            //! Update the state shared by the channels after a slice-wise compute_ptr()
+            /*!
+              To be called once all the slices of an input are
+              computed. The channels share nothing here.
+            */
+            inline void advance(const std::size_t&, const scalar_type*){}
+
+            //! Exact time-parallel processing, see filter::compute_ptr_chunked
+            /*!
+              Channels are processed one after the other, each one
+              being split in time chunks.
+            */
+            inline void compute_chunked(const std::size_t& size,
+                                        const scalar_type* input,
+                                        scalar_type* output,
+                                        const std::size_t& sample_stride,
+                                        const std::size_t& channel_stride,
+                                        const std::size_t& nb_chunks){
+                process(0, nb_channels(), size, output, sample_stride, channel_stride,
+                        [&](Filter& f, scalar_type* out){
+                            f.compute_ptr_chunked(size, input, out, nb_chunks);});
+            }
+
+            //! Approximate time-parallel processing, see filter::compute_ptr_overlapped
+            /*!
+              Channels are processed one after the other, each one
+              with its own warm-up length.
+            */
+            inline void compute_overlapped(const std::size_t& size,
+                                           const scalar_type* input,
+                                           scalar_type* output,
+                                           const std::size_t& sample_stride,
+                                           const std::size_t& channel_stride,
+                                           const scalar_type& attenuation,
+                                           const std::size_t& nb_chunks){
+                process(0, nb_channels(), size, output, sample_stride, channel_stride,
+                        [&](Filter& f, scalar_type* out){
+                            f.compute_ptr_overlapped(size, input, out, attenuation, nb_chunks);});
+            }
+
+            //! Granularity of channel slices in compute_ptr()
+            static constexpr std::size_t alignment(){
+                return 1;
+            }
+
+        private:
+            //! Apply f(filter, out) on channels in [first, last)
+            /*!
+              f computes the *size* outputs of a filter contiguously in
+              out, which are then written with the given strides.
+            */
+            template<class Function>
+            inline void process(const std::size_t& first,
+                                const std::size_t& last,
+                                const std::size_t& size,
+                                scalar_type* output,
+                                const std::size_t& sample_stride,
+                                const std::size_t& channel_stride,
+                                const Function& f){
+                if(sample_stride == 1){
+                    for(std::size_t j=first; j<last; ++j){
+                        f(m_filters[j], output + j*channel_stride);
+                    }
+                    return;
+                }
+
+                std::vector<scalar_type> buffer(size);
+                for(std::size_t j=first; j<last; ++j){
+                    f(m_filters[j], buffer.data());
+                    for(std::size_t i=0; i<size; ++i){
+                        output[i*sample_stride + j*channel_stride] = buffer[i];
+                    }
+                }
+            }
+
+            //! The processed filters
+            std::vector<Filter> m_filters;
+        };
+
+
+        //! Bank engine on a multi-channel core
+        /*!
+          Base of the bank_engine specializations for the cores having
+          a multi-channel implementation, storing coefficients and
+          states in contiguous per-field arrays.
+
+          \tparam Filter  Type of the filters in the bank.
+          \tparam Bank    Type of the multi-channel core.
+        */
+        template<class Filter, class Bank>
+        class multichannel_engine
+        {
+        public:
+            //! Type of the scalars
+            using scalar_type = typename Filter::scalar_type;
+
+            //! Type of the underlying multi-channel core
+            using core_type = Bank;
+
+            //! Creates an engine from an array of filters
+            explicit multichannel_engine(const std::vector<Filter>& filters)
+                : m_core(make_core(filters)),
+                  m_narrowest(narrowest(filters))
+                {}
+
+            std::size_t nb_channels() const{
+                return m_core.nb_channels();
+            }
+
+            void reset(){
+                m_core.reset();
+            }
+
+            inline void compute(const scalar_type& input, scalar_type* output){
+                m_core.compute(input, output);
+            }
+
+            inline void compute_ptr(const std::size_t& size,
+                                    const scalar_type* input,
+                                    scalar_type* output){
+                m_core.compute_ptr(size, input, output);
+            }
+
+            inline void compute_ptr(const std::size_t& size,
+                                    const scalar_type* input,
+                                    scalar_type* output,
+                                    const std::size_t& sample_stride,
+                                    const std::size_t& channel_stride,
+                                    const std::size_t& first,
+                                    const std::size_t& last){
+                m_core.compute_strided(size, input, output, sample_stride, channel_stride,
+                                       first, last);
+            }
+
+            inline void advance(const std::size_t&, const scalar_type*){}
+
+            //! Exact time-parallel processing of all channels at once
+            inline void compute_chunked(const std::size_t& size,
+                                        const scalar_type* input,
+                                        scalar_type* output,
+                                        const std::size_t& sample_stride,
+                                        const std::size_t& channel_stride,
+                                        const std::size_t& nb_chunks){
+                const std::size_t channels = nb_channels();
+                detail::compute_chunked(
+                    m_core, size, nb_chunks, thread_pool::global(),
+                    [&](core_type& c, const std::size_t& first, const std::size_t& count){
+                        c.compute_strided(count, input + first, output + first*sample_stride,
+                                          sample_stride, channel_stride, 0, channels);
+                    });
+            }
+
+            //! Approximate time-parallel processing of all channels at once
+            /*!
+              The warm-up length is the one of the narrowest channel,
+              which has the longest impulse response.
+            */
+            inline void compute_overlapped(const std::size_t& size,
+                                           const scalar_type* input,
+                                           scalar_type* output,
+                                           const std::size_t& sample_stride,
+                                           const std::size_t& channel_stride,
+                                           const scalar_type& attenuation,
+                                           const std::size_t& nb_chunks){
+                const std::size_t channels = nb_channels();
+                detail::compute_overlapped(
+                    m_core, size, nb_chunks, warmup(attenuation), thread_pool::global(),
+                    [&](core_type& c, const std::size_t& first, const std::size_t& count){
+                        c.compute_strided(count, input + first, output + first*sample_stride,
+                                          sample_stride, channel_stride, 0, channels);
+                    },
+                    [&](core_type& c, const std::size_t& first, const std::size_t& count){
+                        std::vector<scalar_type> buffer(count*channels);
+                        c.compute_ptr(count, input + first, buffer.data());
+                    });
+            }
+
+            static constexpr std::size_t alignment(){
+                return core_type::alignment();
+            }
+
+            //! Access to the multi-channel core
+            core_type& core(){
+                return m_core;
+            }
+
+            //! Const access to the multi-channel core
+            const core_type& core() const{
+                return m_core;
+            }
+
+        protected:
+            //! Duration of the warm-up for a given attenuation
+            std::size_t warmup(const scalar_type& attenuation) const{
+                return nb_channels() ? m_narrowest.decay_length(attenuation) : 0;
+            }
+
+            //! The multi-channel core
+            core_type m_core;
+
+        private:
+            static core_type make_core(const std::vector<Filter>& filters){
+                std::vector<scalar_type> cf(filters.size()), bw(filters.size());
+                std::transform(filters.begin(), filters.end(), cf.begin(),
+                               [](const Filter& f){return f.center_frequency();});
+                std::transform(filters.begin(), filters.end(), bw.begin(),
+                               [](const Filter& f){return f.bandwidth();});
+
+                const scalar_type fs = filters.empty() ? scalar_type(0) : filters.front().sample_frequency();
+                return core_type(fs, cf, bw);
+            }
+
+            static Filter narrowest(const std::vector<Filter>& filters){
+                if(filters.empty()) return Filter(1, 0);
+                return *std::min_element(filters.begin(), filters.end(),
+                                         [](const Filter& a, const Filter& b){
+                                             return a.bandwidth() < b.bandwidth();});
+            }
+
+            //! The channel with the smallest bandwidth
+            Filter m_narrowest;
+        };
+
+
+        //! Bank engine specialization for core::cooke1993
+        /*!
+          Channels are computed by a core::cooke1993_bank.
+        */
+        template<class Filter, class Scalar, class GainPolicy, class ClippingPolicy>
+        class bank_engine<Filter, core::cooke1993<Scalar, GainPolicy, ClippingPolicy> >
+            : public multichannel_engine<
+            Filter, core::cooke1993_bank<Scalar, GainPolicy, ClippingPolicy> >
+        {
+        public:
+            using multichannel_engine<
+                Filter, core::cooke1993_bank<Scalar, GainPolicy, ClippingPolicy> >::multichannel_engine;
+        };
+
+
+        //! Bank engine specialization for core::slaney1993
+        /*!
+          Channels are computed by a core::slaney1993_bank, running
+          the cascades of several channels side by side.
+        */
+        template<class Filter, class Scalar, class GainPolicy, class ClippingPolicy>
+        class bank_engine<Filter, core::slaney1993<Scalar, GainPolicy, ClippingPolicy> >
+            : public multichannel_engine<
+            Filter, core::slaney1993_bank<Scalar, GainPolicy, ClippingPolicy> >
+        {
+        public:
+            using multichannel_engine<
+                Filter, core::slaney1993_bank<Scalar, GainPolicy, ClippingPolicy> >::multichannel_engine;
+        };
+
+
+        //! Bank engine specialization for core::convolution
+        /*!
+          Channels are computed by a core::convolution_bank, sharing
+          a single input history. Slices of channels computed by
+          compute_ptr() leave that history unchanged, it is updated
+          by advance(). Exact time-parallel processing is not
+          available.
+        */
+        template<class Filter, class Scalar, class GainPolicy, class ClippingPolicy>
+        class bank_engine<Filter, core::convolution<Scalar, GainPolicy, ClippingPolicy> >
+            : public multichannel_engine<
+            Filter, core::convolution_bank<Scalar, GainPolicy, ClippingPolicy> >
+        {
+            using base = multichannel_engine<
+                Filter, core::convolution_bank<Scalar, GainPolicy, ClippingPolicy> >;
+
+        public:
+            using scalar_type = typename base::scalar_type;
+            using core_type = typename base::core_type;
+
+            using base::base;
+
+            inline void advance(const std::size_t& size, const scalar_type* input){
+                this->m_core.advance(size, input);
+            }
+
+            //! As multichannel_engine::compute_overlapped, advancing the history of each chunk
+            inline void compute_overlapped(const std::size_t& size,
+                                           const scalar_type* input,
+                                           scalar_type* output,
+                                           const std::size_t& sample_stride,
+                                           const std::size_t& channel_stride,
+                                           const scalar_type& attenuation,
+                                           const std::size_t& nb_chunks){
+                const std::size_t channels = this->nb_channels();
+                detail::compute_overlapped(
+                    this->m_core, size, nb_chunks, this->warmup(attenuation), thread_pool::global(),
+                    [&](core_type& c, const std::size_t& first, const std::size_t& count){
+                        c.compute_strided(count, input + first, output + first*sample_stride,
+                                          sample_stride, channel_stride, 0, channels);
+                        c.advance(count, input + first);
+                    },
+                    [&](core_type& c, const std::size_t& first, const std::size_t& count){
+                        std::vector<scalar_type> buffer(count*channels);
+                        c.compute_ptr(count, input + first, buffer.data());
+                    });
+            }
+        };
+    }
+}
+
+#endif // GAMMATONE_DETAIL_BANK_ENGINE_HPP
@@ -0,0 +1,688 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_COOKE1993_SIMD_HPP
+#define GAMMATONE_DETAIL_COOKE1993_SIMD_HPP
+
+#include <gammatone/detail/simd.hpp>
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Raw view on the arrays of a core::cooke1993_bank
+        /*!
+          All the arrays are padded to simd::padded_size(channels)
+          scalars, padding channels having null coefficients.
+        */
+        template<class Scalar>
+        struct cooke1993_arrays
+        {
+            //! Number of actual channels
+            std::size_t channels;
+
+            //! Coefficients
+            const Scalar *factor, *cre, *cim, *r;
+
+            //! Phasor state
+            Scalar *qre, *qim;
+
+            //! States of the sections 4 to 1 of the cascade
+            Scalar *v4re, *v4im, *v3re, *v3im, *v2re, *v2im, *v1re, *v1im;
+        };
+
+        //! Scalar implementation of the cooke1993 kernels
+        /*!
+          Runs the recursion of the channels in [first, last) over
+          *size* samples, output(i, j, ure, uim, qre, qim) being
+          called for each sample i and channel j with the base-band
+          output u and the phasor q. The states are clipped by
+          ClippingPolicy, as in core::cooke1993::compute().
+        */
+        template<class ClippingPolicy, class Scalar, class Output>
+        inline void cooke1993_scalar(const cooke1993_arrays<Scalar>& s,
+                                     const std::size_t& size,
+                                     const Scalar* input,
+                                     const std::size_t& first,
+                                     const std::size_t& last,
+                                     const Output& output)
+        {
+            const Scalar* cre = s.cre;
+            const Scalar* cim = s.cim;
+            const Scalar* r = s.r;
+            Scalar* qre = s.qre;
+            Scalar* qim = s.qim;
+            Scalar* v4re = s.v4re; Scalar* v4im = s.v4im;
+            Scalar* v3re = s.v3re; Scalar* v3im = s.v3im;
+            Scalar* v2re = s.v2re; Scalar* v2im = s.v2im;
+            Scalar* v1re = s.v1re; Scalar* v1im = s.v1im;
+
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                const Scalar x = input[i];
+
+                for(std::size_t j = first; j < last; ++j)
+                {
+                    // update the cascade and u, as in cooke1993::compute
+                    const Scalar p1re = v4re[j], p1im = v4im[j];
+                    const Scalar w1re = v3re[j], w1im = v3im[j];
+                    std::complex<Scalar> w;
+                    w = ClippingPolicy::clip(std::complex<Scalar>(qre[j]*x + r[j]*v1re[j], qim[j]*x + r[j]*v1im[j]));
+                    v1re[j] = w.real(); v1im[j] = w.imag();
+                    w = ClippingPolicy::clip(std::complex<Scalar>(v1re[j] + r[j]*v2re[j], v1im[j] + r[j]*v2im[j]));
+                    v2re[j] = w.real(); v2im[j] = w.imag();
+                    w = ClippingPolicy::clip(std::complex<Scalar>(v2re[j] + r[j]*v3re[j], v2im[j] + r[j]*v3im[j]));
+                    v3re[j] = w.real(); v3im[j] = w.imag();
+                    w = ClippingPolicy::clip(std::complex<Scalar>(v3re[j] + r[j]*v4re[j], v3im[j] + r[j]*v4im[j]));
+                    v4re[j] = w.real(); v4im[j] = w.imag();
+
+                    const Scalar ure = v4re[j] + (8*r[j])*p1re - (4*r[j])*w1re;
+                    const Scalar uim = v4im[j] + (8*r[j])*p1im - (4*r[j])*w1im;
+
+                    // compute result
+                    output(i, j, ure, uim, qre[j], qim[j]);
+
+                    // update q
+                    const Scalar re = cre[j]*qre[j] + cim[j]*qim[j];
+                    const Scalar im = cre[j]*qim[j] - cim[j]*qre[j];
+                    qre[j] = re;
+                    qim[j] = im;
+                }
+            }
+        }
+
+#ifdef GAMMATONE_SIMD
+GAMMATONE_SIMD_BEGIN
+        namespace simd
+        {
+            //! States of the cascade of cooke1993_arrays channels loaded in vectors of type V
+            /*!
+              Operations of step() are the same, in the same order,
+              than in core::cooke1993::compute() so the results are
+              identical to the scalar code.
+            */
+            template<class V, class Scalar>
+            struct cooke1993_cascade
+            {
+                V v4re, v4im, v3re, v3im, v2re, v2im, v1re, v1im;
+
+                //! Load the states at index j to j + lanes<V,Scalar>()
+                GAMMATONE_SIMD_INLINE cooke1993_cascade(const cooke1993_arrays<Scalar>& s, const std::size_t& j)
+                    : v4re(load<V>(s.v4re + j)), v4im(load<V>(s.v4im + j)),
+                      v3re(load<V>(s.v3re + j)), v3im(load<V>(s.v3im + j)),
+                      v2re(load<V>(s.v2re + j)), v2im(load<V>(s.v2im + j)),
+                      v1re(load<V>(s.v1re + j)), v1im(load<V>(s.v1im + j))
+                    {}
+
+                //! Load the states at index j to j + n only, the other lanes being null
+                GAMMATONE_SIMD_INLINE cooke1993_cascade(const cooke1993_arrays<Scalar>& s, const std::size_t& j,
+                                                        const std::size_t& n)
+                    : v4re(load<V>(s.v4re + j, n)), v4im(load<V>(s.v4im + j, n)),
+                      v3re(load<V>(s.v3re + j, n)), v3im(load<V>(s.v3im + j, n)),
+                      v2re(load<V>(s.v2re + j, n)), v2im(load<V>(s.v2im + j, n)),
+                      v1re(load<V>(s.v1re + j, n)), v1im(load<V>(s.v1im + j, n))
+                    {}
+
+                //! Store the states at index j to j + lanes<V,Scalar>()
+                GAMMATONE_SIMD_INLINE void store_cascade(const cooke1993_arrays<Scalar>& s, const std::size_t& j) const{
+                    store(s.v4re + j, v4re); store(s.v4im + j, v4im);
+                    store(s.v3re + j, v3re); store(s.v3im + j, v3im);
+                    store(s.v2re + j, v2re); store(s.v2im + j, v2im);
+                    store(s.v1re + j, v1re); store(s.v1im + j, v1im);
+                }
+
+                //! Store the states at index j to j + n only
+                GAMMATONE_SIMD_INLINE void store_cascade(const cooke1993_arrays<Scalar>& s, const std::size_t& j,
+                                                         const std::size_t& n) const{
+                    store(s.v4re + j, v4re, n); store(s.v4im + j, v4im, n);
+                    store(s.v3re + j, v3re, n); store(s.v3im + j, v3im, n);
+                    store(s.v2re + j, v2re, n); store(s.v2im + j, v2im, n);
+                    store(s.v1re + j, v1re, n); store(s.v1im + j, v1im, n);
+                }
+
+                //! Update the cascade with the phasor q, return the base-band output u
+                GAMMATONE_SIMD_INLINE void step(const V& x, const V& qre, const V& qim,
+                                                const V& r, const V& r4, const V& r8,
+                                                V& ure, V& uim){
+                    const V p1re = v4re, p1im = v4im, w1re = v3re, w1im = v3im;
+                    v1re = qre*x + r*v1re; v1im = qim*x + r*v1im;
+                    v2re = v1re + r*v2re;  v2im = v1im + r*v2im;
+                    v3re = v2re + r*v3re;  v3im = v2im + r*v3im;
+                    v4re = v3re + r*v4re;  v4im = v3im + r*v4im;
+
+                    ure = v4re + r8*p1re - r4*w1re;
+                    uim = v4im + r8*p1im - r4*w1im;
+                }
+            };
+
+            //! Channels of a cooke1993_arrays loaded in vectors of type V
+            template<class V, class Scalar>
+            struct cooke1993_lanes : cooke1993_cascade<V,Scalar>
+            {
+                V factor, cre, cim, r, r4, r8, qre, qim;
+
+                //! Load the channels j to j + n, the other lanes being null
+                /*!
+                  A slice may start anywhere, so that a group of lanes
+                  can end past the padded arrays: only the n channels
+                  of the group are read.
+                */
+                GAMMATONE_SIMD_INLINE cooke1993_lanes(const cooke1993_arrays<Scalar>& s, const std::size_t& j,
+                                                      const std::size_t& n)
+                    : cooke1993_cascade<V,Scalar>(s, j, n),
+                      factor(load<V>(s.factor + j, n)), cre(load<V>(s.cre + j, n)), cim(load<V>(s.cim + j, n)),
+                      r(load<V>(s.r + j, n)), r4(4*r), r8(8*r),
+                      qre(load<V>(s.qre + j, n)), qim(load<V>(s.qim + j, n))
+                    {}
+
+                //! Store the states of the channels j to j + n
+                /*!
+                  Lanes beyond n are left untouched in s, as they may
+                  belong to channels out of the computed slice.
+                */
+                GAMMATONE_SIMD_INLINE void store_state(const cooke1993_arrays<Scalar>& s, const std::size_t& j,
+                                                       const std::size_t& n) const{
+                    if(n == lanes<V,Scalar>())
+                    {
+                        store(s.qre + j, qre); store(s.qim + j, qim);
+                        this->store_cascade(s, j);
+                    }
+                    else
+                    {
+                        store(s.qre + j, qre, n); store(s.qim + j, qim, n);
+                        this->store_cascade(s, j, n);
+                    }
+                }
+
+                //! Update the cascade, return the base-band output u
+                GAMMATONE_SIMD_INLINE void step(const V& x, V& ure, V& uim){
+                    cooke1993_cascade<V,Scalar>::step(x, qre, qim, r, r4, r8, ure, uim);
+                }
+
+                //! Rotate the phasor by one sample
+                GAMMATONE_SIMD_INLINE void rotate(){
+                    const V re = cre*qre + cim*qim;
+                    const V im = cre*qim - cim*qre;
+                    qre = re;
+                    qim = im;
+                }
+            };
+
+            //! Generic cooke1993 kernel on vectors of type V
+            /*!
+              Channels in [first, last) are processed by groups of
+              lanes<V,Scalar>(), each group running over the whole
+              input with its state kept in registers. The output of
+              channel j at sample i is written at
+              output[i*sample_stride + j*channel_stride].
+            */
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE void cooke1993_kernel(const cooke1993_arrays<Scalar>& s,
+                                                         const std::size_t& size,
+                                                         const Scalar* input,
+                                                         Scalar* output,
+                                                         const std::size_t& sample_stride,
+                                                         const std::size_t& channel_stride,
+                                                         const std::size_t& first,
+                                                         const std::size_t& last)
+            {
+                const std::size_t w = lanes<V,Scalar>();
+
+                for(std::size_t j = first; j < last; j += w)
+                {
+                    const std::size_t n = std::min(w, last - j);
+                    cooke1993_lanes<V,Scalar> c(s, j, n);
+
+                    Scalar* out = output + j*channel_stride;
+                    for(std::size_t i = 0; i < size; ++i, out += sample_stride)
+                    {
+                        V ure, uim;
+                        c.step(broadcast<V>(input[i]), ure, uim);
+
+                        const V y = c.factor * (ure*c.qre + uim*c.qim);
+                        if(channel_stride != 1) scatter(out, y, n, channel_stride);
+                        else if(n == w) store(out, y);
+                        else store(out, y, n);
+
+                        c.rotate();
+                    }
+
+                    c.store_state(s, j, n);
+                }
+            }
+
+            //! Generic cooke1993 base-band kernel on vectors of type V
+            /*!
+              As cooke1993_kernel, storing the real and imaginary parts
+              of the base-band output u of channel j at sample i in
+              ure[i*stride + j] and uim[i*stride + j], for every channel
+              of the groups of lanes covering [first, last). If
+              Analytic is true, the analytic output factor * u conj(q)
+              is stored instead, its real part being the output of
+              cooke1993_kernel.
+            */
+            template<class V, bool Analytic, class Scalar>
+            GAMMATONE_SIMD_INLINE void cooke1993_baseband_kernel(const cooke1993_arrays<Scalar>& s,
+                                                                  const std::size_t& size,
+                                                                  const Scalar* input,
+                                                                  Scalar* ure,
+                                                                  Scalar* uim,
+                                                                  const std::size_t& stride,
+                                                                  const std::size_t& first,
+                                                                  const std::size_t& last)
+            {
+                const std::size_t w = lanes<V,Scalar>();
+
+                for(std::size_t j = first; j < last; j += w)
+                {
+                    const std::size_t n = std::min(w, last - j);
+                    cooke1993_lanes<V,Scalar> c(s, j, n);
+
+                    for(std::size_t i = 0; i < size; ++i)
+                    {
+                        V re, im;
+                        c.step(broadcast<V>(input[i]), re, im);
+                        if(Analytic)
+                        {
+                            store(ure + i*stride + j, c.factor * (re*c.qre + im*c.qim));
+                            store(uim + i*stride + j, c.factor * (im*c.qre - re*c.qim));
+                        }
+                        else
+                        {
+                            store(ure + i*stride + j, re);
+                            store(uim + i*stride + j, im);
+                        }
+                        c.rotate();
+                    }
+
+                    c.store_state(s, j, n);
+                }
+            }
+
+            //! Tile of Tile streams of a cooke1993_streams_kernel
+            /*!
+              Computes the channels j to j + lanes<V,Scalar>() on the
+              streams k to k + Tile, their independent cascades being
+              updated together so that their latencies overlap. The
+              phasor q is rotated once per sample for all the streams,
+              from its initial value to its final one.
+            */
+            template<class V, std::size_t Tile, class Scalar>
+            GAMMATONE_SIMD_INLINE void cooke1993_streams_tile(const cooke1993_arrays<Scalar>& s,
+                                                               const std::size_t& state_stride,
+                                                               const std::size_t& size,
+                                                               const Scalar* input,
+                                                               const std::size_t& input_sample_stride,
+                                                               const std::size_t& input_stream_stride,
+                                                               Scalar* output,
+                                                               const std::size_t& sample_stride,
+                                                               const std::size_t& channel_stride,
+                                                               const std::size_t& stream_stride,
+                                                               const std::size_t& j,
+                                                               const std::size_t& k,
+                                                               V& qre, V& qim)
+            {
+                const std::size_t w = lanes<V,Scalar>();
+                const std::size_t n = std::min(w, s.channels - j);
+                const V factor = load<V>(s.factor + j), cre = load<V>(s.cre + j), cim = load<V>(s.cim + j);
+                const V r = load<V>(s.r + j), r4 = 4*r, r8 = 8*r;
+
+                // the cascades of the tile, not an array so that they
+                // stay in registers
+                cooke1993_cascade<V,Scalar> c0(s, k*state_stride + j);
+                cooke1993_cascade<V,Scalar> c1(s, (k + Tile - 1)*state_stride + j);
+
+                const Scalar* x = input + k*input_stream_stride;
+                Scalar* out = output + j*channel_stride + k*stream_stride;
+                for(std::size_t i = 0; i < size; ++i, x += input_sample_stride, out += sample_stride)
+                {
+                    V ure, uim, y;
+
+                    c0.step(broadcast<V>(x[0]), qre, qim, r, r4, r8, ure, uim);
+                    y = factor * (ure*qre + uim*qim);
+                    if(channel_stride != 1) scatter(out, y, n, channel_stride);
+                    else if(n == w) store(out, y);
+                    else store(out, y, n);
+
+                    if(Tile == 2)
+                    {
+                        c1.step(broadcast<V>(x[input_stream_stride]), qre, qim, r, r4, r8, ure, uim);
+                        y = factor * (ure*qre + uim*qim);
+                        if(channel_stride != 1) scatter(out + stream_stride, y, n, channel_stride);
+                        else if(n == w) store(out + stream_stride, y);
+                        else store(out + stream_stride, y, n);
+                    }
+
+                    const V re = cre*qre + cim*qim;
+                    const V im = cre*qim - cim*qre;
+                    qre = re;
+                    qim = im;
+                }
+
+                c0.store_cascade(s, k*state_stride + j);
+                if(Tile == 2) c1.store_cascade(s, (k + 1)*state_stride + j);
+            }
+
+            //! Generic multi-stream cooke1993 kernel on vectors of type V
+            /*!
+              As cooke1993_kernel on several input streams, the states
+              of stream k being at index k*state_stride in the state
+              arrays of *s*, the phasors and coefficients being shared
+              by the streams. Sample i of stream k is read in
+              input[i*input_sample_stride + k*input_stream_stride], the
+              output of its channel j being written at
+              output[i*sample_stride + j*channel_stride + k*stream_stride].
+
+              The streams are computed by pairs, each pair rotating
+              the phasors once per sample for both streams.
+            */
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE void cooke1993_streams_kernel(const cooke1993_arrays<Scalar>& s,
+                                                                 const std::size_t& state_stride,
+                                                                 const std::size_t& streams,
+                                                                 const std::size_t& size,
+                                                                 const Scalar* input,
+                                                                 const std::size_t& input_sample_stride,
+                                                                 const std::size_t& input_stream_stride,
+                                                                 Scalar* output,
+                                                                 const std::size_t& sample_stride,
+                                                                 const std::size_t& channel_stride,
+                                                                 const std::size_t& stream_stride)
+            {
+                const std::size_t w = lanes<V,Scalar>();
+
+                // the outputs of each pair are written entirely
+                // before the next one
+                for(std::size_t k = 0; k < streams; k += 2)
+                    for(std::size_t j = 0; j < s.channels; j += w)
+                    {
+                        // every pair starts from the same phasor, the
+                        // last one stores it
+                        V qre = load<V>(s.qre + j), qim = load<V>(s.qim + j);
+
+                        if(k + 1 < streams)
+                            cooke1993_streams_tile<V,2>(s, state_stride, size, input,
+                                                        input_sample_stride, input_stream_stride,
+                                                        output, sample_stride, channel_stride, stream_stride,
+                                                        j, k, qre, qim);
+                        else
+                            cooke1993_streams_tile<V,1>(s, state_stride, size, input,
+                                                        input_sample_stride, input_stream_stride,
+                                                        output, sample_stride, channel_stride, stream_stride,
+                                                        j, k, qre, qim);
+
+                        if(k + 2 >= streams)
+                        {
+                            store(s.qre + j, qre);
+                            store(s.qim + j, qim);
+                        }
+                    }
+            }
+
+            // Instances of the kernels for each instruction set
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("sse2")
+            void cooke1993_sse2(const cooke1993_arrays<Scalar>& s, std::size_t size,
+                                const Scalar* input, Scalar* output,
+                                std::size_t sstride, std::size_t cstride,
+                                std::size_t first, std::size_t last)
+            {
+                cooke1993_kernel<typename vector<Scalar,16>::type>(
+                    s, size, input, output, sstride, cstride, first, last);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx2")
+            void cooke1993_avx2(const cooke1993_arrays<Scalar>& s, std::size_t size,
+                                const Scalar* input, Scalar* output,
+                                std::size_t sstride, std::size_t cstride,
+                                std::size_t first, std::size_t last)
+            {
+                cooke1993_kernel<typename vector<Scalar,32>::type>(
+                    s, size, input, output, sstride, cstride, first, last);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx512f")
+            void cooke1993_avx512(const cooke1993_arrays<Scalar>& s, std::size_t size,
+                                  const Scalar* input, Scalar* output,
+                                std::size_t sstride, std::size_t cstride,
+                                std::size_t first, std::size_t last)
+            {
+                cooke1993_kernel<typename vector<Scalar,64>::type>(
+                    s, size, input, output, sstride, cstride, first, last);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("sse2")
+            void cooke1993_baseband_sse2(const cooke1993_arrays<Scalar>& s, std::size_t size,
+                                         const Scalar* input, Scalar* ure, Scalar* uim,
+                                         std::size_t stride, std::size_t first, std::size_t last,
+                                         bool analytic)
+            {
+                using V = typename vector<Scalar,16>::type;
+                if(analytic) cooke1993_baseband_kernel<V,true>(s, size, input, ure, uim, stride, first, last);
+                else cooke1993_baseband_kernel<V,false>(s, size, input, ure, uim, stride, first, last);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx2")
+            void cooke1993_baseband_avx2(const cooke1993_arrays<Scalar>& s, std::size_t size,
+                                         const Scalar* input, Scalar* ure, Scalar* uim,
+                                         std::size_t stride, std::size_t first, std::size_t last,
+                                         bool analytic)
+            {
+                using V = typename vector<Scalar,32>::type;
+                if(analytic) cooke1993_baseband_kernel<V,true>(s, size, input, ure, uim, stride, first, last);
+                else cooke1993_baseband_kernel<V,false>(s, size, input, ure, uim, stride, first, last);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx512f")
+            void cooke1993_baseband_avx512(const cooke1993_arrays<Scalar>& s, std::size_t size,
+                                           const Scalar* input, Scalar* ure, Scalar* uim,
+                                           std::size_t stride, std::size_t first, std::size_t last,
+                                           bool analytic)
+            {
+                using V = typename vector<Scalar,64>::type;
+                if(analytic) cooke1993_baseband_kernel<V,true>(s, size, input, ure, uim, stride, first, last);
+                else cooke1993_baseband_kernel<V,false>(s, size, input, ure, uim, stride, first, last);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("sse2")
+            void cooke1993_streams_sse2(const cooke1993_arrays<Scalar>& s, std::size_t state_stride,
+                                        std::size_t streams, std::size_t size,
+                                        const Scalar* input, std::size_t isstride, std::size_t ikstride,
+                                        Scalar* output, std::size_t sstride, std::size_t cstride, std::size_t kstride)
+            {
+                cooke1993_streams_kernel<typename vector<Scalar,16>::type>(
+                    s, state_stride, streams, size, input, isstride, ikstride,
+                    output, sstride, cstride, kstride);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx2")
+            void cooke1993_streams_avx2(const cooke1993_arrays<Scalar>& s, std::size_t state_stride,
+                                        std::size_t streams, std::size_t size,
+                                        const Scalar* input, std::size_t isstride, std::size_t ikstride,
+                                        Scalar* output, std::size_t sstride, std::size_t cstride, std::size_t kstride)
+            {
+                cooke1993_streams_kernel<typename vector<Scalar,32>::type>(
+                    s, state_stride, streams, size, input, isstride, ikstride,
+                    output, sstride, cstride, kstride);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx512f")
+            void cooke1993_streams_avx512(const cooke1993_arrays<Scalar>& s, std::size_t state_stride,
+                                          std::size_t streams, std::size_t size,
+                                          const Scalar* input, std::size_t isstride, std::size_t ikstride,
+                                          Scalar* output, std::size_t sstride, std::size_t cstride, std::size_t kstride)
+            {
+                cooke1993_streams_kernel<typename vector<Scalar,64>::type>(
+                    s, state_stride, streams, size, input, isstride, ikstride,
+                    output, sstride, cstride, kstride);
+            }
+        }
+GAMMATONE_SIMD_END
+#endif
+
+        //! Compute a bank of cooke1993 channels with a given kernel
+        /*!
+          See simd::cooke1993_kernel for the parameters.
+
+          \return false if no kernel for *i* is available, in which
+          case nothing is computed.
+        */
+        template<class Scalar>
+        inline typename std::enable_if<simd::is_vectorizable<Scalar>::value, bool>::type
+        cooke1993_dispatch(const simd::isa& i, const cooke1993_arrays<Scalar>& s,
+                           const std::size_t& size, const Scalar* input, Scalar* output,
+                           const std::size_t& sstride, const std::size_t& cstride,
+                           const std::size_t& first, const std::size_t& last)
+        {
+#ifdef GAMMATONE_SIMD
+            switch(i){
+            case simd::isa::sse2:
+                simd::cooke1993_sse2(s, size, input, output, sstride, cstride, first, last);
+                return true;
+            case simd::isa::avx2:
+                simd::cooke1993_avx2(s, size, input, output, sstride, cstride, first, last);
+                return true;
+            case simd::isa::avx512:
+                simd::cooke1993_avx512(s, size, input, output, sstride, cstride, first, last);
+                return true;
+            default: return false;
+            }
+#else
+            return false;
+#endif
+        }
+
+        template<class Scalar>
+        inline typename std::enable_if<! simd::is_vectorizable<Scalar>::value, bool>::type
+        cooke1993_dispatch(const simd::isa&, const cooke1993_arrays<Scalar>&,
+                           const std::size_t&, const Scalar*, Scalar*,
+                           const std::size_t&, const std::size_t&,
+                           const std::size_t&, const std::size_t&)
+        {
+            return false;
+        }
+
+        //! Compute the base-band outputs of a bank of cooke1993 channels with a given kernel
+        /*!
+          See simd::cooke1993_baseband_kernel for the parameters,
+          *analytic* selecting the analytic output.
+
+          \return false if no kernel for *i* is available, in which
+          case nothing is computed.
+        */
+        template<class Scalar>
+        inline typename std::enable_if<simd::is_vectorizable<Scalar>::value, bool>::type
+        cooke1993_baseband_dispatch(const simd::isa& i, const cooke1993_arrays<Scalar>& s,
+                                    const std::size_t& size, const Scalar* input,
+                                    Scalar* ure, Scalar* uim, const std::size_t& stride,
+                                    const std::size_t& first, const std::size_t& last,
+                                    const bool& analytic = false)
+        {
+#ifdef GAMMATONE_SIMD
+            switch(i){
+            case simd::isa::sse2:
+                simd::cooke1993_baseband_sse2(s, size, input, ure, uim, stride, first, last, analytic);
+                return true;
+            case simd::isa::avx2:
+                simd::cooke1993_baseband_avx2(s, size, input, ure, uim, stride, first, last, analytic);
+                return true;
+            case simd::isa::avx512:
+                simd::cooke1993_baseband_avx512(s, size, input, ure, uim, stride, first, last, analytic);
+                return true;
+            default: return false;
+            }
+#else
+            return false;
+#endif
+        }
+
+        template<class Scalar>
+        inline typename std::enable_if<! simd::is_vectorizable<Scalar>::value, bool>::type
+        cooke1993_baseband_dispatch(const simd::isa&, const cooke1993_arrays<Scalar>&,
+                                    const std::size_t&, const Scalar*, Scalar*, Scalar*,
+                                    const std::size_t&, const std::size_t&, const std::size_t&,
+                                    const bool& = false)
+        {
+            return false;
+        }
+
+        //! Compute a bank of cooke1993 channels on several streams with a given kernel
+        /*!
+          See simd::cooke1993_streams_kernel for the parameters.
+
+          \return false if no kernel for *i* is available, in which
+          case nothing is computed.
+        */
+        template<class Scalar>
+        inline typename std::enable_if<simd::is_vectorizable<Scalar>::value, bool>::type
+        cooke1993_streams_dispatch(const simd::isa& i, const cooke1993_arrays<Scalar>& s,
+                                   const std::size_t& state_stride, const std::size_t& streams,
+                                   const std::size_t& size, const Scalar* input,
+                                   const std::size_t& isstride, const std::size_t& ikstride,
+                                   Scalar* output, const std::size_t& sstride,
+                                   const std::size_t& cstride, const std::size_t& kstride)
+        {
+#ifdef GAMMATONE_SIMD
+            switch(i){
+            case simd::isa::sse2:
+                simd::cooke1993_streams_sse2(s, state_stride, streams, size, input, isstride, ikstride,
+                                             output, sstride, cstride, kstride);
+                return true;
+            case simd::isa::avx2:
+                simd::cooke1993_streams_avx2(s, state_stride, streams, size, input, isstride, ikstride,
+                                             output, sstride, cstride, kstride);
+                return true;
+            case simd::isa::avx512:
+                simd::cooke1993_streams_avx512(s, state_stride, streams, size, input, isstride, ikstride,
+                                               output, sstride, cstride, kstride);
+                return true;
+            default: return false;
+            }
+#else
+            return false;
+#endif
+        }
+
+        template<class Scalar>
+        inline typename std::enable_if<! simd::is_vectorizable<Scalar>::value, bool>::type
+        cooke1993_streams_dispatch(const simd::isa&, const cooke1993_arrays<Scalar>&,
+                                   const std::size_t&, const std::size_t&,
+                                   const std::size_t&, const Scalar*,
+                                   const std::size_t&, const std::size_t&,
+                                   Scalar*, const std::size_t&,
+                                   const std::size_t&, const std::size_t&)
+        {
+            return false;
+        }
+    }
+}
+
+#endif // GAMMATONE_DETAIL_COOKE1993_SIMD_HPP
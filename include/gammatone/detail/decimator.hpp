@@ -0,0 +1,202 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_DECIMATOR_HPP
+#define GAMMATONE_DETAIL_DECIMATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Anti-aliased decimation by a triangular window
+        /*!
+          \class decimator gammatone/detail/decimator.hpp
+
+          Outputs one frame every D = factor() samples, the frame m
+          being the mean of the samples around mD weighted by a
+          triangular window of 2D-1 samples, \f$ (D - |k|)/D^2 \f$.
+          This is the response of an order 2 CIC decimator: its
+          zeros are on the multiples of \f$ f_s/D \f$, which are
+          aliased on DC, and its sidelobes are below -26 dB. The
+          window is computed as two weighted sums along each frame,
+          so the cost is two multiply-adds per sample.
+
+          Frame m is output after the sample (m+1)D-1, the latency is
+          thus D-1 samples.
+
+          \tparam T       Type of the decimated values, Scalar or std::complex<Scalar>
+          \tparam Scalar  Type of the weights
+        */
+        template<class T, class Scalar>
+        class decimator
+        {
+        public:
+            //! Creates a decimator by a given factor, 1 for no decimation
+            explicit decimator(const std::size_t& factor = 1)
+                : m_factor(factor ? factor : 1),
+                  m_scale(Scalar(1) / (Scalar(m_factor)*Scalar(m_factor)))
+                {
+                    reset();
+                }
+
+            //! The decimation factor D
+            std::size_t factor() const{
+                return m_factor;
+            }
+
+            //! Back to the beginning of the first frame
+            void reset(){
+                m_position = 0;
+                m_rise = m_fall = m_previous = T(0);
+            }
+
+            //! Push a sample, the output being set at the end of each frame
+            /*!
+              \param x       The input sample.
+              \param output  The frame, set only if true is returned.
+              \return true at the end of a frame.
+            */
+            bool push(const T& x, T& output){
+                // rising edge for the next frame, falling one for this frame
+                m_rise += Scalar(m_position)*x;
+                m_fall += Scalar(m_factor - m_position)*x;
+                if(++m_position < m_factor) return false;
+
+                output = (m_previous + m_fall) * m_scale;
+                m_previous = m_rise;
+                m_rise = m_fall = T(0);
+                m_position = 0;
+                return true;
+            }
+
+        private:
+            //! The decimation factor D
+            std::size_t m_factor;
+
+            //! Normalization of the window, \f$ 1/D^2 \f$
+            Scalar m_scale;
+
+            //! Position in the current frame
+            std::size_t m_position;
+
+            //! Weighted sums of the current frame
+            T m_rise, m_fall;
+
+            //! Rising sum of the previous frame
+            T m_previous;
+        };
+
+        //! Decimation of several channels at once
+        /*!
+          \class decimator_bank gammatone/detail/decimator.hpp
+
+          Equivalent to a decimator<Scalar,Scalar> per channel. All
+          the channels being at the same position in their frame, the
+          weights of a sample are shared and the sums are updated by
+          a single loop across channels, which the compiler is able to
+          vectorize. Results are identical to those of decimator.
+
+          \tparam Scalar  Type of the decimated values
+        */
+        template<class Scalar>
+        class decimator_bank
+        {
+        public:
+            //! Creates a decimator of several channels by a given factor
+            explicit decimator_bank(const std::size_t& channels = 0, const std::size_t& factor = 1)
+                : m_factor(factor ? factor : 1),
+                  m_scale(Scalar(1) / (Scalar(m_factor)*Scalar(m_factor))),
+                  m_rise(channels), m_fall(channels), m_previous(channels)
+                {
+                    reset();
+                }
+
+            //! The decimation factor D
+            std::size_t factor() const{
+                return m_factor;
+            }
+
+            //! The number of channels
+            std::size_t nb_channels() const{
+                return m_rise.size();
+            }
+
+            //! Back to the beginning of the first frame
+            void reset(){
+                m_position = 0;
+                std::fill(m_rise.begin(), m_rise.end(), Scalar(0));
+                std::fill(m_fall.begin(), m_fall.end(), Scalar(0));
+                std::fill(m_previous.begin(), m_previous.end(), Scalar(0));
+            }
+
+            //! Push a sample of each channel, see decimator::push()
+            /*!
+              \param x       The samples, one per channel.
+              \param output  The frames, one per channel, set only if
+              true is returned.
+              \return true at the end of a frame.
+            */
+            bool push(const Scalar* x, Scalar* output){
+                const std::size_t n = nb_channels();
+                Scalar* rise = m_rise.data();
+                Scalar* fall = m_fall.data();
+
+                const Scalar a = Scalar(m_position), b = Scalar(m_factor - m_position);
+                for(std::size_t j = 0; j < n; ++j)
+                {
+                    rise[j] += a*x[j];
+                    fall[j] += b*x[j];
+                }
+                if(++m_position < m_factor) return false;
+
+                Scalar* previous = m_previous.data();
+                for(std::size_t j = 0; j < n; ++j)
+                {
+                    output[j] = (previous[j] + fall[j]) * m_scale;
+                    previous[j] = rise[j];
+                    rise[j] = fall[j] = Scalar(0);
+                }
+                m_position = 0;
+                return true;
+            }
+
+        private:
+            //! The decimation factor D
+            std::size_t m_factor;
+
+            //! Normalization of the window, \f$ 1/D^2 \f$
+            Scalar m_scale;
+
+            //! Position in the current frame, shared by all channels
+            std::size_t m_position;
+
+            //! Weighted sums of the current frame of each channel
+            std::vector<Scalar> m_rise, m_fall;
+
+            //! Rising sums of the previous frame of each channel
+            std::vector<Scalar> m_previous;
+        };
+    }
+}
+
+#endif // GAMMATONE_DETAIL_DECIMATOR_HPP
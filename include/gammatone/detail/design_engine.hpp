@@ -0,0 +1,235 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_DESIGN_ENGINE_HPP
+#define GAMMATONE_DETAIL_DESIGN_ENGINE_HPP
+
+#include <gammatone/core/cooke1993.hpp>
+#include <gammatone/core/cooke1993_design.hpp>
+#include <gammatone/core/slaney1993.hpp>
+#include <gammatone/core/slaney1993_design.hpp>
+#include <gammatone/detail/bank_engine.hpp>
+#include <vector>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Processing engine of a filterbank_design
+        /*!
+          \class design_engine gammatone/detail/design_engine.hpp
+
+          A design engine holds the coefficients of the channels and
+          computes them on separate states. Specializations of this
+          class for a given core hold the coefficients once, their
+          states being reduced to the recursion states.
+
+          This generic engine has no such separation: its states are
+          whole bank_engine, copied from a prototype built once, so
+          that each state duplicates the coefficients of all the
+          channels. With core::convolution this is the impulse
+          response and its partitioned spectrum, the largest part of
+          a channel. They are built on the first computation of a
+          state (see core::convolution), the impulse responses being
+          computed once per process by detail::ir_cache.
+
+          \tparam Filter  Type of the filters in the bank.
+          \tparam Core    Type of the filters core, used for specialization.
+        */
+        template<class Filter, class Core = typename Filter::core>
+        class design_engine
+        {
+        public:
+            //! Type of the scalars
+            using scalar_type = typename Filter::scalar_type;
+
+            //! Type of the states
+            using state_type = bank_engine<Filter>;
+
+            //! Creates an engine from the parameters of the channels
+            /*!
+              The bandwidths are those given by the policy of Filter
+              and are not used here.
+            */
+            design_engine(const scalar_type& sample_frequency,
+                          const std::vector<scalar_type>& center_frequencies,
+                          const std::vector<scalar_type>&)
+                : m_prototype(make_filters(sample_frequency, center_frequencies))
+                {}
+
+            std::size_t nb_channels() const{
+                return m_prototype.nb_channels();
+            }
+
+            //! A new state, at its initial value
+            state_type make_state() const{
+                return m_prototype;
+            }
+
+            //! Compute all the channels from a state, see filterbank::compute_ptr
+            inline void compute_ptr(state_type& state,
+                                    const std::size_t& size,
+                                    const scalar_type* input,
+                                    scalar_type* output,
+                                    const std::size_t& sample_stride,
+                                    const std::size_t& channel_stride) const{
+                compute_ptr(state, size, input, output, sample_stride, channel_stride,
+                            0, nb_channels());
+                advance(state, size, input);
+            }
+
+            //! Compute the channels in [first, last) from a state, see bank_engine::compute_ptr
+            inline void compute_ptr(state_type& state,
+                                    const std::size_t& size,
+                                    const scalar_type* input,
+                                    scalar_type* output,
+                                    const std::size_t& sample_stride,
+                                    const std::size_t& channel_stride,
+                                    const std::size_t& first,
+                                    const std::size_t& last) const{
+                state.compute_ptr(size, input, output, sample_stride, channel_stride,
+                                  first, last);
+            }
+
+            //! Update a state after a slice-wise compute_ptr(), see bank_engine::advance
+            inline void advance(state_type& state,
+                                const std::size_t& size,
+                                const scalar_type* input) const{
+                state.advance(size, input);
+            }
+
+            //! Granularity of channel slices in compute_ptr()
+            static constexpr std::size_t alignment(){
+                return state_type::alignment();
+            }
+
+        private:
+            //! One filter for each center frequency
+            static std::vector<Filter> make_filters(const scalar_type& sample_frequency,
+                                                    const std::vector<scalar_type>& center_frequencies){
+                std::vector<Filter> filters;
+                filters.reserve(center_frequencies.size());
+                for(const auto& f : center_frequencies)
+                    filters.push_back(Filter(sample_frequency, f));
+                return filters;
+            }
+
+            //! The initial state, copied in each new state
+            state_type m_prototype;
+        };
+
+
+        //! Design engine based on a core design
+        /*!
+          Base of the design_engine specializations, the coefficients
+          and states being those of Design.
+
+          \tparam Filter  Type of the filters in the bank.
+          \tparam Design  Type of the core design.
+        */
+        template<class Filter, class Design>
+        class core_design_engine
+        {
+        public:
+            using scalar_type = typename Filter::scalar_type;
+
+            //! Type of the underlying core design
+            using core_type = Design;
+
+            using state_type = typename Design::state_type;
+
+            core_design_engine(const scalar_type& sample_frequency,
+                               const std::vector<scalar_type>& center_frequencies,
+                               const std::vector<scalar_type>& bandwidths)
+                : m_core(sample_frequency, center_frequencies, bandwidths)
+                {}
+
+            std::size_t nb_channels() const{
+                return m_core.nb_channels();
+            }
+
+            state_type make_state() const{
+                return m_core.make_state();
+            }
+
+            inline void compute_ptr(state_type& state,
+                                    const std::size_t& size,
+                                    const scalar_type* input,
+                                    scalar_type* output,
+                                    const std::size_t& sample_stride,
+                                    const std::size_t& channel_stride) const{
+                m_core.compute_strided(state, size, input, output, sample_stride, channel_stride);
+            }
+
+            inline void compute_ptr(state_type& state,
+                                    const std::size_t& size,
+                                    const scalar_type* input,
+                                    scalar_type* output,
+                                    const std::size_t& sample_stride,
+                                    const std::size_t& channel_stride,
+                                    const std::size_t& first,
+                                    const std::size_t& last) const{
+                m_core.compute_strided(state, size, input, output, sample_stride, channel_stride,
+                                       first, last);
+            }
+
+            //! The channels share nothing in a core design
+            inline void advance(state_type&, const std::size_t&, const scalar_type*) const{}
+
+            static constexpr std::size_t alignment(){
+                return core_type::alignment();
+            }
+
+            //! Access to the core design
+            const core_type& core() const{
+                return m_core;
+            }
+
+        private:
+            //! The core design
+            core_type m_core;
+        };
+
+
+        //! Design engine specialization for core::cooke1993
+        template<class Filter, class Scalar, class GainPolicy, class ClippingPolicy>
+        class design_engine<Filter, core::cooke1993<Scalar, GainPolicy, ClippingPolicy> >
+            : public core_design_engine<
+            Filter, core::cooke1993_design<Scalar, GainPolicy, ClippingPolicy> >
+        {
+        public:
+            using core_design_engine<
+                Filter, core::cooke1993_design<Scalar, GainPolicy, ClippingPolicy> >::core_design_engine;
+        };
+
+
+        //! Design engine specialization for core::slaney1993
+        template<class Filter, class Scalar, class GainPolicy, class ClippingPolicy>
+        class design_engine<Filter, core::slaney1993<Scalar, GainPolicy, ClippingPolicy> >
+            : public core_design_engine<
+            Filter, core::slaney1993_design<Scalar, GainPolicy, ClippingPolicy> >
+        {
+        public:
+            using core_design_engine<
+                Filter, core::slaney1993_design<Scalar, GainPolicy, ClippingPolicy> >::core_design_engine;
+        };
+    }
+}
+
+#endif // GAMMATONE_DETAIL_DESIGN_ENGINE_HPP
@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_DOT_PRODUCT_HPP
+#define GAMMATONE_DETAIL_DOT_PRODUCT_HPP
+
+#include <gammatone/detail/simd.hpp>
+#include <cstddef>
+#include <cstring>
+#include <numeric>
+
+namespace gammatone
+{
+    namespace detail
+    {
+#ifdef GAMMATONE_SIMD
+GAMMATONE_SIMD_BEGIN
+        namespace simd
+        {
+            //! Dot product of two contiguous arrays
+            /*!
+              Products are summed in 4 independent vector
+              accumulators, which hides the latency of the additions,
+              then in a single one, the remaining samples being
+              summed in scalar code. The summation order depends on
+              the lanes of V, so results differ from
+              std::inner_product by rounding errors.
+            */
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE Scalar dot_product_kernel(const Scalar* a, const Scalar* b,
+                                                            const std::size_t& size)
+            {
+                constexpr std::size_t n = lanes<V,Scalar>();
+
+                V acc0 = {}, acc1 = {}, acc2 = {}, acc3 = {};
+                std::size_t i = 0;
+                for(; i + 4*n <= size; i += 4*n)
+                {
+                    acc0 += load<V>(a + i)       * load<V>(b + i);
+                    acc1 += load<V>(a + i + n)   * load<V>(b + i + n);
+                    acc2 += load<V>(a + i + 2*n) * load<V>(b + i + 2*n);
+                    acc3 += load<V>(a + i + 3*n) * load<V>(b + i + 3*n);
+                }
+                for(; i + n <= size; i += n)
+                    acc0 += load<V>(a + i) * load<V>(b + i);
+
+                Scalar tmp[n];
+                const V acc = (acc0 + acc1) + (acc2 + acc3);
+                std::memcpy(tmp, &acc, sizeof(V));
+
+                Scalar sum = 0;
+                for(std::size_t k = 0; k < n; ++k) sum += tmp[k];
+                for(; i < size; ++i) sum += a[i] * b[i];
+                return sum;
+            }
+
+            // Instances of the kernel for each instruction set
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("sse2")
+            Scalar dot_product_sse2(const Scalar* a, const Scalar* b, std::size_t size)
+            {
+                return dot_product_kernel<typename vector<Scalar,16>::type>(a, b, size);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx2")
+            Scalar dot_product_avx2(const Scalar* a, const Scalar* b, std::size_t size)
+            {
+                return dot_product_kernel<typename vector<Scalar,32>::type>(a, b, size);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx512f")
+            Scalar dot_product_avx512(const Scalar* a, const Scalar* b, std::size_t size)
+            {
+                return dot_product_kernel<typename vector<Scalar,64>::type>(a, b, size);
+            }
+        }
+GAMMATONE_SIMD_END
+#endif
+
+        //! Dot product of two contiguous arrays with a given kernel
+        /*!
+          See simd::dot_product_kernel. The scalar kernel, and types
+          without explicit kernels, use std::inner_product.
+
+          \param i     The instruction set of the kernel.
+          \param a     Pointer to *size* scalars.
+          \param b     Pointer to *size* scalars.
+          \param size  Number of products.
+        */
+        template<class Scalar>
+        inline typename std::enable_if<simd::is_vectorizable<Scalar>::value, Scalar>::type
+        dot_product_dispatch(const simd::isa& i, const Scalar* a, const Scalar* b,
+                             const std::size_t& size)
+        {
+#ifdef GAMMATONE_SIMD
+            switch(i){
+            case simd::isa::sse2:   return simd::dot_product_sse2(a, b, size);
+            case simd::isa::avx2:   return simd::dot_product_avx2(a, b, size);
+            case simd::isa::avx512: return simd::dot_product_avx512(a, b, size);
+            default: break;
+            }
+#endif
+            return std::inner_product(a, a + size, b, Scalar(0));
+        }
+
+        template<class Scalar>
+        inline typename std::enable_if<! simd::is_vectorizable<Scalar>::value, Scalar>::type
+        dot_product_dispatch(const simd::isa&, const Scalar* a, const Scalar* b,
+                             const std::size_t& size)
+        {
+            return std::inner_product(a, a + size, b, Scalar(0));
+        }
+    }
+}
+
+#endif // GAMMATONE_DETAIL_DOT_PRODUCT_HPP
@@ -0,0 +1,213 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_FFT_HPP
+#define GAMMATONE_DETAIL_FFT_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Fast Fourier transform of real sequences
+        /*!
+          \class fft gammatone/detail/fft.hpp
+
+          A minimal radix-2 FFT used by the convolution engines. A
+          real sequence of size n is transformed with a complex FFT of
+          size n/2 on its even and odd samples. Spectra are made of the
+          n/2+1 first bins, real and imaginary parts being stored in
+          separate arrays.
+
+          Twiddle factors are computed once at construction. Transforms
+          use internal buffers, so that a single instance must not be
+          used concurrently.
+
+          \tparam Scalar  Type of the scalars.
+        */
+        template<class Scalar>
+        class fft
+        {
+        public:
+            //! An empty transform, to be assigned
+            fft()
+                : m_size(0)
+                {}
+
+            //! Prepare transforms of a given size
+            /*!
+              \param size  The size n of the real sequences, a power of
+              2 greater than 1.
+            */
+            explicit fft(const std::size_t& size)
+                : m_size(size),
+                  m_bitrev(size/2),
+                  m_wre(size/4 + 1), m_wim(size/4 + 1),
+                  m_rre(size/2 + 1), m_rim(size/2 + 1),
+                  m_zre(size/2), m_zim(size/2)
+                {
+                    const std::size_t m = size/2;
+                    const double pi = std::acos(-1.0);
+
+                    std::size_t bits = 0;
+                    while((std::size_t(1) << bits) < m) ++bits;
+                    for(std::size_t k = 0; k < m; ++k)
+                    {
+                        std::size_t r = 0;
+                        for(std::size_t b = 0; b < bits; ++b)
+                            if(k & (std::size_t(1) << b)) r |= std::size_t(1) << (bits - 1 - b);
+                        m_bitrev[k] = r;
+                    }
+
+                    // exp(-2ipi k/m) for the complex transform
+                    for(std::size_t k = 0; k < m_wre.size(); ++k)
+                    {
+                        m_wre[k] = std::cos(2*pi*k/m);
+                        m_wim[k] = -std::sin(2*pi*k/m);
+                    }
+
+                    // exp(-2ipi k/n) to split even and odd samples
+                    for(std::size_t k = 0; k <= m; ++k)
+                    {
+                        m_rre[k] = std::cos(pi*k/m);
+                        m_rim[k] = -std::sin(pi*k/m);
+                    }
+                }
+
+            //! The size of the real sequences
+            std::size_t size() const{
+                return m_size;
+            }
+
+            //! Number of bins in a spectrum, size()/2+1
+            std::size_t bins() const{
+                return m_size/2 + 1;
+            }
+
+            //! Forward transform of size() real scalars to bins() complex ones
+            void forward(const Scalar* input, Scalar* re, Scalar* im){
+                const std::size_t m = m_size/2;
+                for(std::size_t k = 0; k < m; ++k)
+                {
+                    m_zre[k] = input[2*k];
+                    m_zim[k] = input[2*k+1];
+                }
+                transform(false);
+
+                // X[k] = E[k] + exp(-2ipi k/n) O[k], with E and O the
+                // spectra of even and odd samples
+                for(std::size_t k = 0; k <= m; ++k)
+                {
+                    const std::size_t a = k % m, b = (m - k) % m;
+                    const Scalar ere = (m_zre[a] + m_zre[b]) / 2;
+                    const Scalar eim = (m_zim[a] - m_zim[b]) / 2;
+                    const Scalar ore = (m_zim[a] + m_zim[b]) / 2;
+                    const Scalar oim = (m_zre[b] - m_zre[a]) / 2;
+                    re[k] = ere + m_rre[k]*ore - m_rim[k]*oim;
+                    im[k] = eim + m_rre[k]*oim + m_rim[k]*ore;
+                }
+            }
+
+            //! Inverse transform of bins() complex scalars, scaled by size()
+            /*!
+              The output is size() times the actual inverse transform,
+              the normalization being left to the caller.
+            */
+            void inverse(const Scalar* re, const Scalar* im, Scalar* output){
+                const std::size_t m = m_size/2;
+
+                // Z[k] = 2E[k] + 2iO[k]
+                for(std::size_t k = 0; k < m; ++k)
+                {
+                    const Scalar ere = re[k] + re[m-k];
+                    const Scalar eim = im[k] - im[m-k];
+                    const Scalar dre = re[k] - re[m-k];
+                    const Scalar dim = im[k] + im[m-k];
+                    const Scalar ore = dre*m_rre[k] + dim*m_rim[k];
+                    const Scalar oim = dim*m_rre[k] - dre*m_rim[k];
+                    m_zre[k] = ere - oim;
+                    m_zim[k] = eim + ore;
+                }
+                transform(true);
+
+                for(std::size_t k = 0; k < m; ++k)
+                {
+                    output[2*k] = m_zre[k];
+                    output[2*k+1] = m_zim[k];
+                }
+            }
+
+        private:
+            //! In place complex transform of the buffers, not normalized
+            void transform(const bool& inverse){
+                const std::size_t m = m_size/2;
+                for(std::size_t k = 0; k < m; ++k)
+                    if(k < m_bitrev[k])
+                    {
+                        std::swap(m_zre[k], m_zre[m_bitrev[k]]);
+                        std::swap(m_zim[k], m_zim[m_bitrev[k]]);
+                    }
+
+                const Scalar sign = inverse ? -1 : 1;
+                for(std::size_t len = 2; len <= m; len *= 2)
+                {
+                    const std::size_t half = len/2, step = m/len;
+                    for(std::size_t j = 0; j < half; ++j)
+                    {
+                        // the table holds a quarter of the circle
+                        const std::size_t t = j*step;
+                        const Scalar wre = t < m_wre.size() ? m_wre[t] : -m_wre[m/2 - t];
+                        const Scalar wim = sign * (t < m_wim.size() ? m_wim[t] : m_wim[m/2 - t]);
+
+                        for(std::size_t i = j; i < m; i += len)
+                        {
+                            const std::size_t b = i + half;
+                            const Scalar tre = m_zre[b]*wre - m_zim[b]*wim;
+                            const Scalar tim = m_zre[b]*wim + m_zim[b]*wre;
+                            m_zre[b] = m_zre[i] - tre;
+                            m_zim[b] = m_zim[i] - tim;
+                            m_zre[i] += tre;
+                            m_zim[i] += tim;
+                        }
+                    }
+                }
+            }
+
+            //! Size of the real sequences
+            std::size_t m_size;
+
+            //! Bit reversal permutation of the complex transform
+            std::vector<std::size_t> m_bitrev;
+
+            //! Twiddle factors of the complex transform
+            std::vector<Scalar> m_wre, m_wim;
+
+            //! Twiddle factors of the real transform
+            std::vector<Scalar> m_rre, m_rim;
+
+            //! Buffers of the complex transform
+            std::vector<Scalar> m_zre, m_zim;
+        };
+    }
+}
+
+#endif // GAMMATONE_DETAIL_FFT_HPP
@@ -0,0 +1,85 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_FIXED_POINT_HPP
+#define GAMMATONE_DETAIL_FIXED_POINT_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Traits of a signed fractional fixed-point format
+        /*!
+          \class fixed_point gammatone/detail/fixed_point.hpp
+
+          An Integer x stands for the real \f$ x / 2^F \f$ with F =
+          fraction_bits, in [-1, 1). Products of two Integers are
+          exact in wide_type. Values are saturated symmetrically to
+          \f$ \pm (2^F - 1) \f$, so that the product of two saturated
+          values, and the sum of two such products, never overflow
+          wide_type.
+
+          \tparam Integer  std::int16_t for Q15, std::int32_t for Q31.
+        */
+        template<class Integer> struct fixed_point;
+
+        //! Definition of the formats, see fixed_point
+        template<class Wide, std::size_t Bits>
+        struct fixed_point_format
+        {
+            using wide_type = Wide;
+            static constexpr std::size_t fraction_bits = Bits;
+        };
+
+        template<> struct fixed_point<std::int16_t> : fixed_point_format<std::int32_t,15> {};
+        template<> struct fixed_point<std::int32_t> : fixed_point_format<std::int64_t,31> {};
+
+        //! Saturate a wide value to the range of Integer
+        template<class Integer>
+        inline Integer saturate(const typename fixed_point<Integer>::wide_type& x){
+            using wide = typename fixed_point<Integer>::wide_type;
+            const wide max = (wide(1) << fixed_point<Integer>::fraction_bits) - 1;
+            return static_cast<Integer>(x > max ? max : x < -max ? -max : x);
+        }
+
+        //! Round a real to the nearest Integer with *bits* fraction bits, saturated
+        template<class Integer>
+        inline Integer quantize(const double& x, const std::size_t& bits = fixed_point<Integer>::fraction_bits){
+            using wide = typename fixed_point<Integer>::wide_type;
+            const double max = std::ldexp(1.0, fixed_point<Integer>::fraction_bits) - 1;
+            const double y = std::round(std::ldexp(x, bits));
+            return static_cast<Integer>(static_cast<wide>(y > max ? max : y < -max ? -max : y));
+        }
+
+        //! The real represented by an Integer with *bits* fraction bits
+        template<class Integer>
+        inline double dequantize(const Integer& x, const std::size_t& bits = fixed_point<Integer>::fraction_bits){
+            return std::ldexp(static_cast<double>(x), -static_cast<int>(bits));
+        }
+    }
+}
+
+template<class Wide, std::size_t Bits>
+constexpr std::size_t gammatone::detail::fixed_point_format<Wide,Bits>::fraction_bits;
+
+#endif // GAMMATONE_DETAIL_FIXED_POINT_HPP
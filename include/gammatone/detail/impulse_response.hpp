@@ -102,6 +102,8 @@ namespace gammatone
         \param bandwidth         The filter bandwidth (Hz)
         \param first             First iterator on the timestamps container
         \param last              Last iterator on the timestamps container
+        \param phase             Phase of the carrier (rad), -pi/2 gives
+        the quadrature impulse response
 
         \return The computed impulse response
       */
@@ -115,7 +117,8 @@ namespace gammatone
         const Scalar& center_frequency,
         const Scalar& bandwidth,
         const Iterator& first,
-        const Iterator& last);
+        const Iterator& last,
+        const Scalar& phase = 0.0);
 
 
       //! Compute the theoretical impulse response for given explicit
@@ -206,6 +209,34 @@ namespace gammatone
         const Scalar max_duration = 1.0);
 
 
+      //! Compute the quadrature of a theoretical impulse response
+      /*!
+        The theoretical impulse response with a carrier delayed by
+        pi/2. Along the one of the same parameters, it is the impulse
+        response of the analytic output of the filter.
+
+        \tparam Scalar     Type of scalar values
+        \tparam Container  Type of the output container
+
+        \param center_frequency  The filter center frequency (Hz)
+        \param bandwidth         The filter bandwidth (Hz)
+        \param sample_frequency  The sample frequency (Hz)
+        \param size              Number of samples of the impulse response
+
+        \return The computed impulse response
+      */
+      template
+      <
+        class Scalar,
+        template<class...> class Container = std::vector
+        >
+      static Container<Scalar> theorical_quadrature(
+        const Scalar& center_frequency,
+        const Scalar& bandwidth,
+        const Scalar& sample_frequency,
+        const std::size_t& size);
+
+
 
       //! Compute the implemented impulse response for given filter and timestamps
       /*!
@@ -315,6 +346,20 @@ theorical_attenuate(const Scalar& center_frequency,
   return ir;
 }
 
+template<class Scalar, template<class...> class Container>
+Container<Scalar> gammatone::detail::impulse_response::
+theorical_quadrature(const Scalar& center_frequency,
+                     const Scalar& bandwidth,
+                     const Scalar& sample_frequency,
+                     const std::size_t& size)
+{
+  // the timestamps of time(), on size samples
+  const Container<Scalar> t = gammatone::detail::linspace(
+    Scalar(0), Scalar(size ? size - 1 : 0) / sample_frequency, size);
+
+  return theorical(center_frequency, bandwidth, t.cbegin(), t.cend(), Scalar(-M_PI/2));
+}
+
 template<class Filter, template<class...> class Container>
 Container<typename Filter::scalar_type> gammatone::detail::impulse_response::
 theorical_attenuate(const Filter& filter,
@@ -351,13 +396,14 @@ Container<Scalar> gammatone::detail::impulse_response::
 theorical(const Scalar& center_frequency,
           const Scalar& bandwidth,
           const Iterator& first,
-          const Iterator& last)
+          const Iterator& last,
+          const Scalar& phase)
 {
   using T = typename Iterator::value_type;
 
   Container<Scalar> ir(std::distance(first,last));
   std::transform(first,last,ir.begin(),
-                 [&](const T& t){return formula_ir(center_frequency,bandwidth,t);});
+                 [&](const T& t){return formula_ir(center_frequency,bandwidth,t,phase);});
   return ir;
 }
 
@@ -425,7 +471,7 @@ time(const Scalar& sample_frequency,
      const Scalar& duration)
 {
   const std::size_t size = sample_frequency*duration + 1;
-  return gammatone::detail::linspace(0.0,duration,size);
+  return gammatone::detail::linspace(Scalar(0),duration,size);
 }
 
 
@@ -39,6 +39,10 @@ namespace gammatone
           The compute() method is not defined here but in child classes as
           the interface is different for filter and filterbank.
 
+          gammatone::filter and gammatone::filterbank do not derive from
+          this class but from detail::static_interface. Wrap them in a
+          gammatone::polymorphic to use them through this interface.
+
           \tparam Scalar Type of the scalar values (usually double, be
           scared of float16).
 
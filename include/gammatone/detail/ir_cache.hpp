@@ -0,0 +1,139 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_IR_CACHE_HPP
+#define GAMMATONE_DETAIL_IR_CACHE_HPP
+
+#include <gammatone/detail/impulse_response.hpp>
+#include <array>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Process-wide cache of theoretical impulse responses
+        /*!
+          \class ir_cache gammatone/detail/ir_cache.hpp
+
+          The convolution cores get their impulse responses from this
+          cache, so that each one is computed once per process,
+          whatever the number of filters, banks and states built on
+          it. The entries are kept until clear() is called.
+
+          A thread can attach a recorder to the cache, which then logs
+          the keys of the impulse responses requested by this thread,
+          so that they can be saved along a design (see
+          gammatone::design_cache). The requests of the other threads
+          are not recorded.
+
+          \tparam Scalar  Type of scalar values
+        */
+        template<class Scalar>
+        class ir_cache
+        {
+        public:
+            //! Parameters of an impulse response
+            /*!
+              Center frequency, bandwidth, sample frequency and
+              attenuation, see impulse_response::theorical_attenuate.
+            */
+            using key_type = std::array<Scalar,4>;
+
+            //! Type of the impulse responses
+            using ir_type = std::vector<Scalar>;
+
+            //! impulse_response::theorical_attenuate(), computed once per process
+            static ir_type attenuate(const Scalar& center_frequency,
+                                     const Scalar& bandwidth,
+                                     const Scalar& sample_frequency,
+                                     const Scalar& attenuation){
+                const key_type key = {{center_frequency, bandwidth, sample_frequency, attenuation}};
+                if(recorder()) recorder()->push_back(key);
+                {
+                    std::lock_guard<std::mutex> lock(mutex());
+                    const auto it = entries().find(key);
+                    if(it != entries().end()) return it->second;
+                }
+
+                // computed out of the lock, concurrent misses on a
+                // key giving the same result
+                ir_type ir = impulse_response::theorical_attenuate(
+                    center_frequency, bandwidth, sample_frequency, attenuation);
+
+                std::lock_guard<std::mutex> lock(mutex());
+                entries().emplace(key, ir);
+                return ir;
+            }
+
+            //! Find a cached impulse response, return false if absent
+            static bool find(const key_type& key, ir_type& ir){
+                std::lock_guard<std::mutex> lock(mutex());
+                const auto it = entries().find(key);
+                if(it == entries().end()) return false;
+                ir = it->second;
+                return true;
+            }
+
+            //! Insert an impulse response computed elsewhere
+            static void insert(const key_type& key, const ir_type& ir){
+                std::lock_guard<std::mutex> lock(mutex());
+                entries()[key] = ir;
+            }
+
+            //! Log the keys requested to attenuate() by the calling thread in *keys*, nullptr to stop
+            static void record(std::vector<key_type>* keys){
+                recorder() = keys;
+            }
+
+            //! Remove all the cached impulse responses
+            static void clear(){
+                std::lock_guard<std::mutex> lock(mutex());
+                entries().clear();
+            }
+
+            //! Number of cached impulse responses
+            static std::size_t size(){
+                std::lock_guard<std::mutex> lock(mutex());
+                return entries().size();
+            }
+
+        private:
+            static std::mutex& mutex(){
+                static std::mutex m;
+                return m;
+            }
+
+            static std::map<key_type, ir_type>& entries(){
+                static std::map<key_type, ir_type> e;
+                return e;
+            }
+
+            //! The recorder of the calling thread
+            static std::vector<key_type>*& recorder(){
+                static thread_local std::vector<key_type>* r = nullptr;
+                return r;
+            }
+        };
+    }
+}
+
+#endif // GAMMATONE_DETAIL_IR_CACHE_HPP
@@ -0,0 +1,407 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_PARTITIONED_CONVOLUTION_HPP
+#define GAMMATONE_DETAIL_PARTITIONED_CONVOLUTION_HPP
+
+#include <gammatone/detail/dot_product.hpp>
+#include <gammatone/detail/fft.hpp>
+#include <gammatone/detail/simd.hpp>
+#include <algorithm>
+#include <complex>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Zero latency convolution with a uniformly partitioned impulse response
+        /*!
+          \class partitioned_convolution gammatone/detail/partitioned_convolution.hpp
+
+          The impulse response is split in partitions of block_size()
+          samples. The first partition is convolved directly with the
+          input, sample by sample. The contribution of the other
+          partitions to the next block of outputs is computed once per
+          block by an overlap-save FFT convolution, from the spectra of
+          the past input blocks kept in a ring. This costs about
+          block_size() multiply-adds per sample plus the FFT work,
+          instead of the whole impulse response length.
+
+          With a single partition the impulse response is convolved
+          directly. FFT results differ from the direct convolution by
+          rounding errors.
+
+          The first partition is stored reversed, so that the direct
+          part is a dot product of two contiguous arrays computed by
+          an explicit SIMD kernel (see detail::dot_product_dispatch).
+
+          The input history is not stored here: compute() reads it
+          from a contiguous window provided by the caller, so that
+          several convolutions of the same input can share it (see
+          core::convolution_bank).
+
+          A second, quadrature, impulse response can be convolved
+          along the first one (see set_quadrature()), giving a complex
+          output. It shares the input history and spectra, so that it
+          only adds its direct part and its inverse transform.
+
+          \tparam Scalar  Type of the scalars.
+        */
+        template<class Scalar>
+        class partitioned_convolution
+        {
+        public:
+            //! Impulse responses up to that length are convolved directly
+            /*!
+              Below it, the vectorized direct convolution is faster
+              than the FFT one, whatever the block size.
+            */
+            static constexpr std::size_t direct_size = 512;
+
+            //! Partition an impulse response
+            /*!
+              \param ir          The impulse response.
+              \param block_size  Length of the partitions, rounded up to
+              a power of 2. 0 or a length greater than the impulse
+              response gives a single partition, as well as impulse
+              responses shorter than direct_size.
+            */
+            partitioned_convolution(const std::vector<Scalar>& ir, const std::size_t& block_size)
+                : m_size(ir.size()), m_kernel(simd::best())
+                {
+                    const std::size_t n = ir.size();
+                    m_block = partition_size(n, block_size);
+                    m_partitions = (n + m_block - 1) / m_block;
+
+                    if(m_partitions > 1)
+                    {
+                        const std::size_t bins = m_block + 1;
+                        m_fft = fft<Scalar>(2*m_block);
+                        m_spectra_re.resize((m_partitions - 1) * bins);
+                        m_spectra_im.resize((m_partitions - 1) * bins);
+                        m_acc_re.resize(bins);
+                        m_acc_im.resize(bins);
+                        m_time.resize(2*m_block);
+                    }
+                    partition(ir, m_real);
+
+                    m_analytic = false;
+                    reset();
+                }
+
+            //! An empty convolution, to be assigned
+            partitioned_convolution()
+                : m_size(0), m_block(1), m_partitions(0), m_analytic(false),
+                  m_position(0), m_kernel(simd::best()), m_ring(0)
+                {}
+
+            //! The partitions length of an impulse response of *size* samples
+            /*!
+              As block_size() for the constructor arguments: a power of
+              2, or the whole impulse response.
+            */
+            static std::size_t partition_size(const std::size_t& size, const std::size_t& block_size){
+                std::size_t block = 1;
+                while(block < block_size) block *= 2;
+                if(block_size == 0 || block >= size || size <= direct_size)
+                    block = std::max<std::size_t>(size, 1);
+                return block;
+            }
+
+            //! Length of the impulse response
+            std::size_t size() const{
+                return m_size;
+            }
+
+            //! Length of the directly convolved partition
+            std::size_t block_size() const{
+                return m_block;
+            }
+
+            //! Number of partitions of the impulse response
+            std::size_t nb_partitions() const{
+                return m_partitions;
+            }
+
+            //! Number of input samples read by compute(), the current one included
+            std::size_t window_size() const{
+                return m_partitions > 1 ? 2*m_block : m_block;
+            }
+
+            //! The instruction set of the direct convolution kernel
+            simd::isa kernel() const{
+                return m_kernel;
+            }
+
+            //! Force the instruction set of the direct convolution kernel
+            /*!
+              \return false if it is not supported by the CPU, in which
+              case the current kernel is kept.
+            */
+            bool set_kernel(const simd::isa& kernel){
+                if(! simd::supported(kernel)) return false;
+                m_kernel = kernel;
+                return true;
+            }
+
+            //! Position of the next sample in the current block
+            std::size_t position() const{
+                return m_position;
+            }
+
+            //! True if a quadrature impulse response is convolved
+            bool analytic() const{
+                return m_analytic;
+            }
+
+            //! Convolve a quadrature impulse response as well
+            /*!
+              Its contribution to the current block is found from the
+              spectra of the past input blocks, so that it may be set
+              at any time: the outputs of compute_complex() are then the
+              same as if it had been set from the beginning.
+
+              \param ir  The quadrature impulse response, of the same
+              length as the one given at construction.
+            */
+            void set_quadrature(const std::vector<Scalar>& ir){
+                partition(ir, m_quadrature);
+                m_quadrature.tail.assign(m_block, 0);
+                if(m_partitions > 1)
+                {
+                    // the ring still holds the spectra of the last block
+                    const std::size_t slots = m_partitions - 1;
+                    accumulate(m_quadrature, (m_ring + slots - 1) % slots);
+                }
+                m_analytic = true;
+            }
+
+            //! Forget the past input
+            void reset(){
+                m_position = 0;
+                m_real.tail.assign(m_block, 0);
+                m_quadrature.tail.assign(m_analytic ? m_block : 0, 0);
+                std::fill(m_spectra_re.begin(), m_spectra_re.end(), Scalar(0));
+                std::fill(m_spectra_im.begin(), m_spectra_im.end(), Scalar(0));
+                m_ring = 0;
+            }
+
+            //! Number of scalars in the spectrum of a window, 0 with a single partition
+            std::size_t spectrum_size() const{
+                return m_partitions > 1 ? 2*(m_block + 1) : 0;
+            }
+
+            //! Compute the spectrum of a window of input
+            /*!
+              The spectrum only depends on the input, so that it can be
+              computed once for several convolutions of the same block
+              size and given to compute().
+
+              \param window    Pointer to window_size() input samples.
+              \param spectrum  Pointer to spectrum_size() scalars, the
+              real parts of the bins followed by the imaginary ones.
+            */
+            void transform(const Scalar* window, Scalar* spectrum){
+                m_fft.forward(window, spectrum, spectrum + m_block + 1);
+            }
+
+            //! Compute the output of the current input sample
+            /*!
+              \param current   Pointer to the current input sample. The
+              block_size()-1 previous samples must be stored just
+              before it, and the window_size()-1 previous ones at the
+              end of a block (when position() is block_size()-1).
+              \param spectrum  If not null at the end of a block, the
+              spectrum of the window ending at current (see transform()),
+              which is otherwise computed here.
+            */
+            inline Scalar compute(const Scalar* current, const Scalar* spectrum = nullptr){
+                const Scalar output = direct(m_real, current);
+                next(current, spectrum);
+                return output;
+            }
+
+            //! As compute(), for the convolutions by both impulse responses
+            /*!
+              The real part is the output of compute(), the imaginary
+              part the one of the quadrature impulse response.
+
+              \attention set_quadrature() must have been called.
+            */
+            inline std::complex<Scalar> compute_complex(const Scalar* current,
+                                                        const Scalar* spectrum = nullptr){
+                const std::complex<Scalar> output(direct(m_real, current),
+                                                  direct(m_quadrature, current));
+                next(current, spectrum);
+                return output;
+            }
+
+        private:
+            //! An impulse response, partitioned
+            struct response
+            {
+                //! First partition, reversed
+                std::vector<Scalar> head;
+
+                //! Spectra of the partitions 1 to P-1, scaled by 1/2B
+                std::vector<Scalar> filter_re, filter_im;
+
+                //! Contribution of the partitions 1 to P-1 to the current block
+                std::vector<Scalar> tail;
+            };
+
+            //! Split an impulse response in partitions
+            void partition(const std::vector<Scalar>& ir, response& r){
+                const std::size_t n = ir.size();
+
+                r.head.assign(m_block, 0);
+                for(std::size_t k = 0; k < std::min(n, m_block); ++k)
+                    r.head[m_block - 1 - k] = ir[k];
+
+                if(m_partitions > 1)
+                {
+                    const std::size_t bins = m_block + 1;
+                    r.filter_re.resize((m_partitions - 1) * bins);
+                    r.filter_im.resize((m_partitions - 1) * bins);
+
+                    // partition p padded with B zeros, inverse
+                    // transform normalization included
+                    for(std::size_t p = 1; p < m_partitions; ++p)
+                    {
+                        std::fill(m_time.begin(), m_time.end(), Scalar(0));
+                        const std::size_t first = p*m_block, last = std::min(n, first + m_block);
+                        for(std::size_t k = first; k < last; ++k)
+                            m_time[k - first] = ir[k] / (2*m_block);
+
+                        const std::size_t offset = (p - 1) * bins;
+                        m_fft.forward(m_time.data(), r.filter_re.data() + offset,
+                                      r.filter_im.data() + offset);
+                    }
+                }
+            }
+
+            //! Output of an impulse response for the current input sample
+            inline Scalar direct(const response& r, const Scalar* current) const{
+                // the B last samples, oldest first, with the reversed first partition
+                const Scalar* first = current + 1 - m_block;
+                return dot_product_dispatch(m_kernel, first, r.head.data(), m_block)
+                    + r.tail[m_position];
+            }
+
+            //! Move to the next input sample
+            inline void next(const Scalar* current, const Scalar* spectrum){
+                if(++m_position == m_block)
+                {
+                    if(m_partitions > 1) end_block(current + 1 - 2*m_block, spectrum);
+                    m_position = 0;
+                }
+            }
+
+            //! Compute the FFT contribution to the next block of outputs
+            /*!
+              \param window    The 2B last input samples.
+              \param spectrum  Their spectrum, or null.
+            */
+            inline void end_block(const Scalar* window, const Scalar* spectrum){
+                const std::size_t bins = m_block + 1, slots = m_partitions - 1;
+
+                // spectrum of the last two blocks
+                const std::size_t current = m_ring * bins;
+                if(spectrum)
+                {
+                    std::copy(spectrum, spectrum + bins, m_spectra_re.begin() + current);
+                    std::copy(spectrum + bins, spectrum + 2*bins, m_spectra_im.begin() + current);
+                }
+                else
+                    m_fft.forward(window, m_spectra_re.data() + current, m_spectra_im.data() + current);
+
+                accumulate(m_real, m_ring);
+                if(m_analytic) accumulate(m_quadrature, m_ring);
+                m_ring = (m_ring + 1) % slots;
+            }
+
+            //! Compute the tail of a response, the last input spectrum being in a slot
+            inline void accumulate(response& r, const std::size_t& last){
+                const std::size_t bins = m_block + 1, slots = m_partitions - 1;
+
+                // partition p meets the input block p blocks before the next one
+                std::fill(m_acc_re.begin(), m_acc_re.end(), Scalar(0));
+                std::fill(m_acc_im.begin(), m_acc_im.end(), Scalar(0));
+                for(std::size_t p = 1; p < m_partitions; ++p)
+                {
+                    const std::size_t slot = (last + slots - (p - 1)) % slots;
+                    const Scalar* hre = r.filter_re.data() + (p - 1) * bins;
+                    const Scalar* him = r.filter_im.data() + (p - 1) * bins;
+                    const Scalar* xre = m_spectra_re.data() + slot * bins;
+                    const Scalar* xim = m_spectra_im.data() + slot * bins;
+                    for(std::size_t k = 0; k < bins; ++k)
+                    {
+                        m_acc_re[k] += hre[k]*xre[k] - him[k]*xim[k];
+                        m_acc_im[k] += hre[k]*xim[k] + him[k]*xre[k];
+                    }
+                }
+
+                // overlap-save: the last B samples are the valid ones
+                m_fft.inverse(m_acc_re.data(), m_acc_im.data(), m_time.data());
+                std::copy(m_time.begin() + m_block, m_time.end(), r.tail.begin());
+            }
+
+            //! Length of the impulse response
+            std::size_t m_size;
+
+            //! Length B of the partitions
+            std::size_t m_block;
+
+            //! Number P of partitions
+            std::size_t m_partitions;
+
+            //! The impulse response and the quadrature one
+            response m_real, m_quadrature;
+
+            //! True if the quadrature impulse response is convolved
+            bool m_analytic;
+
+            //! Position of the next sample in the current block
+            std::size_t m_position;
+
+            //! Instruction set of the direct convolution kernel
+            simd::isa m_kernel;
+
+            //! Transforms of 2B samples
+            fft<Scalar> m_fft;
+
+            //! Spectra of the P-1 last input blocks, in a ring
+            std::vector<Scalar> m_spectra_re, m_spectra_im;
+
+            //! Position of the next spectrum in the ring
+            std::size_t m_ring;
+
+            //! Work buffers of end_block()
+            std::vector<Scalar> m_acc_re, m_acc_im, m_time;
+        };
+    }
+}
+
+template<class Scalar>
+constexpr std::size_t gammatone::detail::partitioned_convolution<Scalar>::direct_size;
+
+#endif // GAMMATONE_DETAIL_PARTITIONED_CONVOLUTION_HPP
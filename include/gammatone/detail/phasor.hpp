@@ -0,0 +1,151 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_PHASOR_HPP
+#define GAMMATONE_DETAIL_PHASOR_HPP
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <type_traits>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Periodic resynchronization of a rotating phasor
+        /*!
+          \class phasor gammatone/detail/phasor.hpp
+
+          A recursive core rotates its phasor \f$ q_n = e^{-j\omega n} \f$
+          by a complex multiplication at each sample. Each
+          multiplication rounds the magnitude and the phase of q, and
+          the rounded rotation has a phase error too, so that the
+          errors grow with the number of samples. In single precision
+          they are significant after a few seconds of signal.
+
+          This class keeps a reference phasor in at least double
+          precision, rotated by \f$ e^{-j\omega K} \f$ and renormalized
+          every K = period samples. The core resets its phasor on the
+          reference every K samples, the error of the phasor is then
+          bounded by K times the rounding error of a rotation, whatever
+          the signal duration.
+
+          \tparam Scalar  Type of the phasor of the core.
+        */
+        template<class Scalar>
+        class phasor
+        {
+        public:
+            //! Type of the reference phasor, at least double precision
+            using value_type = typename std::common_type<Scalar,double>::type;
+
+            //! Number K of samples between two resynchronizations
+            static constexpr std::size_t period = 256;
+
+            //! Creates a phasor rotating by \f$ -\omega \f$ rad per sample
+            explicit phasor(const value_type& omega = 0)
+                : m_step(std::cos(omega*period), -std::sin(omega*period))
+                {
+                    reset();
+                }
+
+            //! Back to \f$ q_0 = 1 \f$
+            void reset(){
+                m_reference = std::complex<value_type>(1, 0);
+                m_count = 0;
+            }
+
+            //! Number of samples before the next resynchronization
+            std::size_t remaining() const{
+                return period - m_count;
+            }
+
+            //! Count *n* rotations of q, resynchronizing it if needed
+            /*!
+              \param n  Number of rotations since the last call, at
+              most remaining().
+              \param q  The phasor of the core, set to the reference
+              after period rotations.
+              \return true if q has been resynchronized.
+            */
+            bool advance(const std::size_t& n, std::complex<Scalar>& q){
+                m_count += n;
+                if(m_count < period) return false;
+
+                m_count = 0;
+                m_reference *= m_step;
+                // one Newton step towards |reference| = 1
+                m_reference *= (value_type(3) - std::norm(m_reference)) / 2;
+                q = value();
+                return true;
+            }
+
+            //! As advance(), with real and imaginary parts split
+            bool advance(const std::size_t& n, Scalar& qre, Scalar& qim){
+                std::complex<Scalar> q(qre, qim);
+                if(! advance(n, q)) return false;
+                qre = q.real();
+                qim = q.imag();
+                return true;
+            }
+
+            //! The reference phasor at the last resynchronization
+            std::complex<Scalar> value() const{
+                return std::complex<Scalar>(Scalar(m_reference.real()), Scalar(m_reference.imag()));
+            }
+
+            //! Rotate q by n samples, as n single rotations would do
+            /*!
+              \param n       The number of samples.
+              \param q       The phasor of the core.
+              \param rotate  Function rotating q by one sample, as the
+              core does.
+            */
+            template<class Rotate>
+            void seek(const std::size_t& n, std::complex<Scalar>& q, const Rotate& rotate){
+                std::size_t left = n;
+                while(left >= remaining())
+                {
+                    left -= remaining();
+                    advance(remaining(), q);
+                }
+
+                // less than a period since the last resynchronization
+                for(std::size_t i = 0; i < left; ++i) rotate(q);
+                m_count += left;
+            }
+
+        private:
+            //! Rotation of the reference over K samples
+            std::complex<value_type> m_step;
+
+            //! The reference phasor
+            std::complex<value_type> m_reference;
+
+            //! Number of rotations of q since the last resynchronization
+            std::size_t m_count;
+        };
+    }
+}
+
+template<class Scalar>
+constexpr std::size_t gammatone::detail::phasor<Scalar>::period;
+
+#endif // GAMMATONE_DETAIL_PHASOR_HPP
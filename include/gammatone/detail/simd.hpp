@@ -0,0 +1,284 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_SIMD_HPP
+#define GAMMATONE_DETAIL_SIMD_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+// Explicit SIMD kernels are written with the GCC vector extensions
+// and compiled for several instruction sets in the same binary, the
+// kernel being selected at runtime. This is only enabled on x86 with
+// GCC compatible compilers, other platforms use the scalar code.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GAMMATONE_SIMD 1
+#endif
+
+#ifdef GAMMATONE_SIMD
+// Compile a function for a given instruction set. Floating point
+// contraction is disabled so that kernels give the same results
+// than the scalar code, whatever the instruction set.
+#if defined(__clang__)
+#define GAMMATONE_SIMD_TARGET(name) __attribute__((target(name)))
+#else
+#define GAMMATONE_SIMD_TARGET(name) __attribute__((target(name), optimize("fp-contract=off")))
+#endif
+#define GAMMATONE_SIMD_INLINE inline __attribute__((always_inline))
+
+// Enclose kernels code. Vector helpers are always inlined so the ABI
+// of wide vectors passed by value does not matter, silent GCC about it.
+#if defined(__clang__)
+#define GAMMATONE_SIMD_BEGIN
+#define GAMMATONE_SIMD_END
+#else
+#define GAMMATONE_SIMD_BEGIN                                    \
+    _Pragma("GCC diagnostic push")                              \
+    _Pragma("GCC diagnostic ignored \"-Wpsabi\"")
+#define GAMMATONE_SIMD_END _Pragma("GCC diagnostic pop")
+#endif
+#endif
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Runtime dispatched SIMD facilities
+        /*!
+          \namespace gammatone::detail::simd
+
+          This namespace provides the instruction set detection, the
+          vector types and the aligned allocator used by the
+          multi-channel engines. Kernels are compiled once for each
+          instruction set in simd::isa and the best one supported by
+          the CPU is selected at runtime.
+        */
+        namespace simd
+        {
+            //! Instruction sets for which kernels are compiled
+            enum class isa
+            {
+                scalar,  //!< Portable scalar code
+                sse2,    //!< 128 bits registers
+                avx2,    //!< 256 bits registers
+                avx512   //!< 512 bits registers
+            };
+
+            //! Return true if the running CPU supports an instruction set
+            inline bool supported(const isa& i){
+#ifdef GAMMATONE_SIMD
+                switch(i){
+                case isa::scalar: return true;
+                case isa::sse2:   return __builtin_cpu_supports("sse2");
+                case isa::avx2:   return __builtin_cpu_supports("avx2");
+                case isa::avx512: return __builtin_cpu_supports("avx512f");
+                }
+                return false;
+#else
+                return i == isa::scalar;
+#endif
+            }
+
+            //! Return the widest instruction set supported by the running CPU
+            inline isa best(){
+                // detection is done once
+                static const isa b =
+                    supported(isa::avx512) ? isa::avx512 :
+                    supported(isa::avx2) ? isa::avx2 :
+                    supported(isa::sse2) ? isa::sse2 :
+                    isa::scalar;
+                return b;
+            }
+
+            //! Return the width of the registers of an instruction set (in bytes)
+            inline std::size_t bytes(const isa& i){
+                switch(i){
+                case isa::sse2:   return 16;
+                case isa::avx2:   return 32;
+                case isa::avx512: return 64;
+                default:          return 0;
+                }
+            }
+
+            //! Maximal number of lanes in a vector of Scalar
+            template<class Scalar>
+            inline constexpr std::size_t max_lanes(){
+                return 64 / sizeof(Scalar);
+            }
+
+            //! Round a size up to a multiple of max_lanes()
+            /*!
+              Multi-channel engines pad their arrays to that size, so
+              that kernels never read out of bounds.
+            */
+            template<class Scalar>
+            inline std::size_t padded_size(const std::size_t& size){
+                const std::size_t w = max_lanes<Scalar>();
+                return (size + w - 1) / w * w;
+            }
+
+            //! True if explicit kernels are available for Scalar
+            template<class Scalar>
+            struct is_vectorizable
+            {
+#ifdef GAMMATONE_SIMD
+                static const bool value =
+                    std::is_same<Scalar,float>::value || std::is_same<Scalar,double>::value;
+#else
+                static const bool value = false;
+#endif
+            };
+
+#ifdef GAMMATONE_SIMD
+GAMMATONE_SIMD_BEGIN
+            //! Vector type of Scalar for a given register width (in bytes)
+            template<class Scalar, std::size_t Bytes> struct vector;
+
+            template<> struct vector<float,16>  {typedef float  type __attribute__((vector_size(16)));};
+            template<> struct vector<float,32>  {typedef float  type __attribute__((vector_size(32)));};
+            template<> struct vector<float,64>  {typedef float  type __attribute__((vector_size(64)));};
+            template<> struct vector<double,16> {typedef double type __attribute__((vector_size(16)));};
+            template<> struct vector<double,32> {typedef double type __attribute__((vector_size(32)));};
+            template<> struct vector<double,64> {typedef double type __attribute__((vector_size(64)));};
+
+            //! Number of lanes in a vector
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE constexpr std::size_t lanes(){
+                return sizeof(V) / sizeof(Scalar);
+            }
+
+            //! Load a vector from unaligned memory
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE V load(const Scalar* p){
+                V v;
+                std::memcpy(&v, p, sizeof(V));
+                return v;
+            }
+
+            //! Load the n first lanes of a vector, the others being null
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE V load(const Scalar* p, const std::size_t& n){
+                // lane by lane, see broadcast()
+                V v;
+                if(n == lanes<V,Scalar>())
+                {
+                    std::memcpy(&v, p, sizeof(V));
+                    return v;
+                }
+                for(std::size_t k = 0; k < lanes<V,Scalar>(); ++k) v[k] = k < n ? p[k] : Scalar(0);
+                return v;
+            }
+
+            //! Store a vector to unaligned memory
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE void store(Scalar* p, const V& v){
+                std::memcpy(p, &v, sizeof(V));
+            }
+
+            //! Store the n first lanes of a vector
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE void store(Scalar* p, const V& v, const std::size_t& n){
+                Scalar tmp[lanes<V,Scalar>()];
+                std::memcpy(tmp, &v, sizeof(V));
+                for(std::size_t k = 0; k < n; ++k) p[k] = tmp[k];
+            }
+
+            //! Store the n first lanes of a vector every stride scalars
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE void scatter(Scalar* p, const V& v, const std::size_t& n,
+                                               const std::size_t& stride){
+                Scalar tmp[lanes<V,Scalar>()];
+                std::memcpy(tmp, &v, sizeof(V));
+                for(std::size_t k = 0; k < n; ++k) p[k*stride] = tmp[k];
+            }
+
+            //! Return a vector with all lanes equal to x
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE V broadcast(const Scalar& x){
+                // lane by lane, as a vector operation here would make
+                // GCC warn about the ABI of the returned vector
+                // (-Wpsabi) at the end of the translation units of the
+                // users, out of GAMMATONE_SIMD_BEGIN/END
+                V v;
+                for(std::size_t k = 0; k < lanes<V,Scalar>(); ++k) v[k] = x;
+                return v;
+            }
+GAMMATONE_SIMD_END
+#endif
+
+            //! Allocator of memory aligned on cache lines
+            /*!
+              Used for the per-channel arrays of the multi-channel
+              engines. The default alignment of 64 bytes matches both
+              cache lines and the widest vector registers.
+
+              \tparam T          Type of allocated values
+              \tparam Alignment  Alignment in bytes, a power of 2
+            */
+            template<class T, std::size_t Alignment = 64>
+            class aligned_allocator
+            {
+            public:
+                using value_type = T;
+
+                template<class U> struct rebind {using other = aligned_allocator<U,Alignment>;};
+
+                aligned_allocator() noexcept {}
+
+                template<class U>
+                aligned_allocator(const aligned_allocator<U,Alignment>&) noexcept {}
+
+                T* allocate(const std::size_t& n){
+                    if(n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+                        throw std::bad_alloc();
+
+                    // allocate space for the data, the alignment and a
+                    // pointer to the raw memory stored just before data
+                    void* raw = std::malloc(n*sizeof(T) + Alignment + sizeof(void*));
+                    if(! raw) throw std::bad_alloc();
+
+                    const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+                    const std::uintptr_t aligned = (start + Alignment - 1) & ~(std::uintptr_t(Alignment) - 1);
+                    reinterpret_cast<void**>(aligned)[-1] = raw;
+                    return reinterpret_cast<T*>(aligned);
+                }
+
+                void deallocate(T* p, const std::size_t&) noexcept{
+                    if(p) std::free(reinterpret_cast<void**>(p)[-1]);
+                }
+            };
+
+            template<class T, class U, std::size_t A>
+            inline bool operator==(const aligned_allocator<T,A>&, const aligned_allocator<U,A>&){
+                return true;
+            }
+
+            template<class T, class U, std::size_t A>
+            inline bool operator!=(const aligned_allocator<T,A>&, const aligned_allocator<U,A>&){
+                return false;
+            }
+        }
+    }
+}
+
+#endif // GAMMATONE_DETAIL_SIMD_HPP
@@ -0,0 +1,377 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_SLANEY1993_SIMD_HPP
+#define GAMMATONE_DETAIL_SLANEY1993_SIMD_HPP
+
+#include <gammatone/detail/simd.hpp>
+#include <algorithm>
+#include <cstddef>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! The four biquads of a core::slaney1993 channel
+        /*!
+          Coefficients and states of stage k are at index k. The first
+          stage input is divided by gain.
+        */
+        template<class Scalar>
+        struct slaney1993_cascade
+        {
+            //! Coefficients, see core::slaney1993_iir
+            Scalar a0[4], a1[4], a2[4], b1[4], b2[4];
+
+            //! Input gain of the first stage
+            Scalar gain;
+
+            //! States
+            Scalar z1[4], z2[4];
+
+            //! Process one sample by stage k, as core::slaney1993_iir::compute()
+            inline Scalar step(const std::size_t& k, const Scalar& input){
+                const Scalar out = a0[k]*input + z1[k];
+                z1[k] = a1[k]*input - b1[k]*out + z2[k];
+                z2[k] = a2[k]*input - b2[k]*out;
+                return out;
+            }
+        };
+
+        //! Raw view on the arrays of a core::slaney1993_bank
+        /*!
+          All the arrays are padded to simd::padded_size(channels)
+          scalars, padding channels having null coefficients and a
+          unit gain. Index k of each field is the stage k.
+        */
+        template<class Scalar>
+        struct slaney1993_arrays
+        {
+            //! Number of actual channels
+            std::size_t channels;
+
+            //! Coefficients
+            const Scalar *gain, *a0[4], *a1[4], *a2[4], *b1[4], *b2[4];
+
+            //! States
+            Scalar *z1[4], *z2[4];
+        };
+
+        //! Scalar implementation of the slaney1993 kernels
+        /*!
+          Computes the channels in [first, last), the output of
+          channel j at sample i being written at
+          output[i*sample_stride + j*channel_stride].
+        */
+        template<class Scalar>
+        inline void slaney1993_scalar(const slaney1993_arrays<Scalar>& s,
+                                      const std::size_t& size,
+                                      const Scalar* input,
+                                      Scalar* output,
+                                      const std::size_t& sample_stride,
+                                      const std::size_t& channel_stride,
+                                      const std::size_t& first,
+                                      const std::size_t& last)
+        {
+            for(std::size_t i = 0; i < size; ++i)
+            {
+                Scalar* out = output + i*sample_stride;
+
+                for(std::size_t j = first; j < last; ++j)
+                {
+                    // as slaney1993::compute
+                    Scalar y = input[i] / s.gain[j];
+                    for(std::size_t k = 0; k < 4; ++k)
+                    {
+                        const Scalar x = y;
+                        y = s.a0[k][j]*x + s.z1[k][j];
+                        s.z1[k][j] = s.a1[k][j]*x - s.b1[k][j]*y + s.z2[k][j];
+                        s.z2[k][j] = s.a2[k][j]*x - s.b2[k][j]*y;
+                    }
+                    out[j*channel_stride] = y;
+                }
+            }
+        }
+
+#ifdef GAMMATONE_SIMD
+GAMMATONE_SIMD_BEGIN
+        namespace simd
+        {
+            //! Skewed pipeline kernel of a single slaney1993 channel
+            /*!
+              At step t the stage k processes the sample t-k, so that
+              the four stages are independent and advance together in
+              the four lanes of V, the output of stage k being shifted
+              to the input of stage k+1 for the next step. The first
+              and last 3 steps fill and drain the pipeline with scalar
+              code. Each stage computes the same operations as
+              core::slaney1993_iir::compute(), so that results are
+              identical to the scalar code.
+
+              \attention size must be at least 3.
+            */
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE void slaney1993_pipeline_kernel(slaney1993_cascade<Scalar>& c,
+                                                                   const Scalar* input,
+                                                                   Scalar* output,
+                                                                   const std::size_t& size)
+            {
+                // fill: stage k runs from step k
+                Scalar u[4];
+                for(std::size_t t = 0; t < 3; ++t)
+                {
+                    Scalar o[4];
+                    for(std::size_t k = 0; k <= t; ++k)
+                        o[k] = c.step(k, k ? u[k] : input[t] / c.gain);
+                    for(std::size_t k = 0; k <= t; ++k) u[k+1] = o[k];
+                }
+
+                const V a0 = load<V>(c.a0), a1 = load<V>(c.a1), a2 = load<V>(c.a2),
+                    b1 = load<V>(c.b1), b2 = load<V>(c.b2);
+                V z1 = load<V>(c.z1), z2 = load<V>(c.z2);
+
+                // steady state, output may be equal to input as the
+                // sample t-3 is written once t+1 has been read
+                V x = {size > 3 ? input[3] / c.gain : Scalar(0), u[1], u[2], u[3]};
+                for(std::size_t t = 3; t < size; ++t)
+                {
+                    const V out = a0*x + z1;
+                    z1 = a1*x - b1*out + z2;
+                    z2 = a2*x - b2*out;
+                    output[t-3] = out[3];
+
+                    const Scalar next = t + 1 < size ? input[t+1] / c.gain : Scalar(0);
+                    x = V{next, out[0], out[1], out[2]};
+                }
+                store(c.z1, z1);
+                store(c.z2, z2);
+
+                // drain: stage k runs up to step size-1+k
+                for(std::size_t k = 1; k < 4; ++k) u[k] = x[k];
+                for(std::size_t t = size; t < size + 3; ++t)
+                {
+                    Scalar o[4];
+                    for(std::size_t k = t - size + 1; k < 4; ++k) o[k] = c.step(k, u[k]);
+                    for(std::size_t k = t - size + 1; k < 3; ++k) u[k+1] = o[k];
+                    output[t-3] = o[3];
+                }
+            }
+
+            //! Generic kernel of a bank of slaney1993 channels on vectors of type V
+            /*!
+              Channels in [first, last) are processed by groups of
+              lanes<V,Scalar>(), each lane running the whole cascade of
+              a channel. The output of channel j at sample i is written
+              at output[i*sample_stride + j*channel_stride]. Operations
+              are the same, in the same order, than in
+              core::slaney1993::compute() so the results are identical
+              to the scalar code.
+            */
+            template<class V, class Scalar>
+            GAMMATONE_SIMD_INLINE void slaney1993_kernel(const slaney1993_arrays<Scalar>& s,
+                                                          const std::size_t& size,
+                                                          const Scalar* input,
+                                                          Scalar* output,
+                                                          const std::size_t& sample_stride,
+                                                          const std::size_t& channel_stride,
+                                                          const std::size_t& first,
+                                                          const std::size_t& last)
+            {
+                const std::size_t w = lanes<V,Scalar>();
+
+                for(std::size_t j = first; j < last; j += w)
+                {
+                    const std::size_t n = std::min(w, last - j);
+
+                    // only the n channels of the group are read and
+                    // written, a slice starting anywhere
+                    const V gain = load<V>(s.gain + j, n);
+                    V a0[4], a1[4], a2[4], b1[4], b2[4], z1[4], z2[4];
+                    for(std::size_t k = 0; k < 4; ++k)
+                    {
+                        a0[k] = load<V>(s.a0[k] + j, n); a1[k] = load<V>(s.a1[k] + j, n);
+                        a2[k] = load<V>(s.a2[k] + j, n);
+                        b1[k] = load<V>(s.b1[k] + j, n); b2[k] = load<V>(s.b2[k] + j, n);
+                        z1[k] = load<V>(s.z1[k] + j, n); z2[k] = load<V>(s.z2[k] + j, n);
+                    }
+
+                    Scalar* out = output + j*channel_stride;
+                    for(std::size_t i = 0; i < size; ++i, out += sample_stride)
+                    {
+                        V y = broadcast<V>(input[i]) / gain;
+                        for(std::size_t k = 0; k < 4; ++k)
+                        {
+                            const V x = y;
+                            y = a0[k]*x + z1[k];
+                            z1[k] = a1[k]*x - b1[k]*y + z2[k];
+                            z2[k] = a2[k]*x - b2[k]*y;
+                        }
+
+                        if(channel_stride != 1) scatter(out, y, n, channel_stride);
+                        else if(n == w) store(out, y);
+                        else store(out, y, n);
+                    }
+
+                    for(std::size_t k = 0; k < 4; ++k)
+                    {
+                        store(s.z1[k] + j, z1[k], n);
+                        store(s.z2[k] + j, z2[k], n);
+                    }
+                }
+            }
+
+            // Instances of the kernels for each instruction set. The
+            // pipeline needs 4 lanes only, avx512 uses the avx2 one.
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("sse2")
+            void slaney1993_pipeline_sse2(slaney1993_cascade<Scalar>& c, const Scalar* input,
+                                          Scalar* output, std::size_t size)
+            {
+                slaney1993_pipeline_kernel<typename vector<Scalar,4*sizeof(Scalar)>::type>(
+                    c, input, output, size);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx2")
+            void slaney1993_pipeline_avx2(slaney1993_cascade<Scalar>& c, const Scalar* input,
+                                          Scalar* output, std::size_t size)
+            {
+                slaney1993_pipeline_kernel<typename vector<Scalar,4*sizeof(Scalar)>::type>(
+                    c, input, output, size);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("sse2")
+            void slaney1993_sse2(const slaney1993_arrays<Scalar>& s, std::size_t size,
+                                 const Scalar* input, Scalar* output,
+                                 std::size_t sstride, std::size_t cstride,
+                                 std::size_t first, std::size_t last)
+            {
+                slaney1993_kernel<typename vector<Scalar,16>::type>(
+                    s, size, input, output, sstride, cstride, first, last);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx2")
+            void slaney1993_avx2(const slaney1993_arrays<Scalar>& s, std::size_t size,
+                                 const Scalar* input, Scalar* output,
+                                 std::size_t sstride, std::size_t cstride,
+                                 std::size_t first, std::size_t last)
+            {
+                slaney1993_kernel<typename vector<Scalar,32>::type>(
+                    s, size, input, output, sstride, cstride, first, last);
+            }
+
+            template<class Scalar>
+            GAMMATONE_SIMD_TARGET("avx512f")
+            void slaney1993_avx512(const slaney1993_arrays<Scalar>& s, std::size_t size,
+                                   const Scalar* input, Scalar* output,
+                                   std::size_t sstride, std::size_t cstride,
+                                   std::size_t first, std::size_t last)
+            {
+                slaney1993_kernel<typename vector<Scalar,64>::type>(
+                    s, size, input, output, sstride, cstride, first, last);
+            }
+        }
+GAMMATONE_SIMD_END
+#endif
+
+        //! Compute a single slaney1993 channel with the pipeline kernel
+        /*!
+          See simd::slaney1993_pipeline_kernel for the parameters.
+
+          \return false if no kernel for *i* is available or if size
+          is less than 3, in which case nothing is computed.
+        */
+        template<class Scalar>
+        inline typename std::enable_if<simd::is_vectorizable<Scalar>::value, bool>::type
+        slaney1993_pipeline_dispatch(const simd::isa& i, slaney1993_cascade<Scalar>& c,
+                                     const Scalar* input, Scalar* output, const std::size_t& size)
+        {
+#ifdef GAMMATONE_SIMD
+            if(size < 3) return false;
+            switch(i){
+            case simd::isa::sse2:
+                simd::slaney1993_pipeline_sse2(c, input, output, size);
+                return true;
+            case simd::isa::avx2:
+            case simd::isa::avx512:
+                simd::slaney1993_pipeline_avx2(c, input, output, size);
+                return true;
+            default: return false;
+            }
+#else
+            return false;
+#endif
+        }
+
+        template<class Scalar>
+        inline typename std::enable_if<! simd::is_vectorizable<Scalar>::value, bool>::type
+        slaney1993_pipeline_dispatch(const simd::isa&, slaney1993_cascade<Scalar>&,
+                                     const Scalar*, Scalar*, const std::size_t&)
+        {
+            return false;
+        }
+
+        //! Compute a bank of slaney1993 channels with a given kernel
+        /*!
+          See simd::slaney1993_kernel for the parameters.
+
+          \return false if no kernel for *i* is available, in which
+          case nothing is computed.
+        */
+        template<class Scalar>
+        inline typename std::enable_if<simd::is_vectorizable<Scalar>::value, bool>::type
+        slaney1993_dispatch(const simd::isa& i, const slaney1993_arrays<Scalar>& s,
+                            const std::size_t& size, const Scalar* input, Scalar* output,
+                            const std::size_t& sstride, const std::size_t& cstride,
+                            const std::size_t& first, const std::size_t& last)
+        {
+#ifdef GAMMATONE_SIMD
+            switch(i){
+            case simd::isa::sse2:
+                simd::slaney1993_sse2(s, size, input, output, sstride, cstride, first, last);
+                return true;
+            case simd::isa::avx2:
+                simd::slaney1993_avx2(s, size, input, output, sstride, cstride, first, last);
+                return true;
+            case simd::isa::avx512:
+                simd::slaney1993_avx512(s, size, input, output, sstride, cstride, first, last);
+                return true;
+            default: return false;
+            }
+#else
+            return false;
+#endif
+        }
+
+        template<class Scalar>
+        inline typename std::enable_if<! simd::is_vectorizable<Scalar>::value, bool>::type
+        slaney1993_dispatch(const simd::isa&, const slaney1993_arrays<Scalar>&,
+                            const std::size_t&, const Scalar*, Scalar*,
+                            const std::size_t&, const std::size_t&,
+                            const std::size_t&, const std::size_t&)
+        {
+            return false;
+        }
+    }
+}
+
+#endif // GAMMATONE_DETAIL_SLANEY1993_SIMD_HPP
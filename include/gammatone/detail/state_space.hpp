@@ -0,0 +1,202 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_STATE_SPACE_HPP
+#define GAMMATONE_DETAIL_STATE_SPACE_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! A dense square matrix, used for state space computations
+        /*!
+          \class square_matrix gammatone/detail/state_space.hpp
+
+          The recursive cores are linear systems whose state \f$ s \f$
+          evolves as \f$ s_{t+1} = A s_t + B x_t \f$. This small matrix
+          class allows to compute powers of the transition matrix
+          \f$ A \f$, to propagate a state over many samples at once.
+
+          \tparam Scalar  Type of the matrix elements
+        */
+        template<class Scalar>
+        class square_matrix
+        {
+        public:
+            //! Creates a null matrix of size n x n
+            explicit square_matrix(const std::size_t& n = 0)
+                : m_size(n), m_data(n*n, Scalar(0))
+                {}
+
+            //! Creates the n x n identity matrix
+            static square_matrix identity(const std::size_t& n){
+                square_matrix m(n);
+                for(std::size_t i = 0; i < n; ++i) m(i,i) = 1;
+                return m;
+            }
+
+            //! The number of rows (and columns)
+            std::size_t size() const{
+                return m_size;
+            }
+
+            //! Element at row i and column j
+            Scalar& operator()(const std::size_t& i, const std::size_t& j){
+                return m_data[i*m_size + j];
+            }
+
+            //! Element at row i and column j
+            const Scalar& operator()(const std::size_t& i, const std::size_t& j) const{
+                return m_data[i*m_size + j];
+            }
+
+            //! Matrix product
+            square_matrix operator*(const square_matrix& other) const{
+                square_matrix m(m_size);
+                for(std::size_t i = 0; i < m_size; ++i)
+                    for(std::size_t k = 0; k < m_size; ++k)
+                    {
+                        const Scalar x = (*this)(i,k);
+                        for(std::size_t j = 0; j < m_size; ++j)
+                            m(i,j) += x * other(k,j);
+                    }
+                return m;
+            }
+
+            //! Matrix-vector product
+            std::vector<Scalar> operator*(const std::vector<Scalar>& v) const{
+                std::vector<Scalar> r(m_size, Scalar(0));
+                for(std::size_t i = 0; i < m_size; ++i)
+                    for(std::size_t j = 0; j < m_size; ++j)
+                        r[i] += (*this)(i,j) * v[j];
+                return r;
+            }
+
+        private:
+            //! Number of rows and columns
+            std::size_t m_size;
+
+            //! Elements in row major order
+            std::vector<Scalar> m_data;
+        };
+
+
+        //! Return the e-th power of a square matrix
+        /*!
+          Computed by binary exponentiation, in O(log(e)) products.
+        */
+        template<class Scalar>
+        inline square_matrix<Scalar> power(square_matrix<Scalar> a, std::size_t e){
+            square_matrix<Scalar> r = square_matrix<Scalar>::identity(a.size());
+            while(e)
+            {
+                if(e & 1) r = r * a;
+                e >>= 1;
+                if(e) a = a * a;
+            }
+            return r;
+        }
+
+
+        //! Return the transition matrix of a linear system
+        /*!
+          The matrix is found by stepping a copy of the system from each
+          vector of the canonical basis, with a null input.
+
+          \tparam Scalar  Type of the scalars
+          \tparam System  A copyable type providing state(), set_state()
+          and compute(const Scalar&, Scalar&).
+        */
+        template<class Scalar, class System>
+        inline square_matrix<Scalar> transition_matrix(const System& system){
+            const std::size_t n = system.state().size();
+            square_matrix<Scalar> a(n);
+
+            for(std::size_t j = 0; j < n; ++j)
+            {
+                System s(system);
+                std::vector<Scalar> e(n, Scalar(0));
+                e[j] = 1;
+                s.set_state(e);
+
+                Scalar y;
+                s.compute(Scalar(0), y);
+
+                const std::vector<Scalar> column = s.state();
+                for(std::size_t i = 0; i < n; ++i) a(i,j) = column[i];
+            }
+            return a;
+        }
+
+
+        //! Facilities for recursions with a repeated real pole
+        /*!
+          A recursion with characteristic polynomial \f$ (1-rz^{-1})^N \f$
+          written in direct form has a state made of its N last outputs.
+          Its coefficients are so ill-conditioned that rounding them
+          moves the poles by about the N-th root of the rounding error,
+          out of the unit circle for low frequency channels in single
+          precision, and powers of its companion matrix have huge
+          entries of alternating signs.
+
+          The same system is thus computed as a cascade of N first
+          order sections \f$ v_k(t) = v_{k-1}(t) + r v_k(t-1) \f$, as
+          in core::cooke1993, whose state \f$ v_N \dots v_1 \f$ is
+          well conditioned.
+        */
+        namespace repeated_pole
+        {
+            //! The transition over n samples of a cascade of first order sections
+            /*!
+              Columns are found by running the cascade from each
+              vector of the basis, so that the transition is the one of
+              the actual (rounded) pole. These are natural responses of
+              the filter, computed as accurately as a sequential
+              processing, in O(n).
+
+              \param r  The repeated pole.
+              \param n  The number of samples.
+              \return The transition on the state \f$ (v_N \dots v_1) \f$.
+            */
+            template<class Scalar, std::size_t Order>
+            inline square_matrix<Scalar> transition(const Scalar& r, const std::size_t& n){
+                square_matrix<Scalar> t(Order);
+                for(std::size_t j = 0; j < Order; ++j)
+                {
+                    Scalar w[Order] = {};
+                    w[j] = 1;
+
+                    for(std::size_t i = 0; i < n; ++i)
+                    {
+                        w[Order-1] = r*w[Order-1];
+                        for(std::size_t k = Order - 1; k > 0; --k) w[k-1] = w[k] + r*w[k-1];
+                    }
+
+                    for(std::size_t i = 0; i < Order; ++i) t(i,j) = w[i];
+                }
+                return t;
+            }
+        }
+    }
+}
+
+#endif // GAMMATONE_DETAIL_STATE_SPACE_HPP
@@ -0,0 +1,157 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_STATIC_INTERFACE_HPP
+#define GAMMATONE_DETAIL_STATIC_INTERFACE_HPP
+
+#include <memory>  // for std::move
+#include <algorithm>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Statically dispatched interface for filters and filterbanks
+        /*!
+          \class static_interface gammatone/detail/static_interface.hpp
+
+          This class provides the same facilities as detail::interface,
+          but using the curiously recurring template pattern instead of
+          virtual methods: the Derived class is required to implement
+          center_frequency(), bandwidth(), gain(), reset(), compute()
+          and compute_ptr(), which are called here without any
+          indirection. Calls on a filter or a filterbank can thus be
+          inlined down to the processing core.
+
+          Runtime polymorphism is still available by wrapping a
+          concrete type in a gammatone::polymorphic adapter.
+
+          \tparam Derived  Type of the child class.
+          \tparam Scalar   Type of the scalar values.
+          \tparam Output   Type of accessors results, see detail::interface.
+        */
+        template<class Derived,
+                 class Scalar,
+                 class Output>
+        class static_interface
+        {
+        public:
+            //! Type of this class
+            using type = static_interface<Derived, Scalar, Output>;
+
+            //! Type of scalar input values
+            using scalar_type = Scalar;
+
+            //! Type of output values
+            // Scalar for filter, vector of Scalar for filterbank
+            using output_type = Output;
+
+            //! Constructor
+            explicit static_interface(const scalar_type& sample_frequency)
+                : m_sample_frequency(sample_frequency)
+                {}
+
+
+            //! Copy constructor
+            static_interface(const type& other)
+                : m_sample_frequency(other.m_sample_frequency)
+                {}
+
+
+            //! Move constructor
+            static_interface(type&& other) noexcept
+                : m_sample_frequency(std::move(other.m_sample_frequency))
+                {}
+
+
+            //! Assignment operator
+            type& operator=(const type& other){
+                type tmp(other);
+                std::swap(m_sample_frequency, tmp.m_sample_frequency);
+                return *this;
+            }
+
+
+            //! Move operator
+            type& operator=(type&& other){
+                m_sample_frequency = std::move(other.m_sample_frequency);
+                return *this;
+            }
+
+
+            //! Accessor to the sample frequency
+            /*!
+              Accessor to the processing sample frequency (Hz).
+              \return The sample frequency.
+            */
+            scalar_type sample_frequency() const{
+                return m_sample_frequency;
+            }
+
+
+            //! Compute a scalar output from a scalar input
+            /*!
+              Memory allocation for output, see detail::interface::compute_allocate.
+
+              \param input   The scalar value to be processed
+              \return The computed output value
+            */
+            output_type compute_allocate(const scalar_type& input){
+                output_type output;
+                derived().compute(input, output);
+                return output;
+            }
+
+
+            //! Compute an input iterator range
+            /*!
+              See detail::interface::compute_range.
+            */
+            template<class InputIterator, class OutputIterator>
+            inline void compute_range(const InputIterator& first,
+                                      const InputIterator& last,
+                                      const OutputIterator& result){
+                auto it = result;
+                Derived& d = derived();
+                std::for_each(
+                    first, last, [&](const scalar_type& x){d.compute(x, *it++);});
+            }
+
+        protected:
+            //! Not to be destroyed through a pointer to this class
+            ~static_interface(){}
+
+            //! Access to the child class
+            Derived& derived(){
+                return static_cast<Derived&>(*this);
+            }
+
+            //! Const access to the child class
+            const Derived& derived() const{
+                return static_cast<const Derived&>(*this);
+            }
+
+        private:
+            //! Processing sample frequency (Hz)
+            scalar_type m_sample_frequency;
+        };
+    }
+}
+
+#endif // GAMMATONE_DETAIL_STATIC_INTERFACE_HPP
@@ -0,0 +1,185 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_STREAM_ENGINE_HPP
+#define GAMMATONE_DETAIL_STREAM_ENGINE_HPP
+
+#include <gammatone/core/cooke1993.hpp>
+#include <gammatone/core/cooke1993_streams.hpp>
+#include <gammatone/detail/design_engine.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Processing engine of a multistream
+        /*!
+          \class stream_engine gammatone/detail/stream_engine.hpp
+
+          A multistream delegates the processing of its streams to a
+          stream engine. This generic engine holds a design_engine and
+          one of its states per stream, and computes the streams one
+          after the other, their inputs being gathered by blocks. The
+          coefficients are thus shared by the streams as far as the
+          design_engine of the core does: with core::slaney1993 a
+          stream only holds its recursion states, while with other
+          cores each stream holds a copy of the filters. The
+          specialization for core::cooke1993 moreover computes the
+          streams together.
+
+          \tparam Filter  Type of the filters in the bank.
+          \tparam Core    Type of the filters core, used for specialization.
+        */
+        template<class Filter, class Core = typename Filter::core>
+        class stream_engine
+        {
+        public:
+            //! Type of the scalars
+            using scalar_type = typename Filter::scalar_type;
+
+            //! Type of the underlying design engine
+            using design_type = design_engine<Filter>;
+
+            //! Creates an engine computing the channels on nb_streams inputs
+            stream_engine(const scalar_type& sample_frequency,
+                          const std::vector<scalar_type>& center_frequencies,
+                          const std::vector<scalar_type>& bandwidths,
+                          const std::size_t& nb_streams)
+                : m_design(sample_frequency, center_frequencies, bandwidths),
+                  m_states(nb_streams, m_design.make_state()),
+                  m_input(block)
+                {}
+
+            std::size_t nb_channels() const{
+                return m_design.nb_channels();
+            }
+
+            std::size_t nb_streams() const{
+                return m_states.size();
+            }
+
+            void reset(){
+                for(auto& s : m_states) s.reset();
+            }
+
+            //! Compute all the streams, see core::cooke1993_streams::compute_strided
+            inline void compute_strided(const std::size_t& size,
+                                        const scalar_type* input,
+                                        const std::size_t& input_sample_stride,
+                                        const std::size_t& input_stream_stride,
+                                        scalar_type* output,
+                                        const std::size_t& sample_stride,
+                                        const std::size_t& channel_stride,
+                                        const std::size_t& stream_stride){
+                for(std::size_t k = 0; k < nb_streams(); ++k)
+                    for(std::size_t done = 0; done < size; done += block)
+                    {
+                        const std::size_t n = std::min(size - done, block);
+                        const scalar_type* x = input + done*input_sample_stride + k*input_stream_stride;
+                        for(std::size_t i = 0; i < n; ++i)
+                            m_input[i] = x[i*input_sample_stride];
+
+                        m_design.compute_ptr(m_states[k], n, m_input.data(),
+                                             output + k*stream_stride + done*sample_stride,
+                                             sample_stride, channel_stride);
+                    }
+            }
+
+            //! Access to the design engine
+            const design_type& design() const{
+                return m_design;
+            }
+
+        private:
+            //! Number of samples of the gathered inputs
+            static constexpr std::size_t block = 1024;
+
+            //! The coefficients of the channels
+            design_type m_design;
+
+            //! The state of each stream
+            std::vector<typename design_type::state_type> m_states;
+
+            //! Gathered input of a stream
+            std::vector<scalar_type> m_input;
+        };
+
+        template<class Filter, class Core>
+        constexpr std::size_t stream_engine<Filter, Core>::block;
+
+
+        //! Stream engine specialization for core::cooke1993
+        /*!
+          Streams are computed by a core::cooke1993_streams.
+        */
+        template<class Filter, class Scalar, class GainPolicy, class ClippingPolicy>
+        class stream_engine<Filter, core::cooke1993<Scalar, GainPolicy, ClippingPolicy> >
+        {
+        public:
+            using scalar_type = Scalar;
+
+            //! Type of the underlying multi-stream core
+            using core_type = core::cooke1993_streams<Scalar, GainPolicy, ClippingPolicy>;
+
+            stream_engine(const scalar_type& sample_frequency,
+                          const std::vector<scalar_type>& center_frequencies,
+                          const std::vector<scalar_type>& bandwidths,
+                          const std::size_t& nb_streams)
+                : m_core(sample_frequency, center_frequencies, bandwidths, nb_streams)
+                {}
+
+            std::size_t nb_channels() const{
+                return m_core.nb_channels();
+            }
+
+            std::size_t nb_streams() const{
+                return m_core.nb_streams();
+            }
+
+            void reset(){
+                m_core.reset();
+            }
+
+            inline void compute_strided(const std::size_t& size,
+                                        const scalar_type* input,
+                                        const std::size_t& input_sample_stride,
+                                        const std::size_t& input_stream_stride,
+                                        scalar_type* output,
+                                        const std::size_t& sample_stride,
+                                        const std::size_t& channel_stride,
+                                        const std::size_t& stream_stride){
+                m_core.compute_strided(size, input, input_sample_stride, input_stream_stride,
+                                       output, sample_stride, channel_stride, stream_stride);
+            }
+
+            //! Access to the multi-stream core
+            core_type& core(){
+                return m_core;
+            }
+
+        private:
+            //! The multi-stream core
+            core_type m_core;
+        };
+    }
+}
+
+#endif // GAMMATONE_DETAIL_STREAM_ENGINE_HPP
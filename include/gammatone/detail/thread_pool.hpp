@@ -0,0 +1,303 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_THREAD_POOL_HPP
+#define GAMMATONE_DETAIL_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        inline std::vector<std::size_t> split(const std::size_t& size,
+                                              const std::size_t& n,
+                                              const std::size_t& alignment = 1);
+
+        //! A fixed size pool of worker threads
+        /*!
+          \class thread_pool gammatone/detail/thread_pool.hpp
+
+          Used by the parallel processing modes of filter and
+          filterbank. Tasks are pushed in a shared queue and executed by
+          the workers. The thread calling parallel_for() takes part in
+          the work while waiting for its tasks, so that a pool can be
+          used from within one of its tasks without deadlock.
+        */
+        class thread_pool
+        {
+        public:
+            //! Creates a pool of nb_threads workers
+            /*!
+              \param nb_threads  Number of worker threads. If 0, the
+              number of hardware threads minus one is used, the calling
+              thread being the last worker.
+            */
+            explicit thread_pool(std::size_t nb_threads = 0)
+                : m_stop(false)
+                {
+                    if(nb_threads == 0)
+                    {
+                        const std::size_t n = std::thread::hardware_concurrency();
+                        nb_threads = n > 1 ? n - 1 : 0;
+                    }
+
+                    m_workers.reserve(nb_threads);
+                    for(std::size_t k = 0; k < nb_threads; ++k)
+                        m_workers.emplace_back([this](){work();});
+                }
+
+            thread_pool(const thread_pool&) = delete;
+            thread_pool& operator=(const thread_pool&) = delete;
+
+            //! Wait for the workers to finish pending tasks
+            ~thread_pool(){
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stop = true;
+                }
+                m_condition.notify_all();
+                for(auto& w : m_workers) w.join();
+            }
+
+            //! Number of worker threads, the calling thread excluded
+            std::size_t size() const{
+                return m_workers.size();
+            }
+
+            //! Number of threads working in parallel_for()
+            std::size_t concurrency() const{
+                return size() + 1;
+            }
+
+            //! Call f(k) for k in [0, n) and wait for all the calls to return
+            /*!
+              Calls are distributed over the workers and the calling
+              thread, in an unspecified order.
+
+              \attention f must not throw.
+            */
+            template<class Function>
+            void parallel_for(const std::size_t& n, const Function& f){
+                if(n == 0) return;
+
+                // shared completion counter of this call
+                struct group
+                {
+                    std::mutex mutex;
+                    std::condition_variable done;
+                    std::size_t remaining;
+                } g;
+                g.remaining = n - 1;
+
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    for(std::size_t k = 1; k < n; ++k)
+                        m_tasks.emplace_back([&g, &f, k](){
+                                f(k);
+                                std::lock_guard<std::mutex> lock(g.mutex);
+                                if(--g.remaining == 0) g.done.notify_all();
+                            });
+                }
+                m_condition.notify_all();
+
+                // the calling thread does the first call, then helps
+                // with pending tasks until its own are done
+                f(0);
+                while(true)
+                {
+                    {
+                        std::lock_guard<std::mutex> lock(g.mutex);
+                        if(g.remaining == 0) return;
+                    }
+                    if(! run_pending())
+                    {
+                        std::unique_lock<std::mutex> lock(g.mutex);
+                        g.done.wait(lock, [&g](){return g.remaining == 0;});
+                        return;
+                    }
+                }
+            }
+
+            //! Call f(w, k) for k in [0, n), balanced by work stealing
+            /*!
+              The indices are split in nb_workers contiguous ranges,
+              each one owned by a worker running on parallel_for().
+              A worker calls f on its own range from the front and,
+              once it is empty, steals the back half of the range of
+              another worker. Indices should thus be sorted by
+              decreasing cost, the cheapest calls being stolen first.
+
+              Unlike parallel_for(), a single task per worker goes
+              through the shared queue, whatever n.
+
+              \param n           Number of calls.
+              \param nb_workers  Number of workers, at most concurrency()
+              are running at once. 0 means concurrency().
+              \param f           Callable as f(w, k), w in [0,
+              nb_workers) being the index of the calling worker, so
+              that f may use per-worker resources.
+
+              \attention f must not throw.
+            */
+            template<class Function>
+            void parallel_for_stealing(const std::size_t& n,
+                                       std::size_t nb_workers,
+                                       const Function& f){
+                if(n == 0) return;
+                if(nb_workers == 0) nb_workers = concurrency();
+                nb_workers = std::min(n, nb_workers);
+
+                // remaining indices of a worker, padded so that
+                // ranges are on different cache lines
+                struct range
+                {
+                    std::mutex mutex;
+                    std::size_t first, last;
+                    char padding[64];
+                };
+
+                const auto bounds = split(n, nb_workers);
+                std::vector<range> ranges(nb_workers);
+                for(std::size_t w = 0; w < nb_workers; ++w)
+                {
+                    ranges[w].first = bounds[w];
+                    ranges[w].last = bounds[w+1];
+                }
+
+                // take the front index of the range of w
+                auto pop = [&](const std::size_t& w, std::size_t& k){
+                    std::lock_guard<std::mutex> lock(ranges[w].mutex);
+                    if(ranges[w].first == ranges[w].last) return false;
+                    k = ranges[w].first++;
+                    return true;
+                };
+
+                // move the back half of another range to the one of w
+                auto steal = [&](const std::size_t& w){
+                    for(std::size_t i = 1; i < nb_workers; ++i)
+                    {
+                        range& victim = ranges[(w + i) % nb_workers];
+                        std::size_t first, last;
+                        {
+                            std::lock_guard<std::mutex> lock(victim.mutex);
+                            const std::size_t count = (victim.last - victim.first + 1) / 2;
+                            if(count == 0) continue;
+                            last = victim.last;
+                            first = last - count;
+                            victim.last = first;
+                        }
+                        std::lock_guard<std::mutex> lock(ranges[w].mutex);
+                        ranges[w].first = first;
+                        ranges[w].last = last;
+                        return true;
+                    }
+                    return false;
+                };
+
+                parallel_for(nb_workers, [&](const std::size_t& w){
+                        std::size_t k;
+                        do{
+                            while(pop(w, k)) f(w, k);
+                        }while(steal(w));
+                    });
+            }
+
+            //! A process-wide pool with one thread per hardware thread
+            static thread_pool& global(){
+                static thread_pool pool;
+                return pool;
+            }
+
+        private:
+            //! Run one pending task, return false if there is none
+            bool run_pending(){
+                std::function<void()> task;
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if(m_tasks.empty()) return false;
+                    task = std::move(m_tasks.front());
+                    m_tasks.pop_front();
+                }
+                task();
+                return true;
+            }
+
+            //! Main loop of the workers
+            void work(){
+                while(true)
+                {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        m_condition.wait(lock, [this](){return m_stop || ! m_tasks.empty();});
+                        if(m_tasks.empty()) return;
+                        task = std::move(m_tasks.front());
+                        m_tasks.pop_front();
+                    }
+                    task();
+                }
+            }
+
+            //! The worker threads
+            std::vector<std::thread> m_workers;
+
+            //! Pending tasks
+            std::deque<std::function<void()> > m_tasks;
+
+            //! Protect m_tasks and m_stop
+            std::mutex m_mutex;
+
+            //! Notify workers of new tasks
+            std::condition_variable m_condition;
+
+            //! True when the pool is destroyed
+            bool m_stop;
+        };
+
+
+        //! Split [0, size) in at most n contiguous slices
+        /*!
+          Slice boundaries are multiples of *alignment*, except the
+          last one which is size.
+
+          \return The n+1 boundaries of the slices (less if size is small).
+        */
+        inline std::vector<std::size_t> split(const std::size_t& size,
+                                              const std::size_t& n,
+                                              const std::size_t& alignment){
+            const std::size_t blocks = (size + alignment - 1) / alignment;
+            const std::size_t slices = std::max<std::size_t>(1, std::min(n, blocks));
+
+            std::vector<std::size_t> bounds(slices + 1);
+            for(std::size_t k = 0; k <= slices; ++k)
+                bounds[k] = std::min(size, (blocks * k / slices) * alignment);
+            return bounds;
+        }
+    }
+}
+
+#endif // GAMMATONE_DETAIL_THREAD_POOL_HPP
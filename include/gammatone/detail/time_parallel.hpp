@@ -0,0 +1,199 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_DETAIL_TIME_PARALLEL_HPP
+#define GAMMATONE_DETAIL_TIME_PARALLEL_HPP
+
+#include <gammatone/detail/thread_pool.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+namespace gammatone
+{
+    namespace detail
+    {
+        //! Exact time-parallel processing of a linear recursive system
+        /*!
+          The input is split in nb_chunks consecutive chunks processed
+          in parallel as follows:
+
+          - each chunk is first computed from a null state, giving its
+            zero-state final state \f$ z_k \f$ (the first chunk is
+            computed from the actual state and is final),
+
+          - the actual initial state of each chunk is then found by the
+            sequential prefix \f$ s_{k+1} = A^L s_k + z_k \f$, where
+            \f$ A \f$ is the system transition matrix and \f$ L \f$
+            the chunk length (\f$ A^L \f$ is computed along the first pass),
+
+          - each chunk but the first is finally computed again from its
+            actual initial state.
+
+          The result equals the sequential processing up to rounding
+          errors. At the end, *processor* is in the same state as after
+          a sequential processing of the whole input.
+
+          \tparam Processor  A copyable type providing state(),
+          set_state(state), seek(n) (advance the time dependent part of
+          the processor, if any, by n samples without processing),
+          transition(n) (return \f$ A^n \f$ in a processor specific
+          representation) and propagate(transition, state) (apply a
+          transition to a state).
+
+          \tparam Compute  Callable as compute(processor, first, count),
+          processing the samples [first, first+count) of the input.
+
+          \param processor  The processor to be used.
+          \param size       Number of samples in the input.
+          \param nb_chunks  Number of chunks. Processing is sequential for 1.
+          \param pool       The threads computing the chunks.
+          \param compute    The processing function.
+        */
+        template<class Processor, class Compute>
+        void compute_chunked(Processor& processor,
+                             const std::size_t& size,
+                             std::size_t nb_chunks,
+                             thread_pool& pool,
+                             const Compute& compute)
+        {
+            nb_chunks = std::max<std::size_t>(1, std::min(nb_chunks, size));
+            if(nb_chunks == 1)
+            {
+                compute(processor, 0, size);
+                return;
+            }
+
+            // chunks of equal length L, the last one being shorter
+            const std::size_t length = (size + nb_chunks - 1) / nb_chunks;
+            nb_chunks = (size + length - 1) / length;
+            auto first = [&](const std::size_t& k){return k*length;};
+            auto count = [&](const std::size_t& k){return std::min(length, size - k*length);};
+
+            // first pass from null states
+            using state_type = typename std::decay<decltype(processor.state())>::type;
+            state_type zero = processor.state();
+            std::fill(zero.begin(), zero.end(), 0);
+
+            std::vector<Processor> chunk(nb_chunks, processor);
+            for(std::size_t k = 1; k < nb_chunks; ++k)
+            {
+                chunk[k].set_state(zero);
+                chunk[k].seek(first(k));
+            }
+
+            // the transition over a chunk is computed in parallel
+            using transition_type = typename std::decay<decltype(processor.transition(length))>::type;
+            transition_type transition;
+
+            pool.parallel_for(nb_chunks + 1, [&](const std::size_t& k){
+                    if(k < nb_chunks) compute(chunk[k], first(k), count(k));
+                    else transition = processor.transition(length);
+                });
+
+            // prefix combination of the boundary states
+            std::vector<state_type> initial(nb_chunks);
+            initial[1] = chunk[0].state();
+            for(std::size_t k = 2; k < nb_chunks; ++k)
+            {
+                state_type s = initial[k-1];
+                processor.propagate(transition, s);
+
+                const state_type z = chunk[k-1].state();
+                for(std::size_t i = 0; i < s.size(); ++i) s[i] += z[i];
+                initial[k] = s;
+            }
+
+            // correction pass from actual states
+            pool.parallel_for(nb_chunks - 1, [&](const std::size_t& i){
+                    const std::size_t k = i + 1;
+                    chunk[k] = processor;
+                    chunk[k].set_state(initial[k]);
+                    chunk[k].seek(first(k));
+                    compute(chunk[k], first(k), count(k));
+                });
+
+            processor = chunk.back();
+        }
+
+
+        //! Approximate time-parallel processing with warm-up segments
+        /*!
+          The input is split in nb_chunks consecutive chunks computed
+          independently in parallel. Each chunk but the first starts
+          from a reset processor, which is first run on the *warmup*
+          samples preceding the chunk, their output being discarded.
+          A chunk starting within the first *warmup* samples is simply
+          computed from the initial state of *processor*, and is thus
+          exact.
+
+          For a stable system whose impulse response is negligible after
+          *warmup* samples, the error at chunk joins is the contribution
+          of the discarded past input, bounded by that negligible tail.
+          At the end, *processor* is in the state of the last chunk.
+
+          \tparam Processor  A copyable type providing reset().
+          \tparam Compute    Callable as compute(processor, first, count),
+          processing the samples [first, first+count) of the input.
+          \tparam Discard    As Compute, the output being discarded.
+
+          \param processor  The processor to be used.
+          \param size       Number of samples in the input.
+          \param nb_chunks  Number of chunks. Processing is sequential for 1.
+          \param warmup     Number of warm-up samples before each chunk.
+          \param pool       The threads computing the chunks.
+          \param compute    The processing function.
+          \param discard    The warm-up processing function.
+        */
+        template<class Processor, class Compute, class Discard>
+        void compute_overlapped(Processor& processor,
+                                const std::size_t& size,
+                                std::size_t nb_chunks,
+                                const std::size_t& warmup,
+                                thread_pool& pool,
+                                const Compute& compute,
+                                const Discard& discard)
+        {
+            nb_chunks = std::max<std::size_t>(1, std::min(nb_chunks, size));
+            if(nb_chunks == 1)
+            {
+                compute(processor, 0, size);
+                return;
+            }
+
+            const std::size_t length = (size + nb_chunks - 1) / nb_chunks;
+            nb_chunks = (size + length - 1) / length;
+
+            std::vector<Processor> chunk(nb_chunks, processor);
+            pool.parallel_for(nb_chunks, [&](const std::size_t& k){
+                    const std::size_t first = k*length;
+                    const std::size_t start = first > warmup ? first - warmup : 0;
+                    if(start > 0) chunk[k].reset();
+
+                    discard(chunk[k], start, first - start);
+                    compute(chunk[k], first, std::min(length, size - first));
+                });
+
+            processor = chunk.back();
+        }
+    }
+}
+
+#endif // GAMMATONE_DETAIL_TIME_PARALLEL_HPP
@@ -20,11 +20,17 @@
 #ifndef GAMMATONE_FILTER_HPP
 #define GAMMATONE_FILTER_HPP
 
-#include <gammatone/detail/interface.hpp>
+#include <gammatone/detail/static_interface.hpp>
+#include <gammatone/detail/impulse_response.hpp>
+#include <gammatone/detail/thread_pool.hpp>
+#include <gammatone/detail/time_parallel.hpp>
 #include <gammatone/core/cooke1993.hpp>  // default core
 #include <gammatone/policy/gain.hpp>
 #include <gammatone/policy/bandwidth.hpp>
 #include <gammatone/policy/clipping.hpp>
+#include <cmath>
+#include <complex>
+#include <vector>
 
 namespace gammatone
 {
@@ -47,7 +53,8 @@ namespace gammatone
         template<class> class BandwidthPolicy = policy::bandwidth::glasberg1990,
         class ClippingPolicy                  = policy::clipping::off
         >
-    class filter : public detail::interface<Scalar,Scalar>
+    class filter : public detail::static_interface<
+        filter<Scalar, Core, BandwidthPolicy, ClippingPolicy>, Scalar, Scalar>
     {
     public:
 
@@ -55,7 +62,7 @@ namespace gammatone
         using type = filter<Scalar, Core, BandwidthPolicy, ClippingPolicy>;
 
         //! Type of the inherited interface
-        using base = detail::interface<Scalar, Scalar>;
+        using base = detail::static_interface<type, Scalar, Scalar>;
 
         //! Type of the filter core
         using core = Core<Scalar, policy::gain::forall_0dB, ClippingPolicy>;
@@ -124,7 +131,7 @@ namespace gammatone
 
 
         //! Destructor
-        virtual ~filter(){}
+        ~filter(){}
 
         //! Inherited from interface
         inline Scalar center_frequency() const{
@@ -156,13 +163,163 @@ namespace gammatone
         inline void compute_ptr(const std::size_t& size,
                                 const Scalar* input,
                                 Scalar* output){
-            for(std::size_t i=0; i < size; ++i){
-                compute(input[i], output[i]);
-            }
+            m_core.compute_block(input, output, size);
+        }
+
+        //! Compute the analytic output from a scalar input
+        /*!
+          Only available for core::cooke1993 and core::convolution,
+          see compute_ptr_complex().
+
+          \param input   The scalar value to be processed
+          \param output  The computed analytic output
+        */
+        inline void compute_complex(const scalar_type& input, std::complex<Scalar>& output){
+            m_core.compute_block_complex(&input, &output, 1);
+        }
+
+        //! Compute analytic outputs from pointers
+        /*!
+          The real part of the analytic output is the output of
+          compute_ptr(), its imaginary part the one of the filter in
+          quadrature, so that its modulus is the envelope of the output
+          and its argument the instantaneous phase. Only available for
+          core::cooke1993, for which it costs two multiplies per sample
+          more than compute_ptr(), and core::convolution (see
+          core::convolution::compute_block_complex()).
+
+          \param size    Number of input samples.
+          \param input   Pointer to *size* input scalars.
+          \param output  Pointer to *size* output values.
+        */
+        inline void compute_ptr_complex(const std::size_t& size,
+                                        const Scalar* input,
+                                        std::complex<Scalar>* output){
+            m_core.compute_block_complex(input, output, size);
+        }
+
+        //! Compute the envelope of the output, the modulus of compute_ptr_complex()
+        inline void compute_ptr_envelope(const std::size_t& size,
+                                         const Scalar* input,
+                                         Scalar* output){
+            analytic(size, input, [&](const std::size_t& i, const std::complex<Scalar>& z){
+                    output[i] = std::sqrt(z.real()*z.real() + z.imag()*z.imag());});
+        }
+
+        //! Compute the instantaneous phase of the output, the argument of compute_ptr_complex()
+        /*!
+          The phase is in [-pi, pi], 0 at the maxima of the output.
+        */
+        inline void compute_ptr_phase(const std::size_t& size,
+                                      const Scalar* input,
+                                      Scalar* output){
+            analytic(size, input, [&](const std::size_t& i, const std::complex<Scalar>& z){
+                    output[i] = std::atan2(z.imag(), z.real());});
+        }
+
+        //! Offline processing, splitting the input in time chunks
+        /*!
+          The recursive cores (core::cooke1993 and core::slaney1993)
+          are linear systems. The input is thus split in chunks which
+          are computed in parallel from null states, the actual chunk
+          boundary states are then propagated with the core
+          transition over a chunk, and the chunks are finally computed
+          again in parallel from their actual states (see
+          detail::compute_chunked).
+
+          The result is the same as compute_ptr() up to rounding
+          errors, for about twice the total amount of work. Low
+          frequency channels of core::cooke1993 being very sensitive to
+          rounding, differences may reach 1e-8 of the output range in
+          double precision, which is the order of the rounding error of
+          compute_ptr() itself.
+
+          \param size       Number of input samples.
+          \param input      Pointer to *size* input scalars.
+          \param output     Pointer to *size* output scalars.
+          \param nb_chunks  Number of chunks, 0 means one per thread
+          in detail::thread_pool::global().
+        */
+        inline void compute_ptr_chunked(const std::size_t& size,
+                                        const Scalar* input,
+                                        Scalar* output,
+                                        const std::size_t& nb_chunks = 0){
+            auto& pool = detail::thread_pool::global();
+            detail::compute_chunked(
+                m_core, size, nb_chunks ? nb_chunks : pool.concurrency(), pool,
+                [&](core& c, const std::size_t& first, const std::size_t& count){
+                    c.compute_block(input + first, output + first, count);
+                });
+        }
+
+        //! Number of samples for the impulse response to decay by *attenuation* dB
+        /*!
+          Found on the theoretical impulse response, see
+          detail::impulse_response::theorical_attenuate. The length
+          is bounded by 1 s of signal.
+
+          \param attenuation  The attenuation level (dB), negative.
+        */
+        inline std::size_t decay_length(const Scalar& attenuation) const{
+            return detail::impulse_response::theorical_attenuate(*this, attenuation).size();
+        }
+
+        //! Approximate offline processing, in independent time chunks
+        /*!
+          The input is split in chunks computed independently in
+          parallel, each chunk being preceded by a warm-up segment of
+          decay_length(attenuation) samples whose output is discarded
+          (see detail::compute_overlapped). This works for every
+          core, with a near linear speedup.
+
+          The error at chunk joins is the response to the input
+          preceding the warm-up, bounded by the impulse response tail:
+          it is about *attenuation* dB below the output range. The
+          first chunk, and every chunk within the first warm-up,
+          are exact.
+
+          \param size         Number of input samples.
+          \param input        Pointer to *size* input scalars.
+          \param output       Pointer to *size* output scalars.
+          \param attenuation  Warm-up attenuation level (dB), negative.
+          \param nb_chunks    Number of chunks, 0 means one per thread
+          in detail::thread_pool::global().
+        */
+        inline void compute_ptr_overlapped(const std::size_t& size,
+                                           const Scalar* input,
+                                           Scalar* output,
+                                           const Scalar& attenuation = -120,
+                                           const std::size_t& nb_chunks = 0){
+            auto& pool = detail::thread_pool::global();
+            detail::compute_overlapped(
+                m_core, size, nb_chunks ? nb_chunks : pool.concurrency(),
+                decay_length(attenuation), pool,
+                [&](core& c, const std::size_t& first, const std::size_t& count){
+                    c.compute_block(input + first, output + first, count);
+                },
+                [&](core& c, const std::size_t& first, const std::size_t& count){
+                    std::vector<Scalar> buffer(count);
+                    c.compute_block(input + first, buffer.data(), count);
+                });
         }
 
 
     private:
+        //! Number of samples of the analytic outputs buffered by analytic()
+        static constexpr std::size_t analytic_block = 256;
+
+        //! Compute analytic outputs by blocks, calling output(i, z) for each sample i
+        template<class Output>
+        inline void analytic(const std::size_t& size, const Scalar* input, const Output& output){
+            std::complex<Scalar> buffer[analytic_block];
+            for(std::size_t done = 0; done < size; done += analytic_block)
+            {
+                const std::size_t n = size - done < analytic_block ? size - done : analytic_block;
+                m_core.compute_block_complex(input + done, buffer, n);
+                for(std::size_t k = 0; k < n; ++k) output(done + k, buffer[k]);
+            }
+        }
+
         //! Filter center frequency (Hz)
         Scalar m_center_frequency;
 
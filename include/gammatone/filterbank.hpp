@@ -20,7 +20,10 @@
 #ifndef GAMMATONE_FILTERBANK_HPP
 #define GAMMATONE_FILTERBANK_HPP
 
-#include <gammatone/detail/interface.hpp>
+#include <gammatone/detail/static_interface.hpp>
+#include <gammatone/detail/bank_engine.hpp>
+#include <gammatone/detail/thread_pool.hpp>
+#include <gammatone/layout.hpp>
 #include <gammatone/filter.hpp>
 #include <gammatone/core/cooke1993.hpp>
 #include <gammatone/policy/channels.hpp>
@@ -29,6 +32,8 @@
 #include <gammatone/policy/clipping.hpp>
 
 #include <algorithm>
+#include <cmath>
+#include <complex>
 #include <vector>
 
 namespace gammatone
@@ -39,6 +44,13 @@ namespace gammatone
 
       Implementation of a gammatone filterbank.
 
+      The filterbank exposes its channels as an array of
+      gammatone::filter, but the processing itself is delegated to a
+      detail::bank_engine, which may implement all the channels at
+      once (see core::cooke1993_bank and core::slaney1993_bank). The
+      filters accessed through iterators thus describe the channels,
+      but their internal state is not the one of the filterbank.
+
       \tparam Scalar           Type of scalar values
       \tparam Core             See gammatone::core
       \tparam ChannelsPolicy   See policy::channels
@@ -55,7 +67,9 @@ namespace gammatone
         template<class> class BandwidthPolicy                      = policy::bandwidth::glasberg1990,
         class ClippingPolicy                                       = policy::clipping::off
         >
-    class filterbank : public detail::interface<Scalar, std::vector<Scalar> >
+    class filterbank : public detail::static_interface<
+        filterbank<Scalar, Core, ChannelsPolicy, GainPolicy, BandwidthPolicy, ClippingPolicy>,
+        Scalar, std::vector<Scalar> >
     {
     public:
 
@@ -64,7 +78,7 @@ namespace gammatone
                                 BandwidthPolicy, ClippingPolicy>;
 
         //! Type of the inherited interface
-        using base_type = detail::interface<Scalar, std::vector<Scalar>>;
+        using base_type = detail::static_interface<type, Scalar, std::vector<Scalar>>;
 
         //! Type of the scalars
         using scalar_type = Scalar;
@@ -96,6 +110,9 @@ namespace gammatone
         //! Reverse iterator on filters
         using reverse_iterator = typename bank_type::reverse_iterator;
 
+        //! Type of the processing engine
+        using engine_type = detail::bank_engine<filter_type>;
+
         //! Create a gammatone filterbank from explicit parameters.
         /*!
           \param sample_frequency    The sample frequency of the input signal (Hz)
@@ -110,22 +127,17 @@ namespace gammatone
                    const Scalar& low_frequency,
                    const Scalar& high_frequency,
                    const typename channels::param_type& channels_parameter = channels::default_parameter())
-            : base_type(sample_frequency)
-            {
-                const auto p = ChannelsPolicy<Scalar, BandwidthPolicy>
-                    ::setup(low_frequency, high_frequency, channels_parameter);
-
-                m_overlap = p.second;
-                std::for_each(p.first.begin(), p.first.end(), [&](const Scalar& f)
-                              {m_bank.push_back(filter_type(sample_frequency,f));});
-            }
+            : filterbank(sample_frequency,
+                         channels::setup(low_frequency, high_frequency, channels_parameter))
+            {}
 
 
         //! Copy constructor
         filterbank(const type& other)
             : base_type(other.sample_frequency()),
               m_overlap(other.m_overlap),
-              m_bank(other.m_bank)
+              m_bank(other.m_bank),
+              m_engine(other.m_engine)
             {}
 
 
@@ -133,7 +145,8 @@ namespace gammatone
         filterbank(type&& other)
             : base_type(other.sample_frequency()),
               m_overlap(std::move(other.m_overlap)),
-              m_bank(std::move(other.m_bank))
+              m_bank(std::move(other.m_bank)),
+              m_engine(std::move(other.m_engine))
             {}
 
 
@@ -144,6 +157,7 @@ namespace gammatone
 
                 std::swap(m_overlap, tmp.m_overlap );
                 std::swap(m_bank, tmp.m_bank );
+                std::swap(m_engine, tmp.m_engine );
 
                 return *this;
             }
@@ -154,13 +168,14 @@ namespace gammatone
             {
                 this->m_overlap = std::move(other.m_overlap);
                 this->m_bank = std::move(other.m_bank);
+                this->m_engine = std::move(other.m_engine);
 
                 return *this;
             }
 
 
         //! Destructor.
-        virtual ~filterbank(){}
+        ~filterbank(){}
 
         // Inherited accessor to center frequencies. It actually allocate
         // the output and access to each filter's own center_frequency()
@@ -190,10 +205,12 @@ namespace gammatone
         }
 
 
-        // Inherited reset method. Simple delegation to each filter.
+        // Inherited reset method. Simple delegation to each filter and
+        // to the engine.
         void reset(){
             std::for_each(this->begin(), this->end(),
                           [](filter_type& f){f.reset();});
+            m_engine.reset();
         }
 
 
@@ -279,22 +296,207 @@ namespace gammatone
           for at least *nb_channels()* elements.
         */
         inline void compute(const scalar_type& input, output_type& output){
-            for(std::size_t i=0; i<nb_channels(); ++i){
-                m_bank[i].compute(input, output[i]);
-            }
+            m_engine.compute(input, output.data());
         }
 
         //! Compute scalar values from pointer
-        // TODO comment and add a row='frequency' or row='time' option.
+        /*!
+          \param size    Number of input samples.
+          \param input   Pointer to *size* input scalars.
+          \param output  Pointer to *size x nb_channels()* output
+          scalars, the output of channel j at sample i being
+          output[i*nb_channels()+j].
+        */
         inline void compute_ptr(const std::size_t& size,
                                 const Scalar* input,
                                 Scalar* output){
-            for(std::size_t i=0;i<size;++i){
-                const std::size_t k = i*nb_channels();
-                for(std::size_t j=0;j<nb_channels();++j){
-                    m_bank[j].compute(input[i], output[j+k]);
-                }
-            }
+            m_engine.compute_ptr(size, input, output);
+        }
+
+        //! Compute scalar values from pointer with a given output layout
+        /*!
+          As compute_ptr(), output being stored with the layout *l*.
+        */
+        inline void compute_ptr(const std::size_t& size,
+                                const Scalar* input,
+                                Scalar* output,
+                                const layout& l){
+            m_engine.compute_ptr(size, input, output,
+                                 detail::sample_stride(l, size, nb_channels()),
+                                 detail::channel_stride(l, size, nb_channels()),
+                                 0, nb_channels());
+            m_engine.advance(size, input);
+        }
+
+        //! Compute scalar values from pointer on several threads
+        /*!
+          Channels are split in contiguous slices computed in parallel
+          over the whole input on the threads of
+          detail::thread_pool::global(). The result is the same as
+          compute_ptr(size, input, output, l).
+
+          \param size        Number of input samples.
+          \param input       Pointer to *size* input scalars.
+          \param output      Pointer to *size x nb_channels()* output scalars.
+          \param l           The layout of output.
+          \param nb_threads  Maximal number of slices, 0 means one per
+          thread in the pool.
+
+          \note The planar layout avoids threads writing to the same
+          cache lines in output.
+        */
+        inline void compute_ptr_parallel(const std::size_t& size,
+                                         const Scalar* input,
+                                         Scalar* output,
+                                         const layout& l = layout::interleaved,
+                                         const std::size_t& nb_threads = 0){
+            auto& pool = detail::thread_pool::global();
+            const auto bounds = detail::split(
+                nb_channels(), nb_threads ? nb_threads : pool.concurrency(),
+                engine_type::alignment());
+
+            const std::size_t sstride = detail::sample_stride(l, size, nb_channels());
+            const std::size_t cstride = detail::channel_stride(l, size, nb_channels());
+
+            pool.parallel_for(bounds.size() - 1, [&](const std::size_t& k){
+                    m_engine.compute_ptr(size, input, output, sstride, cstride,
+                                         bounds[k], bounds[k+1]);
+                });
+
+            // input history shared by the channels, if any
+            m_engine.advance(size, input);
+        }
+
+        //! Compute analytic outputs from pointers
+        /*!
+          Only available with core::cooke1993 and core::convolution,
+          see filter::compute_ptr_complex(). The real parts are the
+          outputs of compute_ptr().
+
+          \param size    Number of input samples.
+          \param input   Pointer to *size* input scalars.
+          \param output  Pointer to *size x nb_channels()* output
+          values, the output of channel j at sample i being
+          output[i*nb_channels()+j].
+        */
+        inline void compute_ptr_complex(const std::size_t& size,
+                                        const Scalar* input,
+                                        std::complex<Scalar>* output){
+            m_engine.core().compute_ptr_complex(size, input, output);
+        }
+
+        //! Envelopes of all channels, the modulus of compute_ptr_complex()
+        /*!
+          At the input rate, see compute_envelope() for decimated
+          envelopes.
+        */
+        inline void compute_ptr_envelope(const std::size_t& size,
+                                         const Scalar* input,
+                                         Scalar* output){
+            analytic(size, input, [&](const std::size_t& k, const std::complex<Scalar>& z){
+                    output[k] = std::sqrt(z.real()*z.real() + z.imag()*z.imag());});
+        }
+
+        //! Instantaneous phases of all channels, the argument of compute_ptr_complex()
+        inline void compute_ptr_phase(const std::size_t& size,
+                                      const Scalar* input,
+                                      Scalar* output){
+            analytic(size, input, [&](const std::size_t& k, const std::complex<Scalar>& z){
+                    output[k] = std::atan2(z.imag(), z.real());});
+        }
+
+        //! Decimated base-band outputs of all channels
+        /*!
+          Only available with core::cooke1993, see
+          core::cooke1993_bank::compute_baseband().
+
+          \param size    Number of input samples.
+          \param input   Pointer to *size* input scalars.
+          \param output  Pointer to *(size / decimation() + 1) x
+          nb_channels()* output frames, frame m of channel j being
+          output[m*nb_channels()+j].
+          \return The number of frames written for each channel.
+        */
+        inline std::size_t compute_baseband(const std::size_t& size,
+                                            const Scalar* input,
+                                            std::complex<Scalar>* output){
+            return m_engine.core().compute_baseband(size, input, output);
+        }
+
+        //! Decimated envelopes of all channels
+        /*!
+          As compute_baseband(), see core::cooke1993_bank::compute_envelope().
+        */
+        inline std::size_t compute_envelope(const std::size_t& size,
+                                            const Scalar* input,
+                                            Scalar* output){
+            return m_engine.core().compute_envelope(size, input, output);
+        }
+
+        //! Set the decimation factor of compute_baseband() and compute_envelope()
+        inline void set_decimation(const std::size_t& factor){
+            m_engine.core().set_decimation(factor);
+        }
+
+        //! The decimation factor of compute_baseband() and compute_envelope()
+        inline std::size_t decimation() const{
+            return m_engine.core().decimation();
+        }
+
+        //! Offline processing, splitting the input in time chunks
+        /*!
+          The input is split in chunks computed in parallel, from
+          exact initial states found by the linear recurrence of the
+          core (see filter::compute_ptr_chunked). The result is the
+          same as compute_ptr(size, input, output, l) up to rounding
+          errors. Only available for the recursive cores
+          (core::cooke1993 and core::slaney1993).
+
+          \param size       Number of input samples.
+          \param input      Pointer to *size* input scalars.
+          \param output     Pointer to *size x nb_channels()* output scalars.
+          \param l          The layout of output.
+          \param nb_chunks  Number of time chunks, 0 means one per
+          thread in detail::thread_pool::global().
+        */
+        inline void compute_ptr_chunked(const std::size_t& size,
+                                        const Scalar* input,
+                                        Scalar* output,
+                                        const layout& l = layout::interleaved,
+                                        const std::size_t& nb_chunks = 0){
+            m_engine.compute_chunked(
+                size, input, output,
+                detail::sample_stride(l, size, nb_channels()),
+                detail::channel_stride(l, size, nb_channels()),
+                nb_chunks ? nb_chunks : detail::thread_pool::global().concurrency());
+        }
+
+        //! Approximate offline processing, in independent time chunks
+        /*!
+          Each time chunk is preceded by a warm-up segment, long enough
+          for the impulse responses to decay by *attenuation* dB (see
+          filter::compute_ptr_overlapped). Works for every core.
+
+          \param size         Number of input samples.
+          \param input        Pointer to *size* input scalars.
+          \param output       Pointer to *size x nb_channels()* output scalars.
+          \param l            The layout of output.
+          \param attenuation  Warm-up attenuation level (dB), negative.
+          \param nb_chunks    Number of time chunks, 0 means one per
+          thread in detail::thread_pool::global().
+        */
+        inline void compute_ptr_overlapped(const std::size_t& size,
+                                           const Scalar* input,
+                                           Scalar* output,
+                                           const layout& l = layout::interleaved,
+                                           const Scalar& attenuation = -120,
+                                           const std::size_t& nb_chunks = 0){
+            m_engine.compute_overlapped(
+                size, input, output,
+                detail::sample_stride(l, size, nb_channels()),
+                detail::channel_stride(l, size, nb_channels()),
+                attenuation,
+                nb_chunks ? nb_chunks : detail::thread_pool::global().concurrency());
         }
 
         inline output_type compute_allocate(const scalar_type& input)
@@ -306,11 +508,47 @@ namespace gammatone
 
 
     private:
+        //! Create a filterbank from the result of ChannelsPolicy::setup
+        filterbank(const Scalar& sample_frequency,
+                   const std::pair<std::vector<Scalar>, Scalar>& setup)
+            : base_type(sample_frequency),
+              m_overlap(setup.second),
+              m_bank(make_bank(sample_frequency, setup.first)),
+              m_engine(m_bank)
+            {}
+
+        //! Compute analytic outputs by blocks, calling output(k, z) for each output k
+        template<class Output>
+        inline void analytic(const std::size_t& size, const Scalar* input, const Output& output){
+            const std::size_t block = 256, channels = nb_channels();
+            std::vector<std::complex<Scalar> > buffer(std::min(size, block) * channels);
+            for(std::size_t done = 0; done < size; done += block)
+            {
+                const std::size_t n = std::min(size - done, block);
+                compute_ptr_complex(n, input + done, buffer.data());
+                for(std::size_t k = 0; k < n*channels; ++k)
+                    output(done*channels + k, buffer[k]);
+            }
+        }
+
+        //! Create one filter for each center frequency
+        static bank_type make_bank(const Scalar& sample_frequency,
+                                   const std::vector<Scalar>& center_frequencies){
+            bank_type bank;
+            bank.reserve(center_frequencies.size());
+            std::for_each(center_frequencies.begin(), center_frequencies.end(),
+                          [&](const Scalar& f){bank.push_back(filter_type(sample_frequency,f));});
+            return bank;
+        }
+
         //! The filterbank overlap factor
         Scalar m_overlap;
 
         //! The underlying gammatone filter array
         bank_type m_bank;
+
+        //! The processing engine
+        engine_type m_engine;
     };
 }
 
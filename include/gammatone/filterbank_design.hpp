@@ -0,0 +1,356 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_FILTERBANK_DESIGN_HPP
+#define GAMMATONE_FILTERBANK_DESIGN_HPP
+
+#include <gammatone/design_cache.hpp>
+#include <gammatone/detail/design_engine.hpp>
+#include <gammatone/detail/thread_pool.hpp>
+#include <gammatone/filterbank.hpp>
+#include <gammatone/layout.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace gammatone
+{
+    template<class Design> class filterbank_state;
+
+    //! The immutable design of a gammatone filterbank
+    /*!
+      \class filterbank_design gammatone/filterbank_design.hpp
+
+      A filterbank_design holds the channels of a filterbank, center
+      frequencies, bandwidths and filter coefficients, but no
+      processing state. The state of a signal being filtered is a
+      separate filterbank_state, created by make_state(), so that a
+      single design can be shared read-only by any number of threads
+      or sessions, each one computing its own states.
+
+      With core::cooke1993 and core::slaney1993 the states only hold
+      the recursion states of the channels (see
+      core::cooke1993_design and core::slaney1993_design). Other
+      cores fall back to a copy of the filters in each state, see
+      detail::design_engine.
+
+      The outputs of a state are those of a filterbank with the same
+      parameters, bit for bit.
+
+      \tparam Scalar           Type of scalar values
+      \tparam Core             See gammatone::core
+      \tparam ChannelsPolicy   See policy::channels
+      \tparam GainPolicy       See policy::gain
+      \tparam BandwidthPolicy  See policy::bandwidth
+      \tparam ClippingPolicy   See policy::clipping
+    */
+    template
+    <
+        class Scalar,
+        template<class...> class Core                              = core::cooke1993,
+        template<class,template<class> class> class ChannelsPolicy = policy::channels::fixed_size,
+        class GainPolicy                                           = policy::gain::forall_0dB,
+        template<class> class BandwidthPolicy                      = policy::bandwidth::glasberg1990,
+        class ClippingPolicy                                       = policy::clipping::off
+        >
+    class filterbank_design
+    {
+        using this_type = filterbank_design<Scalar, Core, ChannelsPolicy, GainPolicy,
+                                            BandwidthPolicy, ClippingPolicy>;
+
+    public:
+
+        //! Type of the scalars
+        using scalar_type = Scalar;
+
+        //! Type of the equivalent filterbank
+        using filterbank_type = filterbank<Scalar, Core, ChannelsPolicy, GainPolicy,
+                                           BandwidthPolicy, ClippingPolicy>;
+
+        //! Type of the channels policy
+        using channels = typename filterbank_type::channels;
+
+        //! Type of the underlying gammatone filters
+        using filter_type = typename filterbank_type::filter_type;
+
+        //! Type of the processing engine
+        using engine_type = detail::design_engine<filter_type>;
+
+        //! Type of the processing states
+        using state_type = filterbank_state<this_type>;
+
+        //! Create a filterbank design, see filterbank::filterbank
+        filterbank_design(const Scalar& sample_frequency,
+                          const Scalar& low_frequency,
+                          const Scalar& high_frequency,
+                          const typename channels::param_type& channels_parameter = channels::default_parameter())
+            : filterbank_design(sample_frequency,
+                                channels::setup(low_frequency, high_frequency, channels_parameter))
+            {}
+
+        //! A shared design of given parameters, see design_cache
+        /*!
+          The design is built once per process, and its impulse
+          responses loaded from the directory of the cache if any.
+          New sessions thus only create states.
+        */
+        static std::shared_ptr<const this_type> cached(
+            const Scalar& sample_frequency,
+            const Scalar& low_frequency,
+            const Scalar& high_frequency,
+            const typename channels::param_type& channels_parameter = channels::default_parameter()){
+            return design_cache::get<this_type>(
+                sample_frequency, low_frequency, high_frequency, channels_parameter);
+        }
+
+        //! Create the design of an existing filterbank
+        /*!
+          Only the channels of *bank* are used, not its state.
+        */
+        explicit filterbank_design(const filterbank_type& bank)
+            : m_sample_frequency(bank.sample_frequency()),
+              m_overlap(bank.overlap()),
+              m_center_frequencies(bank.center_frequency()),
+              m_bandwidths(bank.bandwidth()),
+              m_engine(m_sample_frequency, m_center_frequencies, m_bandwidths)
+            {}
+
+        //! The sample frequency (Hz)
+        Scalar sample_frequency() const{
+            return m_sample_frequency;
+        }
+
+        //! The number of frequency channels
+        std::size_t nb_channels() const{
+            return m_center_frequencies.size();
+        }
+
+        //! The overlap between two successive channels
+        Scalar overlap() const{
+            return m_overlap;
+        }
+
+        //! The center frequencies of the channels (Hz)
+        const std::vector<Scalar>& center_frequency() const{
+            return m_center_frequencies;
+        }
+
+        //! The bandwidths of the channels (Hz)
+        const std::vector<Scalar>& bandwidth() const{
+            return m_bandwidths;
+        }
+
+        //! A new processing state, at its initial value
+        state_type make_state() const{
+            return state_type(*this);
+        }
+
+        //! Compute all the channels from pointers on a given state
+        /*!
+          As filterbank::compute_ptr(), the filterbank state being
+          *state*. The design is left unchanged: concurrent calls on
+          distinct states are safe.
+
+          \param state   A state created by this design, updated.
+          \param size    Number of input samples.
+          \param input   Pointer to *size* input scalars.
+          \param output  Pointer to *size x nb_channels()* output scalars.
+          \param l       The layout of the output.
+        */
+        inline void compute_ptr(state_type& state,
+                                const std::size_t& size,
+                                const Scalar* input,
+                                Scalar* output,
+                                const layout& l = layout::interleaved) const{
+            m_engine.compute_ptr(state.m_state, size, input, output,
+                                 detail::sample_stride(l, size, nb_channels()),
+                                 detail::channel_stride(l, size, nb_channels()));
+        }
+
+        //! Compute many independent inputs on several threads
+        /*!
+          Each input is computed from an initial state, its outputs
+          being those of compute_ptr() on a new state. Inputs are
+          split in tasks of comparable cost, a long input being
+          computed by several tasks on disjoint slices of channels so
+          that it does not end the batch alone. The tasks are run
+          longest first by detail::thread_pool::parallel_for_stealing()
+          on the threads of detail::thread_pool::global().
+
+          \param nb_inputs   Number of inputs.
+          \param sizes       Number of samples of each input.
+          \param inputs      Pointers to the *sizes[i]* input scalars of each input.
+          \param outputs     Pointers to the *sizes[i] x nb_channels()*
+          output scalars of each input.
+          \param l           The layout of the outputs.
+          \param nb_threads  Maximal number of threads, 0 means one per
+          thread in the pool.
+
+          \note The planar layout avoids the slices of an input
+          writing to the same cache lines in output.
+        */
+        inline void compute_batch(const std::size_t& nb_inputs,
+                                  const std::size_t* sizes,
+                                  const Scalar* const* inputs,
+                                  Scalar* const* outputs,
+                                  const layout& l = layout::interleaved,
+                                  const std::size_t& nb_threads = 0) const{
+            auto& pool = detail::thread_pool::global();
+            const std::size_t workers = nb_threads ?
+                std::min(nb_threads, pool.concurrency()) : pool.concurrency();
+
+            const auto tasks = batch_tasks(nb_inputs, sizes, workers);
+            const std::size_t channels = nb_channels();
+
+            // a state per worker, reset before each task
+            std::vector<state_type> states(std::min(workers, tasks.size()), make_state());
+            pool.parallel_for_stealing(
+                tasks.size(), states.size(),
+                [&](const std::size_t& w, const std::size_t& k){
+                    const batch_task& t = tasks[k];
+                    const std::size_t size = sizes[t.input];
+                    auto& state = states[w];
+
+                    state.reset();
+                    m_engine.compute_ptr(state.m_state, size, inputs[t.input], outputs[t.input],
+                                         detail::sample_stride(l, size, channels),
+                                         detail::channel_stride(l, size, channels),
+                                         t.first, t.last);
+                    m_engine.advance(state.m_state, size, inputs[t.input]);
+                });
+        }
+
+        //! Access to the processing engine
+        const engine_type& engine() const{
+            return m_engine;
+        }
+
+    private:
+        //! Create a design from the result of ChannelsPolicy::setup
+        filterbank_design(const Scalar& sample_frequency,
+                          const std::pair<std::vector<Scalar>, Scalar>& setup)
+            : m_sample_frequency(sample_frequency),
+              m_overlap(setup.second),
+              m_center_frequencies(setup.first),
+              m_bandwidths(make_bandwidths(setup.first)),
+              m_engine(m_sample_frequency, m_center_frequencies, m_bandwidths)
+            {}
+
+        //! The bandwidth of each center frequency
+        static std::vector<Scalar> make_bandwidths(const std::vector<Scalar>& center_frequencies){
+            std::vector<Scalar> out(center_frequencies.size());
+            std::transform(center_frequencies.begin(), center_frequencies.end(), out.begin(),
+                           [](const Scalar& f){return BandwidthPolicy<Scalar>::bandwidth(f);});
+            return out;
+        }
+
+        //! A slice of the channels of an input in compute_batch()
+        struct batch_task
+        {
+            std::size_t input, first, last, cost;
+        };
+
+        //! Split the inputs of compute_batch() in tasks, longest first
+        std::vector<batch_task> batch_tasks(const std::size_t& nb_inputs,
+                                            const std::size_t* sizes,
+                                            const std::size_t& workers) const{
+            std::vector<batch_task> tasks;
+            const std::size_t channels = nb_channels();
+            if(channels == 0) return tasks;
+
+            // an input longer than a fraction of the work of a worker
+            // is split in slices of channels
+            std::size_t total = 0;
+            for(std::size_t i = 0; i < nb_inputs; ++i) total += sizes[i];
+            const std::size_t grain = std::max<std::size_t>(1, total / (4*workers));
+
+            tasks.reserve(nb_inputs);
+            for(std::size_t i = 0; i < nb_inputs; ++i)
+            {
+                if(sizes[i] == 0) continue;
+
+                const auto bounds = detail::split(
+                    channels, (sizes[i] + grain - 1) / grain, engine_type::alignment());
+                for(std::size_t k = 0; k + 1 < bounds.size(); ++k)
+                    tasks.push_back({i, bounds[k], bounds[k+1], sizes[i]*(bounds[k+1] - bounds[k])});
+            }
+
+            std::stable_sort(tasks.begin(), tasks.end(),
+                             [](const batch_task& a, const batch_task& b){return a.cost > b.cost;});
+            return tasks;
+        }
+
+        //! The sample frequency
+        Scalar m_sample_frequency;
+
+        //! The overlap between channels
+        Scalar m_overlap;
+
+        //! The center frequencies of the channels
+        std::vector<Scalar> m_center_frequencies;
+
+        //! The bandwidths of the channels
+        std::vector<Scalar> m_bandwidths;
+
+        //! The processing engine, holding the coefficients
+        engine_type m_engine;
+    };
+
+
+    //! The processing state of a filterbank_design
+    /*!
+      \class filterbank_state gammatone/filterbank_design.hpp
+
+      A state holds the memory of the filters for one input signal,
+      created by filterbank_design::make_state() and computed by
+      filterbank_design::compute_ptr(). A state is bound to the design
+      that created it, or to a design of same parameters.
+
+      \tparam Design  Type of the filterbank_design.
+    */
+    template<class Design>
+    class filterbank_state
+    {
+        friend Design;
+
+    public:
+        //! Create a state at its initial value
+        explicit filterbank_state(const Design& design)
+            : m_state(design.engine().make_state())
+            {}
+
+        //! The number of frequency channels
+        std::size_t nb_channels() const{
+            return m_state.nb_channels();
+        }
+
+        //! Restore the initial state
+        void reset(){
+            m_state.reset();
+        }
+
+    private:
+        //! The state of the design engine
+        typename Design::engine_type::state_type m_state;
+    };
+}
+
+#endif // GAMMATONE_FILTERBANK_DESIGN_HPP
@@ -26,14 +26,19 @@
 
 #include <gammatone/filter.hpp>
 #include <gammatone/filterbank.hpp>
+#include <gammatone/filterbank_design.hpp>
+#include <gammatone/design_cache.hpp>
+#include <gammatone/multistream.hpp>
 
 #include <gammatone/core/cooke1993.hpp>
+#include <gammatone/core/cooke1993_fixed.hpp>
 #include <gammatone/core/slaney1993.hpp>
 #include <gammatone/core/convolution.hpp>
 
 #include <gammatone/policy/bandwidth.hpp>
 #include <gammatone/policy/channels.hpp>
 #include <gammatone/policy/clipping.hpp>
+#include <gammatone/policy/rounding.hpp>
 
 
 // Above are some general comments on libgammatone for Doxygen based
@@ -0,0 +1,58 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_LAYOUT_HPP
+#define GAMMATONE_LAYOUT_HPP
+
+#include <cstddef>
+
+namespace gammatone
+{
+    //! Memory layout of multi-channel outputs
+    /*!
+      For an output of *size* samples on *nb_channels* channels, the
+      value of channel j at sample i is stored at index:
+      - i*nb_channels + j for layout::interleaved (time major),
+      - j*size + i for layout::planar (channel major).
+    */
+    enum class layout
+    {
+        interleaved,
+        planar
+    };
+
+    namespace detail
+    {
+        //! Distance between two successive samples of a channel
+        inline std::size_t sample_stride(const layout& l,
+                                         const std::size_t& size,
+                                         const std::size_t& nb_channels){
+            return l == layout::interleaved ? nb_channels : 1;
+        }
+
+        //! Distance between two successive channels of a sample
+        inline std::size_t channel_stride(const layout& l,
+                                          const std::size_t& size,
+                                          const std::size_t& nb_channels){
+            return l == layout::interleaved ? 1 : size;
+        }
+    }
+}
+
+#endif // GAMMATONE_LAYOUT_HPP
@@ -0,0 +1,204 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_MULTISTREAM_HPP
+#define GAMMATONE_MULTISTREAM_HPP
+
+#include <gammatone/detail/stream_engine.hpp>
+#include <gammatone/filterbank.hpp>
+#include <gammatone/layout.hpp>
+
+#include <vector>
+
+namespace gammatone
+{
+    //! A gammatone filterbank computed on several independent streams
+    /*!
+      \class multistream gammatone/multistream.hpp
+
+      A multistream computes the channels of a filterbank on K
+      independent inputs, each stream having its own state as with K
+      copies of the filterbank. The processing is delegated to a
+      detail::stream_engine: with core::cooke1993, the coefficients
+      and phasors are stored once and shared by the streams, computed
+      by pairs in SIMD registers (see core::cooke1993_streams). With
+      core::slaney1993 the coefficients are stored once too, each
+      stream only having its own recursion states. Other cores hold
+      a copy of the filters per stream. The outputs are those of K
+      filterbanks, bit for bit.
+
+      \tparam Scalar           Type of scalar values
+      \tparam Core             See gammatone::core
+      \tparam ChannelsPolicy   See policy::channels
+      \tparam GainPolicy       See policy::gain
+      \tparam BandwidthPolicy  See policy::bandwidth
+      \tparam ClippingPolicy   See policy::clipping
+    */
+    template
+    <
+        class Scalar,
+        template<class...> class Core                              = core::cooke1993,
+        template<class,template<class> class> class ChannelsPolicy = policy::channels::fixed_size,
+        class GainPolicy                                           = policy::gain::forall_0dB,
+        template<class> class BandwidthPolicy                      = policy::bandwidth::glasberg1990,
+        class ClippingPolicy                                       = policy::clipping::off
+        >
+    class multistream
+    {
+    public:
+
+        //! Type of the scalars
+        using scalar_type = Scalar;
+
+        //! Type of the filterbank computed on each stream
+        using filterbank_type = filterbank<Scalar, Core, ChannelsPolicy, GainPolicy,
+                                           BandwidthPolicy, ClippingPolicy>;
+
+        //! Type of the channels policy
+        using channels = typename filterbank_type::channels;
+
+        //! Type of the underlying gammatone filters
+        using filter_type = typename filterbank_type::filter_type;
+
+        //! Type of the processing engine
+        using engine_type = detail::stream_engine<filter_type>;
+
+        //! Create a multistream computing the channels of a filterbank
+        /*!
+          Only the channels of *design* are used, not its state.
+
+          \param design      The filterbank computed on each stream.
+          \param nb_streams  The number of input streams.
+        */
+        multistream(const filterbank_type& design, const std::size_t& nb_streams)
+            : m_sample_frequency(design.sample_frequency()),
+              m_center_frequencies(design.center_frequency()),
+              m_bandwidths(design.bandwidth()),
+              m_engine(m_sample_frequency, m_center_frequencies, m_bandwidths, nb_streams)
+            {}
+
+        //! Create a multistream from explicit parameters, see filterbank::filterbank
+        multistream(const Scalar& sample_frequency,
+                    const Scalar& low_frequency,
+                    const Scalar& high_frequency,
+                    const std::size_t& nb_streams,
+                    const typename channels::param_type& channels_parameter = channels::default_parameter())
+            : multistream(filterbank_type(sample_frequency, low_frequency, high_frequency,
+                                          channels_parameter),
+                          nb_streams)
+            {}
+
+        //! The sample frequency of the streams (Hz)
+        Scalar sample_frequency() const{
+            return m_sample_frequency;
+        }
+
+        //! The number of frequency channels computed on each stream
+        std::size_t nb_channels() const{
+            return m_center_frequencies.size();
+        }
+
+        //! The number of input streams
+        std::size_t nb_streams() const{
+            return m_engine.nb_streams();
+        }
+
+        //! The center frequencies of the channels (Hz)
+        const std::vector<Scalar>& center_frequency() const{
+            return m_center_frequencies;
+        }
+
+        //! The bandwidths of the channels (Hz)
+        const std::vector<Scalar>& bandwidth() const{
+            return m_bandwidths;
+        }
+
+        //! Restore the initial state of all the streams
+        void reset(){
+            m_engine.reset();
+        }
+
+        //! Compute all the streams from pointers
+        /*!
+          \param size    Number of input samples per stream.
+          \param input   Pointer to *size x nb_streams()* input scalars,
+          sample i of stream k being input[i*nb_streams()+k] with
+          layout::interleaved, input[k*size+i] with layout::planar.
+          \param output  Pointer to *size x nb_channels() x
+          nb_streams()* output scalars. The outputs of stream k are
+          those of filterbank::compute_ptr() with the layout *l*,
+          starting at output[k*size*nb_channels()].
+          \param input_layout  The layout of input.
+          \param l             The layout of the outputs of each stream.
+        */
+        inline void compute_ptr(const std::size_t& size,
+                                const Scalar* input,
+                                Scalar* output,
+                                const layout& input_layout = layout::interleaved,
+                                const layout& l = layout::interleaved){
+            m_engine.compute_strided(size, input,
+                                     detail::sample_stride(input_layout, size, nb_streams()),
+                                     detail::channel_stride(input_layout, size, nb_streams()),
+                                     output,
+                                     detail::sample_stride(l, size, nb_channels()),
+                                     detail::channel_stride(l, size, nb_channels()),
+                                     size*nb_channels());
+        }
+
+        //! Compute all the streams with explicit strides
+        /*!
+          Sample i of stream k is read in input[i*input_sample_stride +
+          k*input_stream_stride], so that the streams may be some of
+          the channels of an interleaved PCM buffer. The output of
+          channel j of stream k at sample i is stored in
+          output[i*sample_stride + j*channel_stride + k*stream_stride].
+        */
+        inline void compute_strided(const std::size_t& size,
+                                    const Scalar* input,
+                                    const std::size_t& input_sample_stride,
+                                    const std::size_t& input_stream_stride,
+                                    Scalar* output,
+                                    const std::size_t& sample_stride,
+                                    const std::size_t& channel_stride,
+                                    const std::size_t& stream_stride){
+            m_engine.compute_strided(size, input, input_sample_stride, input_stream_stride,
+                                     output, sample_stride, channel_stride, stream_stride);
+        }
+
+        //! Access to the processing engine
+        engine_type& engine(){
+            return m_engine;
+        }
+
+    private:
+        //! The sample frequency of the streams
+        Scalar m_sample_frequency;
+
+        //! The center frequencies of the channels
+        std::vector<Scalar> m_center_frequencies;
+
+        //! The bandwidths of the channels
+        std::vector<Scalar> m_bandwidths;
+
+        //! The processing engine
+        engine_type m_engine;
+    };
+}
+
+#endif // GAMMATONE_MULTISTREAM_HPP
@@ -0,0 +1,107 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_POLICY_ROUNDING_HPP
+#define GAMMATONE_POLICY_ROUNDING_HPP
+
+#include <gammatone/policy/policy.hpp>
+#include <cstddef>
+
+namespace gammatone
+{
+  namespace policy
+  {
+    //! Policy for rounding in fixed-point arithmetic
+    /*!
+      \namespace gammatone::policy::rounding
+
+      Fixed-point cores, such as core::cooke1993_fixed, compute
+      products of integers in a wider type and shift them back to the
+      fixed-point format. The rounding policy implements this shift.
+
+      ~~~
+      using namespace gammatone;
+      Wide policy::rounding::nearest::shift(const Wide& x, bits)    // Round half up
+      Wide policy::rounding::convergent::shift(const Wide& x, bits) // Round half to even
+      Wide policy::rounding::truncate::shift(const Wide& x, bits)   // Round toward -infinity
+      ~~~
+
+      Truncation is the cheapest but biased toward \f$ -\infty \f$,
+      which adds a small DC offset to each recursion of the core.
+    */
+    namespace rounding
+    {
+      //! Round to nearest, ties toward \f$ +\infty \f$
+      class nearest : public gammatone::policy::policy
+      {
+      public:
+        //! Return \f$ x / 2^{bits} \f$ rounded to nearest
+        template<class Wide>
+        static inline Wide shift(const Wide& x, const std::size_t& bits);
+      };
+
+      //! Round to nearest, ties to even
+      class convergent : public gammatone::policy::policy
+      {
+      public:
+        //! Return \f$ x / 2^{bits} \f$ rounded to nearest, ties to even
+        template<class Wide>
+        static inline Wide shift(const Wide& x, const std::size_t& bits);
+      };
+
+      //! Round toward \f$ -\infty \f$
+      class truncate : public gammatone::policy::policy
+      {
+      public:
+        //! Return \f$ x / 2^{bits} \f$ rounded toward \f$ -\infty \f$
+        template<class Wide>
+        static inline Wide shift(const Wide& x, const std::size_t& bits);
+      };
+    }
+  }
+}
+
+// Right shifts of negative integers are arithmetic on all the
+// supported compilers, they thus round toward -infinity.
+
+template<class Wide>
+Wide gammatone::policy::rounding::nearest::shift(const Wide& x, const std::size_t& bits)
+{
+  return (x + (Wide(1) << (bits-1))) >> bits;
+}
+
+template<class Wide>
+Wide gammatone::policy::rounding::convergent::shift(const Wide& x, const std::size_t& bits)
+{
+  const Wide half = Wide(1) << (bits-1);
+  const Wide mask = (Wide(1) << bits) - 1;
+  const Wide y = x >> bits;
+
+  // above the half, or exactly the half and y odd
+  const Wide rest = x & mask;
+  return (rest > half || (rest == half && (y & 1))) ? y + 1 : y;
+}
+
+template<class Wide>
+Wide gammatone::policy::rounding::truncate::shift(const Wide& x, const std::size_t& bits)
+{
+  return x >> bits;
+}
+
+#endif // GAMMATONE_POLICY_ROUNDING_HPP
@@ -0,0 +1,126 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMMATONE_POLYMORPHIC_HPP
+#define GAMMATONE_POLYMORPHIC_HPP
+
+#include <gammatone/detail/interface.hpp>
+#include <memory>
+
+namespace gammatone
+{
+    //! Runtime polymorphic adapter for filters and filterbanks
+    /*!
+      \class polymorphic gammatone/polymorphic.hpp
+
+      gammatone::filter and gammatone::filterbank are statically
+      dispatched (see detail::static_interface). This thin adapter
+      wraps one of them and exposes it through the virtual
+      detail::interface, for users who need to choose the processing
+      type at runtime:
+
+      \code
+      using interface = gammatone::detail::interface<double, double>;
+      std::unique_ptr<interface> f(
+          new gammatone::polymorphic<gammatone::filter<double>>(
+              gammatone::filter<double>(44100, 1000)));
+      \endcode
+
+      \tparam Implementation  The wrapped filter or filterbank type.
+    */
+    template<class Implementation>
+    class polymorphic : public detail::interface<typename Implementation::scalar_type,
+                                                 typename Implementation::output_type>
+    {
+    public:
+        //! Type of the wrapped filter or filterbank
+        using implementation_type = Implementation;
+
+        //! Type of the inherited interface
+        using base_type = detail::interface<typename Implementation::scalar_type,
+                                            typename Implementation::output_type>;
+
+        //! Type of the scalars
+        using scalar_type = typename base_type::scalar_type;
+
+        //! Type of the outputs
+        using output_type = typename base_type::output_type;
+
+        //! Wrap a copy of an implementation
+        explicit polymorphic(const implementation_type& implementation)
+            : base_type(implementation.sample_frequency()),
+              m_implementation(implementation)
+            {}
+
+        //! Wrap an implementation
+        explicit polymorphic(implementation_type&& implementation)
+            : base_type(implementation.sample_frequency()),
+              m_implementation(std::move(implementation))
+            {}
+
+        //! Destructor
+        virtual ~polymorphic(){}
+
+        //! Access to the wrapped implementation
+        implementation_type& implementation(){
+            return m_implementation;
+        }
+
+        //! Const access to the wrapped implementation
+        const implementation_type& implementation() const{
+            return m_implementation;
+        }
+
+        output_type center_frequency() const{
+            return m_implementation.center_frequency();
+        }
+
+        output_type bandwidth() const{
+            return m_implementation.bandwidth();
+        }
+
+        output_type gain() const{
+            return m_implementation.gain();
+        }
+
+        void reset(){
+            m_implementation.reset();
+        }
+
+        void compute(const scalar_type& input, output_type& output){
+            m_implementation.compute(input, output);
+        }
+
+        output_type compute_allocate(const scalar_type& input){
+            return m_implementation.compute_allocate(input);
+        }
+
+        void compute_ptr(const std::size_t& size,
+                         const scalar_type* input,
+                         scalar_type* output){
+            m_implementation.compute_ptr(size, input, output);
+        }
+
+    private:
+        //! The wrapped implementation
+        implementation_type m_implementation;
+    };
+}
+
+#endif // GAMMATONE_POLYMORPHIC_HPP
@@ -22,32 +22,136 @@ def _check(input_array):
     assert len(input_array.shape) == 1, 'input array must be 1D'
 
 
-def _filter_compute(self, input_array):
+def _input(input_array, dtype):
+    # avoid a copy if the input is already contiguous with the
+    # precision of the filter
+    input_array = numpy.ascontiguousarray(input_array, dtype=dtype)
     _check(input_array)
+    return input_array
 
-    # allocate the output array
-    output_array = numpy.zeros(input_array.shape)
 
-    # compute result sample per sample
-    for n, i in enumerate(input_array):
-        output_array[n] = self._compute(i)
+def _output(shape, dtype, out):
+    # allocate the output array, or check the one given by the caller
+    if out is None:
+        return numpy.empty(shape, dtype=dtype)
 
+    if out.shape != shape:
+        raise ValueError('output array must have shape {}'.format(shape))
+    return out
+
+
+def _filter_compute(self, input_array, out=None):
+    """Compute a 1D input array, the state being kept across calls
+
+    Return the output array, or out if given. Raise a RuntimeError if
+    another thread is computing the filter.
+
+    """
+    input_array = _input(input_array, self.dtype)
+    output_array = _output(input_array.shape, self.dtype, out)
+
+    # the whole array is computed in C++, in place in output_array
+    self._compute_ptr(input_array, output_array)
     return output_array
 
 
-def _filterbank_compute(self, input_array):
-    _check(input_array)
+def _filterbank_compute(self, input_array, out=None):
+    """Compute a 1D input array, the state being kept across calls
 
-    # allocate the output array
-    output_array = numpy.zeros((input_array.shape[0], self.nb_channels))
+    Return the output array of shape (len(input_array), nb_channels),
+    or out if given. Raise a RuntimeError if another thread is
+    computing the filterbank.
 
-    # compute result sample per sample
-    for n, i in enumerate(input_array):
-        for m, j in enumerate(self._compute(i)):
-            output_array[n][m] = j
+    """
+    input_array = _input(input_array, self.dtype)
+    output_array = _output((input_array.shape[0], self.nb_channels), self.dtype, out)
 
+    self._compute_ptr(input_array, output_array)
     return output_array
 
 
-Filter.compute = _filter_compute
-Filterbank.compute = _filterbank_compute
+def _filterbank_compute_batch(self, input_arrays, n_threads=0):
+    """Compute a list of 1D input arrays from the initial state
+
+    The inputs are computed on n_threads native threads (0 for all),
+    the GIL being released. The filterbank is left unchanged, so that
+    several Python threads may call compute_batch() at once.
+
+    """
+    input_arrays = [_input(i, self.dtype) for i in input_arrays]
+    output_arrays = [numpy.empty((i.shape[0], self.nb_channels), dtype=self.dtype)
+                     for i in input_arrays]
+
+    self._compute_batch(input_arrays, output_arrays, n_threads)
+    return output_arrays
+
+
+def _filterbank_set_ring(self, chunk_size, nb_chunks):
+    """Preallocate the outputs of process_chunk()
+
+    The outputs of the nb_chunks last chunks of at most chunk_size
+    samples are kept as views on a single array, see ring().
+
+    """
+    ring = numpy.empty((nb_chunks, chunk_size, self.nb_channels), dtype=self.dtype)
+    self._ring = list(ring)
+    self._ring_sizes = [0] * nb_chunks
+    self._ring_next = 0
+    self._ring_count = 0
+
+
+def _filterbank_ring(self):
+    """Views on the outputs of the last chunks in the ring, oldest first"""
+    if not hasattr(self, '_ring'):
+        return []
+    n = min(self._ring_count, len(self._ring))
+    slots = [(self._ring_next - n + k) % len(self._ring) for k in range(n)]
+    return [self._ring[k][:self._ring_sizes[k]] for k in slots]
+
+
+def _filterbank_process_chunk(self, input_array, out=None):
+    """Compute a chunk of a stream, the state being kept across calls
+
+    Nothing is allocated: arrays are neither converted nor checked in
+    Python, input_array and out must be contiguous arrays of
+    self.dtype. Without out, the output is written in the next slot
+    of the ring (see set_ring()) and a view on it is returned. Raise a
+    RuntimeError if no ring is set, a ValueError if the chunk is
+    longer than the slots of the ring, the ring being left unchanged
+    on errors. See compute() for thread safety.
+
+    """
+    if out is not None:
+        self._compute_ptr(input_array, out)
+        return out
+
+    if not hasattr(self, '_ring'):
+        raise RuntimeError('process_chunk() needs out or a ring, see set_ring()')
+
+    size = input_array.shape[0]
+    out = self._ring[self._ring_next]
+    if size > out.shape[0]:
+        raise ValueError('chunk of {} samples longer than the ring slots of {}'
+                         .format(size, out.shape[0]))
+    out = out[:size]
+
+    # the slot is taken once computed only
+    self._compute_ptr(input_array, out)
+    self._ring_sizes[self._ring_next] = size
+    self._ring_next = (self._ring_next + 1) % len(self._ring)
+    self._ring_count += 1
+    return out
+
+
+# each exported filter and filterbank type gets the numpy interface,
+# with arrays of its own precision (see the dtype attribute)
+for _type in list(globals().values()):
+    if isinstance(_type, type) and hasattr(_type, '_compute_ptr'):
+        if hasattr(_type, '_compute_batch'):
+            _type.compute = _filterbank_compute
+            _type.compute_batch = _filterbank_compute_batch
+            _type.process_chunk = _filterbank_process_chunk
+            _type.set_ring = _filterbank_set_ring
+            _type.ring = _filterbank_ring
+        else:
+            _type.compute = _filter_compute
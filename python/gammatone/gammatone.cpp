@@ -16,17 +16,278 @@
   You should have received a copy of the GNU General Public License
   along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
 */
+#include <memory>
+#include <set>
+#include <string>
 #include <vector>
 #include <boost/python.hpp>
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
 #include <gammatone/filter.hpp>
 #include <gammatone/filterbank.hpp>
+#include <gammatone/filterbank_design.hpp>
+#include <gammatone/core/convolution.hpp>
+#include <gammatone/core/cooke1993.hpp>
+#include <gammatone/core/slaney1993.hpp>
+#include <gammatone/policy/channels.hpp>
 
 namespace py = boost::python;
-using scalar = double;
 
-void export_filter();
-void export_filterbank();
+template<class Filter> void export_filter(const char* name);
+template<class Filterbank> void export_filterbank(const char* name);
+
+
+namespace
+{
+    //! Thread safety contract, appended to the docstrings of the classes
+    const char* thread_safety =
+        "\n\n"
+        "Computations release the GIL, so that distinct objects can be\n"
+        "computed concurrently by several Python threads. An object is\n"
+        "computed by a single thread at a time: computing or resetting an\n"
+        "object while another thread computes it raises a RuntimeError.\n"
+        "The compute_batch() method of filterbanks leaves the object\n"
+        "unchanged and may be called by several threads at once.";
+
+
+    //! The numpy dtype and buffer format of a scalar type
+    template<class Scalar> struct dtype;
+
+    template<> struct dtype<float>
+    {
+        static const char* name(){return "float32";}
+        static char format(){return 'f';}
+    };
+
+    template<> struct dtype<double>
+    {
+        static const char* name(){return "float64";}
+        static char format(){return 'd';}
+    };
+
+
+    //! A C-contiguous array of scalars exposed by a Python object
+    /*!
+      Any object implementing the buffer protocol, such as a numpy
+      array, is accepted as long as it holds contiguous values of
+      type Scalar. The memory is accessed in place, the buffer being
+      released on destruction.
+    */
+    template<class Scalar>
+    class buffer
+    {
+    public:
+        buffer(const py::object& object, const bool& writable){
+            const int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (writable ? PyBUF_WRITABLE : 0);
+            if(PyObject_GetBuffer(object.ptr(), &m_view, flags) != 0)
+                py::throw_error_already_set();
+
+            // native byte order and size only
+            std::string format(m_view.format ? m_view.format : "B");
+            if(format.size() == 2 && (format[0] == '=' || format[0] == '@'))
+                format.erase(0, 1);
+
+            if(m_view.itemsize != sizeof(Scalar) || format != std::string(1, dtype<Scalar>::format()))
+            {
+                PyBuffer_Release(&m_view);
+                const std::string message =
+                    std::string("array must be contiguous ") + dtype<Scalar>::name();
+                PyErr_SetString(PyExc_TypeError, message.c_str());
+                py::throw_error_already_set();
+            }
+        }
+
+        buffer(const buffer&) = delete;
+        buffer& operator=(const buffer&) = delete;
+
+        ~buffer(){
+            PyBuffer_Release(&m_view);
+        }
+
+        //! Number of scalars in the buffer
+        std::size_t size() const{
+            return m_view.len / sizeof(Scalar);
+        }
+
+        Scalar* data() const{
+            return static_cast<Scalar*>(m_view.buf);
+        }
+
+    private:
+        Py_buffer m_view;
+    };
+
+
+    //! Release the GIL during its lifetime
+    /*!
+      No Python object must be accessed while the GIL is released,
+      buffers are thus acquired before and released after.
+    */
+    class gil_release
+    {
+    public:
+        gil_release()
+            : m_state(PyEval_SaveThread())
+            {}
+
+        gil_release(const gil_release&) = delete;
+        gil_release& operator=(const gil_release&) = delete;
+
+        ~gil_release(){
+            PyEval_RestoreThread(m_state);
+        }
+
+    private:
+        PyThreadState* m_state;
+    };
+
+
+    //! Refuse any other use of an object during its lifetime
+    /*!
+      The GIL being released during the computations, another Python
+      thread could meanwhile use the same filter or filterbank and
+      race on its state. The objects in use are registered here, the
+      registry being protected by the GIL: an exclusive_use must be
+      created before a gil_release and destroyed after it. A second
+      use of an object raises a RuntimeError.
+    */
+    class exclusive_use
+    {
+    public:
+        explicit exclusive_use(const void* object)
+            : m_object(object){
+            if(! in_use().insert(object).second)
+            {
+                PyErr_SetString(PyExc_RuntimeError,
+                                "object is already in use by another thread");
+                py::throw_error_already_set();
+            }
+        }
+
+        exclusive_use(const exclusive_use&) = delete;
+        exclusive_use& operator=(const exclusive_use&) = delete;
+
+        ~exclusive_use(){
+            in_use().erase(m_object);
+        }
+
+    private:
+        static std::set<const void*>& in_use(){
+            static std::set<const void*> objects;
+            return objects;
+        }
+
+        const void* m_object;
+    };
+
+
+    //! Reset an object not in use by another thread
+    template<class Object>
+    void exclusive_reset(Object& object){
+        const exclusive_use lock(&object);
+        object.reset();
+    }
+
+
+    //! Compute one sample on an object not in use by another thread
+    template<class Object>
+    auto exclusive_compute(Object& object, const typename Object::scalar_type& input)
+        -> decltype(object.compute_allocate(input)){
+        const exclusive_use lock(&object);
+        return object.compute_allocate(input);
+    }
+
+
+    //! Raise a ValueError if an output does not match its input
+    template<class Scalar>
+    void check_size(const buffer<Scalar>& output, const std::size_t& size){
+        if(output.size() != size)
+        {
+            PyErr_SetString(PyExc_ValueError, "output array has a wrong size");
+            py::throw_error_already_set();
+        }
+    }
+
+
+    //! Compute a whole input array into an output array
+    template<class Filter>
+    void filter_compute_ptr(Filter& filter, const py::object& input, const py::object& output){
+        using scalar = typename Filter::scalar_type;
+        const buffer<scalar> in(input, false), out(output, true);
+        check_size(out, in.size());
+
+        const exclusive_use lock(&filter);
+        const gil_release nogil;
+        filter.compute_ptr(in.size(), in.data(), out.data());
+    }
+
+
+    //! Compute a whole input array into an interleaved output array
+    template<class Filterbank>
+    void filterbank_compute_ptr(Filterbank& filterbank, const py::object& input, const py::object& output){
+        using scalar = typename Filterbank::scalar_type;
+        const buffer<scalar> in(input, false), out(output, true);
+        check_size(out, in.size() * filterbank.nb_channels());
+
+        const exclusive_use lock(&filterbank);
+        const gil_release nogil;
+        filterbank.compute_ptr(in.size(), in.data(), out.data());
+    }
+
+
+    //! The filterbank_design type of a filterbank type
+    template<class Filterbank> struct design_of;
+
+    template<class Scalar,
+             template<class...> class Core,
+             template<class,template<class> class> class ChannelsPolicy,
+             class GainPolicy,
+             template<class> class BandwidthPolicy,
+             class ClippingPolicy>
+    struct design_of<gammatone::filterbank<Scalar, Core, ChannelsPolicy, GainPolicy,
+                                           BandwidthPolicy, ClippingPolicy> >
+    {
+        using type = gammatone::filterbank_design<Scalar, Core, ChannelsPolicy, GainPolicy,
+                                                  BandwidthPolicy, ClippingPolicy>;
+    };
+
+
+    //! Compute a list of inputs from the initial state, see filterbank_design::compute_batch
+    template<class Filterbank>
+    void filterbank_compute_batch(const Filterbank& filterbank,
+                                  const py::list& inputs,
+                                  const py::list& outputs,
+                                  const std::size_t& nb_threads){
+        using scalar = typename Filterbank::scalar_type;
+        const std::size_t n = py::len(inputs);
+        if(static_cast<std::size_t>(py::len(outputs)) != n)
+        {
+            PyErr_SetString(PyExc_ValueError, "inputs and outputs must have the same length");
+            py::throw_error_already_set();
+        }
+
+        std::vector<std::unique_ptr<buffer<scalar> > > buffers;
+        std::vector<std::size_t> sizes(n);
+        std::vector<const scalar*> in(n);
+        std::vector<scalar*> out(n);
+        for(std::size_t i = 0; i < n; ++i)
+        {
+            buffers.emplace_back(new buffer<scalar>(inputs[i], false));
+            sizes[i] = buffers.back()->size();
+            in[i] = buffers.back()->data();
+
+            buffers.emplace_back(new buffer<scalar>(outputs[i], true));
+            check_size(*buffers.back(), sizes[i] * filterbank.nb_channels());
+            out[i] = buffers.back()->data();
+        }
+
+        // the design copies the channels, the filterbank is no more
+        // read once the GIL is released
+        const typename design_of<Filterbank>::type design(filterbank);
+        const gil_release nogil;
+        design.compute_batch(n, sizes.data(), in.data(), out.data(),
+                             gammatone::layout::interleaved, nb_threads);
+    }
+}
 
 
 BOOST_PYTHON_MODULE(_gammatone)
@@ -35,41 +296,90 @@ BOOST_PYTHON_MODULE(_gammatone)
     py::object package = py::scope();
     package.attr("__path__") = "gammatone";
 
-    export_filter();
-    export_filterbank();
+    py::class_<std::vector<double>>("std_vector_double")
+        .def(py::vector_indexing_suite<std::vector<double>>());
+    py::class_<std::vector<float>>("std_vector_float")
+        .def(py::vector_indexing_suite<std::vector<float>>());
+
+    using namespace gammatone;
+    using policy::channels::fixed_overlap;
+
+    // the default types are cooke1993 cores in double precision, the
+    // other types are named after their core, channels policy and
+    // precision
+    export_filter<filter<double>>("Filter");
+    export_filter<filter<float>>("FilterFloat32");
+    export_filter<filter<double, core::slaney1993>>("Slaney1993Filter");
+    export_filter<filter<float, core::slaney1993>>("Slaney1993FilterFloat32");
+    export_filter<filter<double, core::convolution>>("ConvolutionFilter");
+    export_filter<filter<float, core::convolution>>("ConvolutionFilterFloat32");
+
+    export_filterbank<filterbank<double>>("Filterbank");
+    export_filterbank<filterbank<float>>("FilterbankFloat32");
+    export_filterbank<filterbank<double, core::slaney1993>>("Slaney1993Filterbank");
+    export_filterbank<filterbank<float, core::slaney1993>>("Slaney1993FilterbankFloat32");
+    export_filterbank<filterbank<double, core::convolution>>("ConvolutionFilterbank");
+    export_filterbank<filterbank<float, core::convolution>>("ConvolutionFilterbankFloat32");
+
+    export_filterbank<filterbank<double, core::cooke1993, fixed_overlap>>(
+        "FixedOverlapFilterbank");
+    export_filterbank<filterbank<float, core::cooke1993, fixed_overlap>>(
+        "FixedOverlapFilterbankFloat32");
+    export_filterbank<filterbank<double, core::slaney1993, fixed_overlap>>(
+        "Slaney1993FixedOverlapFilterbank");
+    export_filterbank<filterbank<float, core::slaney1993, fixed_overlap>>(
+        "Slaney1993FixedOverlapFilterbankFloat32");
+    export_filterbank<filterbank<double, core::convolution, fixed_overlap>>(
+        "ConvolutionFixedOverlapFilterbank");
+    export_filterbank<filterbank<float, core::convolution, fixed_overlap>>(
+        "ConvolutionFixedOverlapFilterbankFloat32");
 }
 
 
-void export_filter()
+template<class Filter>
+void export_filter(const char* name)
 {
-    // we export the default filter type
-    using filter = gammatone::filter<scalar>;
+    using filter = Filter;
+    using scalar = typename filter::scalar_type;
+
+    const std::string doc =
+        std::string("A gammatone filter of given sample and center frequencies (Hz).")
+        + thread_safety;
 
-    py::class_<filter>("Filter", py::init<scalar, scalar>())
+    py::class_<filter>(name, doc.c_str(), py::init<scalar, scalar>())
         .def_readonly("sample_frequency", &filter::sample_frequency)
         .def_readonly("center_frequency", &filter::center_frequency)
         .def_readonly("bandwidth", &filter::bandwidth)
         .def_readonly("gain", &filter::gain)
-        .def("reset", &filter::reset)
-        .def("_compute", &filter::compute_allocate);
+        .def("reset", &exclusive_reset<filter>)
+        .def("_compute", &exclusive_compute<filter>)
+        .def("_compute_ptr", &filter_compute_ptr<filter>)
+        .setattr("dtype", dtype<scalar>::name());
 }
 
 
-void export_filterbank()
+template<class Filterbank>
+void export_filterbank(const char* name)
 {
-    py::class_<std::vector<scalar>>("std_vector_double")
-        .def(py::vector_indexing_suite<std::vector<scalar>>());
+    using filterbank = Filterbank;
+    using scalar = typename filterbank::scalar_type;
 
-    // we export the default filterbank type
-    using filterbank = gammatone::filterbank<scalar>;
+    const std::string doc =
+        std::string("A gammatone filterbank of given sample, lowest and highest center\n"
+                    "frequencies (Hz) and channels parameter.")
+        + thread_safety;
 
     py::class_<filterbank>(
-        "Filterbank", py::init<scalar, scalar, scalar, filterbank::channels::param_type>())
+        name, doc.c_str(),
+        py::init<scalar, scalar, scalar, typename filterbank::channels::param_type>())
         .def_readonly("sample_frequency", &filterbank::sample_frequency)
         .def_readonly("center_frequency", &filterbank::center_frequency)
         .def_readonly("nb_channels", &filterbank::nb_channels)
         .def_readonly("bandwidth", &filterbank::bandwidth)
         .def_readonly("gain", &filterbank::gain)
-        .def("reset", &filterbank::reset)
-        .def("_compute", &filterbank::compute_allocate);
+        .def("reset", &exclusive_reset<filterbank>)
+        .def("_compute", &exclusive_compute<filterbank>)
+        .def("_compute_ptr", &filterbank_compute_ptr<filterbank>)
+        .def("_compute_batch", &filterbank_compute_batch<filterbank>)
+        .setattr("dtype", dtype<scalar>::name());
 }
@@ -17,7 +17,23 @@
 # You should have received a copy of the GNU General Public License
 # along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
 
+from ctypes.util import find_library
 from setuptools import setup, Extension
+import sys
+
+
+def boost_python():
+    # since boost 1.67 the library is named after the Python version
+    # (e.g. boost_python311), older ones used boost_python3 or
+    # boost_python
+    major, minor = sys.version_info[:2]
+    names = ['boost_python{}{}'.format(major, minor),
+             'boost_python{}'.format(major),
+             'boost_python']
+    for name in names:
+        if find_library(name):
+            return name
+    return names[-1]
 
 # TODO version should be configured from cmake
 setup(
@@ -36,6 +52,7 @@ setup(
         '_gammatone',
         ['gammatone/gammatone.cpp'],
         include_dirs=['../include'],
-        libraries=['boost_python'],
-        extra_compile_args=['-std=c++11']  # -O2 -std=c++11
+        libraries=[boost_python()],
+        extra_compile_args=['-std=c++11', '-pthread'],  # -O2 -std=c++11
+        extra_link_args=['-pthread']
              )])
@@ -0,0 +1,281 @@
+#!/usr/bin/env python
+#
+# Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+#
+# This file is part of libgammatone
+#
+# libgammatone is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+"""Tests of the numpy interface of the gammatone module
+
+Run from the build directory, or from the source directory once the
+module is built in ../build/python.
+
+"""
+
+import numpy as np
+import os
+import sys
+import threading
+import unittest
+
+sys.path.append(os.path.abspath('../build/python'))
+import gammatone
+
+fs = 44100
+
+
+def noise(size, dtype=np.float64, seed=0):
+    return np.random.RandomState(seed).uniform(-1, 1, size).astype(dtype)
+
+
+def per_sample(filt, input_array):
+    # reference outputs computed sample by sample in C++
+    return np.array([np.array(filt._compute(float(x))) for x in input_array],
+                    dtype=filt.dtype)
+
+
+class ComputeTest(unittest.TestCase):
+    def test_filter(self):
+        x = noise(1000)
+        out = gammatone.Filter(fs, 1000).compute(x)
+        ref = per_sample(gammatone.Filter(fs, 1000), x)
+
+        self.assertEqual(out.shape, (1000,))
+        self.assertEqual(out.dtype, np.float64)
+        np.testing.assert_allclose(out, ref, rtol=0, atol=1e-10)
+
+    def test_filterbank(self):
+        x = noise(1000)
+        out = gammatone.Filterbank(fs, 300, 8000, 10).compute(x)
+        ref = per_sample(gammatone.Filterbank(fs, 300, 8000, 10), x)
+
+        self.assertEqual(out.shape, (1000, 10))
+        np.testing.assert_allclose(out, ref, rtol=0, atol=1e-10)
+
+    def test_state_is_kept(self):
+        x = noise(1000)
+        fb = gammatone.Filterbank(fs, 300, 8000, 10)
+        whole = gammatone.Filterbank(fs, 300, 8000, 10).compute(x)
+        parts = np.concatenate([fb.compute(x[:300]), fb.compute(x[300:])])
+        np.testing.assert_array_equal(parts, whole)
+
+        fb.reset()
+        np.testing.assert_array_equal(fb.compute(x), whole)
+
+    def test_conversions(self):
+        # lists, non-contiguous arrays and other precisions are converted
+        x = noise(2000)
+        ref = gammatone.Filterbank(fs, 300, 8000, 10).compute(x[::2])
+        out = gammatone.Filterbank(fs, 300, 8000, 10).compute(list(x[::2]))
+        np.testing.assert_array_equal(out, ref)
+
+        y = x.astype(np.float32)
+        ref = gammatone.Filterbank(fs, 300, 8000, 10).compute(y.astype(np.float64))
+        out = gammatone.Filterbank(fs, 300, 8000, 10).compute(y)
+        np.testing.assert_array_equal(out, ref)
+
+    def test_out(self):
+        x = noise(1000)
+        fb = gammatone.Filterbank(fs, 300, 8000, 10)
+        out = np.empty((1000, 10))
+        self.assertIs(fb.compute(x, out=out), out)
+        np.testing.assert_array_equal(out, gammatone.Filterbank(fs, 300, 8000, 10).compute(x))
+
+        with self.assertRaises(ValueError):
+            fb.compute(x, out=np.empty((1000, 9)))
+        with self.assertRaises(TypeError):
+            fb.compute(x, out=np.empty((1000, 10), dtype=np.float32))
+
+    def test_bad_input(self):
+        with self.assertRaises(AssertionError):
+            gammatone.Filter(fs, 1000).compute(np.zeros((10, 2)))
+
+
+
+# exported types with their parameters besides the sample frequency
+filter_types = [
+    gammatone.Filter, gammatone.FilterFloat32,
+    gammatone.Slaney1993Filter, gammatone.Slaney1993FilterFloat32,
+    gammatone.ConvolutionFilter, gammatone.ConvolutionFilterFloat32]
+
+filterbank_types = [
+    (gammatone.Filterbank, 10), (gammatone.FilterbankFloat32, 10),
+    (gammatone.Slaney1993Filterbank, 10), (gammatone.Slaney1993FilterbankFloat32, 10),
+    (gammatone.ConvolutionFilterbank, 10), (gammatone.ConvolutionFilterbankFloat32, 10),
+    (gammatone.FixedOverlapFilterbank, 0.5), (gammatone.FixedOverlapFilterbankFloat32, 0.5),
+    (gammatone.Slaney1993FixedOverlapFilterbank, 0.5),
+    (gammatone.Slaney1993FixedOverlapFilterbankFloat32, 0.5),
+    (gammatone.ConvolutionFixedOverlapFilterbank, 0.5),
+    (gammatone.ConvolutionFixedOverlapFilterbankFloat32, 0.5)]
+
+
+def tolerance(out):
+    # the blocks are computed by other kernels than single samples,
+    # and by FFT for the convolution
+    eps = 1e-5 if out.dtype == np.float32 else 1e-11
+    return eps * max(1.0, np.abs(out).max())
+
+
+class TypesTest(unittest.TestCase):
+    def test_filters(self):
+        x = noise(3000)
+        for filter_type in filter_types:
+            out = filter_type(fs, 1000).compute(x)
+            ref = per_sample(filter_type(fs, 1000), x.astype(filter_type.dtype))
+
+            self.assertEqual(out.dtype, np.dtype(filter_type.dtype), filter_type)
+            np.testing.assert_allclose(out, ref, rtol=0, atol=tolerance(ref),
+                                       err_msg=filter_type.__name__)
+
+    def test_filterbanks(self):
+        x = noise(3000)
+        for bank_type, param in filterbank_types:
+            fb = bank_type(fs, 300, 8000, param)
+            out = fb.compute(x)
+            ref = per_sample(bank_type(fs, 300, 8000, param), x.astype(bank_type.dtype))
+
+            self.assertEqual(out.shape, (3000, fb.nb_channels), bank_type)
+            self.assertEqual(out.dtype, np.dtype(bank_type.dtype), bank_type)
+            np.testing.assert_allclose(out, ref, rtol=0, atol=tolerance(ref),
+                                       err_msg=bank_type.__name__)
+
+    def test_precisions(self):
+        # float32 types compute the same channels than float64 ones
+        x = noise(3000)
+        for (bank64, param), (bank32, _) in zip(filterbank_types[::2], filterbank_types[1::2]):
+            fb64, fb32 = bank64(fs, 300, 8000, param), bank32(fs, 300, 8000, param)
+            self.assertEqual(fb32.dtype, 'float32')
+            self.assertEqual(fb64.dtype, 'float64')
+            self.assertEqual(fb32.nb_channels, fb64.nb_channels)
+            np.testing.assert_allclose(list(fb32.center_frequency),
+                                       list(fb64.center_frequency), rtol=1e-6)
+
+            # relative to the amplitude of each channel, the float32
+            # biquads of slaney1993 losing up to 4e-4 at low frequencies
+            out64 = fb64.compute(x.astype(np.float32))
+            error = np.abs(fb32.compute(x) - out64).max(axis=0)
+            np.testing.assert_array_less(error, 1e-3 * np.abs(out64).max(axis=0),
+                                         err_msg=bank32.__name__)
+
+
+class ChunkTest(unittest.TestCase):
+    def test_process_chunk(self):
+        x = noise(1000)
+        ref = gammatone.Filterbank(fs, 300, 8000, 10).compute(x)
+
+        fb = gammatone.Filterbank(fs, 300, 8000, 10)
+        fb.set_ring(300, 2)
+        self.assertEqual(fb.ring(), [])
+        outputs = [fb.process_chunk(x[k:k+300]).copy() for k in range(0, 1000, 300)]
+        np.testing.assert_array_equal(np.concatenate(outputs), ref)
+
+        # the two last chunks, the last one being shorter
+        ring = fb.ring()
+        self.assertEqual([r.shape for r in ring], [(300, 10), (100, 10)])
+        np.testing.assert_array_equal(ring[0], ref[600:900])
+        np.testing.assert_array_equal(ring[1], ref[900:])
+
+    def test_out(self):
+        x = noise(1000)
+        fb = gammatone.Filterbank(fs, 300, 8000, 10)
+        out = np.empty((1000, 10))
+        self.assertIs(fb.process_chunk(x, out), out)
+        np.testing.assert_array_equal(out, gammatone.Filterbank(fs, 300, 8000, 10).compute(x))
+        self.assertEqual(fb.ring(), [])
+
+    def test_errors(self):
+        x = noise(1000)
+        fb = gammatone.Filterbank(fs, 300, 8000, 10)
+        with self.assertRaises(RuntimeError):
+            fb.process_chunk(x)
+
+        # the ring is left unchanged
+        fb.set_ring(300, 2)
+        fb.process_chunk(x[:300])
+        with self.assertRaises(ValueError):
+            fb.process_chunk(x[300:])
+        with self.assertRaises(TypeError):
+            fb.process_chunk(x[300:600].astype(np.float32))
+        self.assertEqual(len(fb.ring()), 1)
+
+        fb.process_chunk(x[300:600])
+        np.testing.assert_array_equal(
+            np.concatenate(fb.ring()), gammatone.Filterbank(fs, 300, 8000, 10).compute(x[:600]))
+
+
+class BatchTest(unittest.TestCase):
+    def test_compute_batch(self):
+        # as many filterbanks computing each input from the initial state
+        inputs = [noise(n, seed=n) for n in (0, 1, 100, 5000, 20000)]
+        for bank_type in (gammatone.Filterbank, gammatone.Slaney1993Filterbank,
+                          gammatone.ConvolutionFilterbank):
+            fb = bank_type(fs, 300, 8000, 10)
+            fb.compute(noise(100))
+            for n_threads in (0, 1, 3):
+                outputs = fb.compute_batch(inputs, n_threads)
+                self.assertEqual(len(outputs), len(inputs))
+                for x, out in zip(inputs, outputs):
+                    np.testing.assert_array_equal(out, bank_type(fs, 300, 8000, 10).compute(x))
+
+    def test_wrong_outputs(self):
+        fb = gammatone.Filterbank(fs, 300, 8000, 10)
+        with self.assertRaises(ValueError):
+            fb._compute_batch([noise(10)], [], 0)
+        with self.assertRaises(ValueError):
+            fb._compute_batch([noise(10)], [np.empty((10, 9))], 0)
+
+
+class ThreadTest(unittest.TestCase):
+    def test_distinct_objects(self):
+        x = noise(200000)
+        ref = gammatone.Filterbank(fs, 300, 8000, 10).compute(x)
+        banks = [gammatone.Filterbank(fs, 300, 8000, 10) for _ in range(4)]
+        outputs = [None] * len(banks)
+
+        def run(k):
+            outputs[k] = banks[k].compute(x)
+
+        threads = [threading.Thread(target=run, args=(k,)) for k in range(len(banks))]
+        for t in threads: t.start()
+        for t in threads: t.join()
+        for out in outputs:
+            np.testing.assert_array_equal(out, ref)
+
+    def test_same_object(self):
+        # the main thread tries to use the filterbank while a thread computes it
+        x = noise(2000000)
+        fb = gammatone.Filterbank(fs, 300, 8000, 10)
+        outputs = []
+        thread = threading.Thread(target=lambda: outputs.append(fb.compute(x)))
+
+        refused = 0
+        thread.start()
+        while thread.is_alive():
+            try:
+                fb.reset()
+            except RuntimeError:
+                refused += 1
+        thread.join()
+
+        self.assertGreater(refused, 0)
+        np.testing.assert_array_equal(
+            outputs[0], gammatone.Filterbank(fs, 300, 8000, 10).compute(x))
+
+        # the object is usable again
+        fb.reset()
+        fb.compute(x[:10])
+
+
+if __name__ == '__main__':
+    unittest.main()
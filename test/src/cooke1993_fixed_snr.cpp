@@ -0,0 +1,87 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// SNR of core::cooke1993_fixed against core::cooke1993<double>, for
+// the channels of a fixed_size filterbank
+
+#include <gammatone/core/cooke1993.hpp>
+#include <gammatone/core/cooke1993_fixed.hpp>
+#include <gammatone/policy/bandwidth.hpp>
+#include <gammatone/policy/channels.hpp>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+using namespace gammatone;
+
+const double fs = 44100;
+
+// 10 seconds of white noise at -6 dBFS
+template<class Integer>
+std::vector<Integer> signal()
+{
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<double> uniform(-0.5, 0.5);
+  std::vector<Integer> x(10*static_cast<std::size_t>(fs));
+  for(auto& v : x) v = detail::quantize<Integer>(uniform(generator));
+  return x;
+}
+
+template<class Integer, class RoundingPolicy>
+double snr(const double& cf, const std::vector<Integer>& x)
+{
+  const double bw = policy::bandwidth::glasberg1990<double>::bandwidth(cf);
+  core::cooke1993<double> reference(fs, cf, bw);
+  core::cooke1993_fixed<Integer, RoundingPolicy> fixed(fs, cf, bw);
+
+  std::vector<Integer> y(x.size());
+  fixed.compute_block(x.data(), y.data(), x.size());
+
+  double signal = 0, noise = 0;
+  for(std::size_t i = 0; i < x.size(); ++i)
+    {
+      double z;
+      reference.compute(detail::dequantize(x[i]), z);
+      z *= fixed.scale();
+      signal += z*z;
+      noise += std::pow(z - detail::dequantize(y[i]), 2);
+    }
+  return 10*std::log10(signal / noise);
+}
+
+int main()
+{
+  using channels = policy::channels::fixed_size<double, policy::bandwidth::glasberg1990>;
+  const auto cf = channels::setup(50, 8000, channels::default_parameter()).first;
+
+  const auto x15 = signal<std::int16_t>();
+  const auto x31 = signal<std::int32_t>();
+
+  std::printf("  cf (Hz) |  Q15 nearest  convergent  truncate |  Q31 nearest  convergent  truncate\n");
+  for(const auto& f : cf)
+    std::printf("%9.1f | %12.1f %11.1f %9.1f | %12.1f %11.1f %9.1f\n", f,
+                snr<std::int16_t, policy::rounding::nearest>(f, x15),
+                snr<std::int16_t, policy::rounding::convergent>(f, x15),
+                snr<std::int16_t, policy::rounding::truncate>(f, x15),
+                snr<std::int32_t, policy::rounding::nearest>(f, x31),
+                snr<std::int32_t, policy::rounding::convergent>(f, x31),
+                snr<std::int32_t, policy::rounding::truncate>(f, x31));
+
+  return 0;
+}
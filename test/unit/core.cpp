@@ -22,13 +22,18 @@
 #include <boost/mpl/joint_view.hpp>
 
 #include <gammatone/core/cooke1993.hpp>
+#include <gammatone/core/cooke1993_fixed.hpp>
+#include <gammatone/core/cooke1993_bank.hpp>
 #include <gammatone/core/slaney1993.hpp>
 #include <gammatone/core/convolution.hpp>
+#include <gammatone/core/convolution_bank.hpp>
 #include <gammatone/policy/gain.hpp>
 #include <gammatone/policy/clipping.hpp>
+#include <gammatone/detail/utils.hpp>
 
 #include <test_utils.hpp>
 #include <vector>
+#include <complex>
 #include <algorithm>
 #include <numeric>
 #include <iterator>
@@ -51,6 +56,9 @@ using t3 = boost::mpl::list< c3<a1,b1>, c3<a1,b2>, c3<a2,b1>, c3<a2,b2>>;
 using core_ref = c1<a1,b1>;
 using core_types = boost::mpl::joint_view<boost::mpl::joint_view<t1,t2>::type,t3>::type;
 
+// fixed-point formats
+using fixed_types = boost::mpl::list<std::int16_t, std::int32_t>;
+
 const vector<double> in1 = utils::make_sinus(44100,1000,10000);
 const vector<double> in2 = utils::make_sinus(44100,500,10000);
 const vector<double> in3 = utils::random<double>(-1.0,1.0,10000);
@@ -106,6 +114,373 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(linear, C, core_types)
 }
 
 
+//================================================
+// compute_block must give the same result as successive calls to
+// compute, whatever the block size.
+BOOST_AUTO_TEST_CASE_TEMPLATE(compute_block_works, C, core_types)
+{
+  C c1(44100,1000,100), c2(44100,1000,100);
+
+  for(const auto& in : {in1,in3})
+    {
+      c1.reset();
+      c2.reset();
+
+      vector<double> out1(in.size());
+      std::transform(in.begin(),in.end(),out1.begin(),
+                     [&](double x){double y; c1.compute(x,y);return y;});
+
+      vector<double> out2(in.size());
+      size_t first = 0;
+      for(size_t size : {0,1,7,100,1000})
+        {
+          c2.compute_block(in.data()+first, out2.data()+first, size);
+          first += size;
+        }
+      c2.compute_block(in.data()+first, out2.data()+first, in.size()-first);
+
+      for(size_t i=0;i<in.size();i++)
+        BOOST_CHECK_EQUAL(out1[i],out2[i]);
+    }
+}
+
+
+//================================================
+// The partitioned FFT convolution must give the direct convolution
+// result up to rounding errors, whatever the block size.
+BOOST_AUTO_TEST_CASE(convolution_partitions_works)
+{
+  using conv = core::convolution<T>;
+
+  for(T cf : {100.0, 1000.0, 8000.0})
+    {
+      const T bw = 24.7 + 0.108*cf;
+      conv direct(44100, cf, bw, 0);
+      BOOST_CHECK_EQUAL(direct.nb_partitions(), 1);
+
+      vector<T> ref(in3.size());
+      direct.compute_block(in3.data(), ref.data(), in3.size());
+      const T scale = detail::absmax(ref.begin(), ref.end());
+
+      for(size_t b : {1, 50, 64, 1000})
+        {
+          conv c(44100, cf, bw, b);
+          // short impulse responses are always convolved directly
+          const size_t n = direct.block_size();
+          BOOST_CHECK_GE(c.block_size(), std::min(b, n));
+          BOOST_CHECK_EQUAL(c.nb_partitions(),
+                            n <= detail::partitioned_convolution<T>::direct_size ? 1 :
+                            (n + c.block_size() - 1) / c.block_size());
+
+          // in two calls with a copy in between to check states are kept
+          vector<T> out(in3.size());
+          c.compute_block(in3.data(), out.data(), 333);
+          conv c2(c);
+          c2.compute_block(in3.data() + 333, out.data() + 333, in3.size() - 333);
+
+          for(size_t i=0;i<in3.size();i++)
+            BOOST_CHECK_SMALL(out[i] - ref[i], 1e-12*scale);
+        }
+    }
+}
+
+
+//================================================
+// The convolution is only built on the first computation, the
+// accessors giving the same values before and after it.
+BOOST_AUTO_TEST_CASE(convolution_lazy_works)
+{
+  using conv = core::convolution<T>;
+
+  for(T cf : {100.0, 8000.0})
+    {
+      const T bw = 24.7 + 0.108*cf;
+      conv c1(44100, cf, bw), c2(44100, cf, bw);
+      c1.reset();
+      const size_t block = c1.block_size(), partitions = c1.nb_partitions();
+      const vector<T> ir = c1.impulse_response();
+
+      vector<T> out1(in3.size()), out2(in3.size());
+      c2.compute_block(in3.data(), out2.data(), in3.size());
+      BOOST_CHECK_EQUAL(c2.block_size(), block);
+      BOOST_CHECK_EQUAL(c2.nb_partitions(), partitions);
+      BOOST_CHECK(c2.impulse_response() == ir);
+
+      // a copy of an unused core computes as the original
+      conv c3(c1);
+      c3.compute_block(in3.data(), out1.data(), in3.size());
+      for(size_t i=0;i<in3.size();i++)
+        BOOST_CHECK_EQUAL(out1[i], out2[i]);
+    }
+}
+
+
+//================================================
+// A convolution bank sharing its input history must give the
+// result of each convolution core, in mixed direct and FFT modes.
+BOOST_AUTO_TEST_CASE(convolution_bank_works)
+{
+  using conv = core::convolution<T>;
+  using bank = core::convolution_bank<T>;
+
+  const vector<T> cf({100, 1000, 8000}), bw({35.5, 132.7, 888.7});
+  for(size_t b : {0, 16, 64})
+    {
+      bank cb(44100, cf, bw, b);
+      BOOST_CHECK_EQUAL(cb.nb_channels(), cf.size());
+
+      // one sample, then a slice per channel, then the whole bank
+      vector<T> out(in3.size()*cf.size());
+      cb.compute(in3[0], out.data());
+      for(size_t j=0;j<cf.size();j++)
+        cb.compute_strided(499, in3.data()+1, out.data()+cf.size(), cf.size(), 1, j, j+1);
+      cb.advance(499, in3.data()+1);
+      cb.compute_ptr(in3.size()-500, in3.data()+500, out.data()+500*cf.size());
+
+      for(size_t j=0;j<cf.size();j++)
+        {
+          conv c(44100, cf[j], bw[j], b);
+          BOOST_CHECK_GE(cb.history_size(), c.block_size());
+          for(size_t i=0;i<in3.size();i++)
+            {
+              T y;
+              c.compute(in3[i], y);
+              BOOST_CHECK_EQUAL(y, out[i*cf.size()+j]);
+            }
+        }
+    }
+}
+
+
+//================================================
+// The real part of the analytic output is the output of the core,
+// its modulus is the envelope of a tone and its argument follows
+// the phase of the tone.
+BOOST_AUTO_TEST_CASE(analytic_works)
+{
+  const T fs = 44100;
+  for(T cf : {100.0, 1000.0, 8000.0})
+    {
+      const T bw = 24.7 + 0.108*cf;
+      const vector<T> tone = utils::make_sinus(fs, cf, 20000);
+      const size_t size = tone.size();
+
+      core::cooke1993<T> k1(fs, cf, bw), k2(k1);
+      core::convolution<T> v1(fs, cf, bw), v2(v1), v3(v1);
+
+      vector<T> y(size), w(size);
+      vector<complex<T> > z(size), zv(size), zl(size);
+      k1.compute_block(tone.data(), y.data(), size);
+      k2.compute_block_complex(tone.data(), z.data(), size);
+      v1.compute_block(tone.data(), w.data(), size);
+      v2.compute_block_complex(tone.data(), zv.data(), size);
+
+      // the quadrature of a convolution core may be enabled at any time
+      vector<T> first(3001);
+      v3.compute_block(tone.data(), first.data(), first.size());
+      v3.compute_block_complex(tone.data() + 3001, zl.data() + 3001, size - 3001);
+
+      // as well by the scalar code of a bank
+      core::cooke1993_bank<T> bank(fs, {cf}, {bw});
+      bank.set_kernel(core::cooke1993_bank<T>::kernel_type::scalar);
+      vector<complex<T> > zb(size);
+      bank.compute_ptr_complex(size, tone.data(), zb.data());
+
+      for(size_t i=0;i<size;i++)
+        {
+          BOOST_CHECK_EQUAL(z[i].real(), y[i]);
+          BOOST_CHECK_EQUAL(zb[i], z[i]);
+          BOOST_CHECK_EQUAL(zv[i].real(), w[i]);
+          if(i >= 3001) BOOST_CHECK_EQUAL(zl[i], zv[i]);
+        }
+
+      // in steady state, up to the ripple of the image at twice the
+      // center frequency
+      const T dphi = 2*M_PI*cf/fs;
+      for(const auto& x : {z, zv})
+        {
+          const T gain = abs(x.back());
+          for(size_t i=size-1000;i<size;i++)
+            {
+              BOOST_CHECK_CLOSE(abs(x[i]), gain, 0.5);
+              BOOST_CHECK_SMALL(remainder(arg(x[i]) - arg(x[i-1]) - dphi, 2*M_PI), 1e-2);
+            }
+        }
+    }
+}
+
+
+//================================================
+// The fixed-point core must follow the double one up to its
+// quantization noise, and saturate on overflow.
+BOOST_AUTO_TEST_CASE_TEMPLATE(cooke1993_fixed_works, I, fixed_types)
+{
+  // SNR bounds, see the cooke1993_fixed_snr test
+  const double bound = sizeof(I) == 2 ? 45 : 130;
+
+  vector<I> x(in3.size());
+  for(size_t i=0;i<x.size();i++) x[i] = detail::quantize<I>(in3[i]/2);
+
+  const vector<T> cf({100, 1000, 8000}), bw({35.5, 132.7, 888.7});
+  for(size_t j=0;j<cf.size();j++)
+    {
+      core::cooke1993<T> ref(44100, cf[j], bw[j]);
+      core::cooke1993_fixed<I> fixed(44100, cf[j], bw[j]);
+
+      vector<I> y(x.size());
+      fixed.compute_block(x.data(), y.data(), x.size());
+
+      T signal = 0, noise = 0;
+      for(size_t i=0;i<x.size();i++)
+        {
+          T z;
+          ref.compute(detail::dequantize(x[i]), z);
+          z *= fixed.scale();
+          signal += z*z;
+          noise += pow(z - detail::dequantize(y[i]), 2);
+        }
+      BOOST_CHECK_GT(10*log10(signal/noise), bound);
+
+      // a full scale tone at the center frequency saturates without
+      // wrapping around
+      fixed.reset();
+      const I max = detail::quantize<I>(1.0);
+      I ymax = 0;
+      for(size_t i=0;i<x.size();i++)
+        {
+          I z;
+          fixed.compute(sin(2*M_PI*cf[j]*i/44100) > 0 ? max : -max, z);
+          BOOST_CHECK_LE(abs(T(z)), T(max));
+          ymax = std::max(ymax, z);
+        }
+      BOOST_CHECK_EQUAL(ymax, max);
+    }
+}
+
+
+//================================================
+// The decimated base-band output of cooke1993 must modulate back to
+// the filter output, and its envelope follow the amplitude of a tone.
+BOOST_AUTO_TEST_CASE(cooke1993_baseband_works)
+{
+  using cooke = core::cooke1993<T>;
+  const T fs = 44100;
+  const vector<T> cf({100, 1000, 8000}), bw({35.5, 132.7, 888.7});
+
+  for(size_t j=0;j<cf.size();j++)
+    {
+      // without decimation
+      cooke c1(fs, cf[j], bw[j]), c2(c1);
+      vector<T> y(in3.size());
+      vector<complex<T> > b(in3.size());
+      c1.compute_block(in3.data(), y.data(), in3.size());
+      BOOST_CHECK_EQUAL(c2.compute_baseband(in3.data(), b.data(), in3.size()), in3.size());
+
+      T scale = 0;
+      for(const auto& x : y) scale = std::max(scale, abs(x));
+      for(size_t i=0;i<in3.size();i++)
+        BOOST_CHECK_SMALL(y[i] - real(b[i]*polar(1.0, 2*M_PI*cf[j]/fs*i)), 1e-9*scale);
+
+      // the envelope of a tone at the center frequency is its
+      // amplitude times the filter gain, whatever the decimation, up
+      // to the ripple of its image at twice the center frequency
+      const auto tone = utils::make_sinus(fs, cf[j], 44100);
+      c1.reset();
+      vector<T> z(tone.size());
+      c1.compute_block(tone.data(), z.data(), tone.size());
+      const T gain = *max_element(z.end() - 1000, z.end());
+
+      for(size_t d : {1, 7, 441})
+        {
+          c1.reset();
+          c1.set_decimation(d);
+          BOOST_CHECK_EQUAL(c1.decimation(), d);
+
+          // in two calls, not on a frame boundary
+          vector<T> e(tone.size()/d + 2);
+          size_t n = c1.compute_envelope(tone.data(), e.data(), 1000);
+          n += c1.compute_envelope(tone.data() + 1000, e.data() + n, tone.size() - 1000);
+          BOOST_CHECK_EQUAL(n, tone.size()/d);
+          BOOST_CHECK_CLOSE(e[n-1], gain, 0.5);
+        }
+    }
+
+  // a bank gives the result of each core
+  core::cooke1993_bank<T> bank(fs, cf, bw);
+  bank.set_decimation(100);
+  vector<T> e((in3.size()/100 + 1)*cf.size());
+  vector<complex<T> > b(e.size());
+  const size_t n = bank.compute_envelope(in3.size(), in3.data(), e.data());
+  bank.reset();
+  BOOST_CHECK_EQUAL(bank.compute_baseband(in3.size(), in3.data(), b.data()), n);
+  BOOST_CHECK_EQUAL(n, in3.size()/100);
+
+  for(size_t j=0;j<cf.size();j++)
+    {
+      cooke c1(fs, cf[j], bw[j]), c2(c1);
+      c1.set_decimation(100);
+      c2.set_decimation(100);
+      vector<T> e1(n);
+      vector<complex<T> > b1(n);
+      c1.compute_envelope(in3.data(), e1.data(), in3.size());
+      c2.compute_baseband(in3.data(), b1.data(), in3.size());
+      for(size_t m=0;m<n;m++)
+        {
+          BOOST_CHECK_EQUAL(e1[m], e[m*cf.size()+j]);
+          BOOST_CHECK_EQUAL(b1[m], b[m*cf.size()+j]);
+        }
+    }
+
+  // with the scalar code as well
+  core::cooke1993_bank<T> scalar(fs, cf, bw);
+  scalar.set_kernel(core::cooke1993_bank<T>::kernel_type::scalar);
+  scalar.set_decimation(100);
+  vector<T> e2(e.size());
+  BOOST_CHECK_EQUAL(scalar.compute_envelope(in3.size(), in3.data(), e2.data()), n);
+  for(size_t k=0;k<n*cf.size();k++)
+    BOOST_CHECK_EQUAL(e2[k], e[k]);
+}
+
+
+//================================================
+// With clipping, each section of the cooke1993 cascade is clipped:
+// outputs are unchanged above the threshold, and the whole state
+// falls to zero after the input stops, instead of denormal values.
+BOOST_AUTO_TEST_CASE(cooke1993_clipping_works)
+{
+  c3<a1,b1> off(44100, 1000, 132.7);
+  c3<a1,b2> on(44100, 1000, 132.7);
+
+  vector<T> y1(in3.size()), y2(in3.size());
+  off.compute_block(in3.data(), y1.data(), in3.size());
+  on.compute_block(in3.data(), y2.data(), in3.size());
+  for(size_t i=0;i<in3.size();i++)
+    BOOST_CHECK_EQUAL(y1[i], y2[i]);
+
+  // compute() clips as compute_block()
+  c3<a1,b2> on2(on);
+  T z1, z2;
+  on.compute(0.5, z1);
+  const T half = 0.5;
+  on2.compute_block(&half, &z2, 1);
+  BOOST_CHECK_EQUAL(z1, z2);
+
+  // 1 - r ~ 0.019 at 1 kHz, the states are about 1e-240 after
+  // 30000 samples, below the clipping threshold of 1e-200
+  const vector<T> zeros(30000, 0.0);
+  vector<T> out(zeros.size());
+  off.compute_block(zeros.data(), out.data(), zeros.size());
+  on.compute_block(zeros.data(), out.data(), zeros.size());
+
+  BOOST_CHECK_EQUAL(out.back(), 0.0);
+  for(const T& s : on.state())
+    BOOST_CHECK_EQUAL(s, 0.0);
+
+  const auto s = off.state();
+  BOOST_CHECK(std::any_of(s.begin(), s.end(), [](const T& x){return x != 0.0;}));
+}
+
+
 // //================================================
 // // Check that all cores have same response
 
@@ -0,0 +1,192 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <filterbank_types.h>
+#include <gammatone/filterbank_design.hpp>
+#include <test_utils.hpp>
+using namespace gammatone;
+
+// designs checked in both precisions
+using design_types = boost::mpl::list
+  <
+  gammatone::filterbank_design<double,a1>,
+  gammatone::filterbank_design<double,a2>,
+  gammatone::filterbank_design<double,a3>,
+  gammatone::filterbank_design<float,a1>,
+  gammatone::filterbank_design<float,a2>,
+  gammatone::filterbank_design<float,a3>
+  >;
+
+using design_scalars = boost::mpl::list<float,double>;
+
+
+BOOST_AUTO_TEST_SUITE(design_test)
+
+//================================================
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(compute_works, D, design_types)
+{
+    using T = typename D::scalar_type;
+    const std::size_t size = 1000;
+
+    const D design(44100, 500, 8000);
+    typename D::filterbank_type bank(44100, 500, 8000);
+    BOOST_CHECK_EQUAL(design.nb_channels(), bank.nb_channels());
+    BOOST_CHECK_EQUAL(design.sample_frequency(), bank.sample_frequency());
+    BOOST_CHECK_EQUAL(design.overlap(), bank.overlap());
+    BOOST_CHECK(design.center_frequency() == bank.center_frequency());
+
+    const std::size_t channels = design.nb_channels();
+    const auto x1 = utils::random<T>(-1.0, 1.0, size);
+    const auto x2 = utils::random<T>(-1.0, 1.0, size);
+
+    for(const layout l : {layout::interleaved, layout::planar})
+    {
+        std::vector<T> r1(size*channels), r2(size*channels);
+        bank.reset();
+        bank.compute_ptr(size, x1.data(), r1.data(), l);
+        bank.reset();
+        bank.compute_ptr(size, x2.data(), r2.data(), l);
+
+        // two states of a single design give the outputs of two filterbanks
+        auto s1 = design.make_state(), s2 = design.make_state();
+        BOOST_CHECK_EQUAL(s1.nb_channels(), channels);
+
+        std::vector<T> y1(size*channels), y2(size*channels);
+        design.compute_ptr(s1, size, x1.data(), y1.data(), l);
+        design.compute_ptr(s2, size, x2.data(), y2.data(), l);
+        BOOST_CHECK(r1 == y1);
+        BOOST_CHECK(r2 == y2);
+
+        // a reset state starts over
+        s1.reset();
+        std::fill(y1.begin(), y1.end(), 0);
+        design.compute_ptr(s1, size, x1.data(), y1.data(), l);
+        BOOST_CHECK(r1 == y1);
+    }
+
+    // interleaved calls on two states, the input being split across
+    // calls, do not interfere
+    std::vector<T> r1(size*channels), r2(size*channels);
+    bank.reset();
+    bank.compute_ptr(size, x1.data(), r1.data());
+    bank.reset();
+    bank.compute_ptr(size, x2.data(), r2.data());
+
+    auto s1 = design.make_state(), s2 = design.make_state();
+    std::vector<T> y1(size*channels), y2(size*channels);
+    for(std::size_t i = 0; i < size; i += 300)
+    {
+        const std::size_t n = std::min<std::size_t>(300, size - i);
+        design.compute_ptr(s1, n, x1.data() + i, y1.data() + i*channels);
+        design.compute_ptr(s2, n, x2.data() + i, y2.data() + i*channels);
+    }
+    BOOST_CHECK(r1 == y1);
+    BOOST_CHECK(r2 == y2);
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(compute_batch_works, D, design_types)
+{
+    using T = typename D::scalar_type;
+    const D design(44100, 500, 8000);
+    const std::size_t channels = design.nb_channels();
+
+    // short inputs, an empty one and a long one split in slices
+    const std::vector<std::size_t> sizes = {100, 0, 3000, 1, 250, 40000, 700};
+    std::vector<std::vector<T> > x(sizes.size());
+    std::vector<const T*> inputs(sizes.size());
+    for(std::size_t i = 0; i < sizes.size(); ++i)
+    {
+        x[i] = utils::random<T>(-1.0, 1.0, sizes[i]);
+        inputs[i] = x[i].data();
+    }
+
+    for(const layout l : {layout::interleaved, layout::planar})
+        for(const std::size_t threads : {0, 1, 3})
+        {
+            std::vector<std::vector<T> > y(sizes.size());
+            std::vector<T*> outputs(sizes.size());
+            for(std::size_t i = 0; i < sizes.size(); ++i)
+            {
+                y[i].resize(sizes[i]*channels);
+                outputs[i] = y[i].data();
+            }
+
+            design.compute_batch(sizes.size(), sizes.data(), inputs.data(), outputs.data(),
+                                 l, threads);
+
+            for(std::size_t i = 0; i < sizes.size(); ++i)
+            {
+                auto state = design.make_state();
+                std::vector<T> r(sizes[i]*channels);
+                design.compute_ptr(state, sizes[i], x[i].data(), r.data(), l);
+                BOOST_CHECK(r == y[i]);
+            }
+        }
+}
+
+//================================================
+
+template<class Design, class T>
+void check_kernels(const std::vector<T>& cf, const std::vector<T>& bw)
+{
+    using isa = typename Design::kernel_type;
+    const std::size_t size = 600, channels = cf.size();
+    const auto x = utils::random<T>(-1.0, 1.0, size);
+
+    Design scalar(44100, cf, bw);
+    BOOST_CHECK(scalar.set_kernel(isa::scalar));
+    auto s = scalar.make_state();
+    std::vector<T> ref(size*channels);
+    scalar.compute_strided(s, size, x.data(), ref.data(), channels, 1);
+
+    for(auto kernel : {isa::sse2, isa::avx2, isa::avx512})
+    {
+        Design d(44100, cf, bw);
+        if(! d.set_kernel(kernel))
+        {
+            BOOST_CHECK(! detail::simd::supported(kernel));
+            continue;
+        }
+
+        // planar outputs in two calls, to check the state is kept
+        auto state = d.make_state();
+        std::vector<T> y(ref.size());
+        d.compute_strided(state, 400, x.data(), y.data(), 1, size);
+        d.compute_strided(state, size - 400, x.data() + 400, y.data() + 400, 1, size);
+
+        for(std::size_t i = 0; i < size; ++i)
+            for(std::size_t j = 0; j < channels; ++j)
+                BOOST_CHECK_EQUAL(ref[i*channels + j], y[j*size + i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(kernels_works, T, design_scalars)
+{
+    // a number of channels which is not a multiple of the vector size
+    const std::vector<T> cf = {100, 1000, 4000}, bw = {50, 150, 500};
+    check_kernels<core::cooke1993_design<T> >(cf, bw);
+    check_kernels<core::slaney1993_design<T> >(cf, bw);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,188 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <filterbank_types.h>
+#include <gammatone/design_cache.hpp>
+#include <gammatone/filterbank_design.hpp>
+#include <test_utils.hpp>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <stdlib.h>
+#include <unistd.h>
+using namespace gammatone;
+
+using cached_types = boost::mpl::list
+  <
+  gammatone::filterbank_design<double,a1>,
+  gammatone::filterbank_design<float,a2>,
+  gammatone::filterbank_design<double,a3>,
+  gammatone::filterbank_design<float,a3>
+  >;
+
+// outputs of a new state of a design
+template<class Design, class T>
+std::vector<T> outputs(const Design& design, const std::vector<T>& x)
+{
+  auto state = design.make_state();
+  std::vector<T> y(x.size() * design.nb_channels());
+  design.compute_ptr(state, x.size(), x.data(), y.data());
+  return y;
+}
+
+// a temporary directory removed at the end of the test
+struct temporary_directory
+{
+  temporary_directory()
+  {
+    char name[] = "/tmp/gammatone_design_cache_XXXXXX";
+    path = mkdtemp(name) ? name : "";
+  }
+
+  ~temporary_directory()
+  {
+    for(const auto& f : files) std::remove((path + "/" + f).c_str());
+    rmdir(path.c_str());
+  }
+
+  std::string path;
+  std::vector<std::string> files;
+};
+
+
+BOOST_AUTO_TEST_SUITE(design_cache_test)
+
+//================================================
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(memory_works, D, cached_types)
+{
+  using T = typename D::scalar_type;
+  design_cache::clear();
+  BOOST_CHECK_EQUAL(design_cache::size(), 0);
+
+  // a design is built once for given parameters
+  const auto d1 = D::cached(44100, 100, 8000, 16);
+  const auto d2 = D::cached(44100, 100, 8000, 16);
+  const auto d3 = D::cached(44100, 100, 6000, 16);
+  BOOST_CHECK(d1 == d2);
+  BOOST_CHECK(d1 != d3);
+  BOOST_CHECK_EQUAL(design_cache::size(), 2);
+
+  // and equals a design built directly
+  const D d(44100, 100, 8000, 16);
+  const auto x = utils::random<T>(-1.0, 1.0, 2000);
+  BOOST_CHECK(outputs(*d1, x) == outputs(d, x));
+
+  // cleared designs remain valid
+  design_cache::clear();
+  BOOST_CHECK_EQUAL(design_cache::size(), 0);
+  BOOST_CHECK(D::cached(44100, 100, 8000, 16) != d1);
+  BOOST_CHECK(outputs(*d1, x) == outputs(d, x));
+  design_cache::clear();
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(directory_works, D, cached_types)
+{
+  using T = typename D::scalar_type;
+  temporary_directory dir;
+  BOOST_REQUIRE(! dir.path.empty());
+
+  const std::string file = design_cache::file_name(
+    design_cache::make_key<D>(44100, 100, 8000, 16));
+  const std::string temporary = file + "." + std::to_string(getpid()) + ".tmp";
+  dir.files = {file, temporary};
+
+  design_cache::clear();
+  design_cache::set_directory(dir.path);
+  BOOST_CHECK_EQUAL(design_cache::directory(), dir.path);
+
+  const auto x = utils::random<T>(-1.0, 1.0, 2000);
+  const auto y = outputs(*D::cached(44100, 100, 8000, 16), x);
+
+  // a file is saved by the cores computing impulse responses
+  const bool convolution = detail::ir_cache<T>::size() > 0;
+  BOOST_CHECK_EQUAL(static_cast<bool>(std::ifstream(dir.path + "/" + file)), convolution);
+  BOOST_CHECK(! std::ifstream(dir.path + "/" + temporary));
+
+  // a new process loads them instead of computing them
+  design_cache::clear();
+  const auto d = D::cached(44100, 100, 8000, 16);
+  BOOST_CHECK(outputs(*d, x) == y);
+  BOOST_CHECK_EQUAL(detail::ir_cache<T>::size() > 0, convolution);
+
+  // corrupted files are ignored and rewritten
+  if(convolution)
+  {
+    {
+      std::fstream f(dir.path + "/" + file, std::ios::in | std::ios::out | std::ios::binary);
+      f.seekp(8);
+      const std::uint32_t version = 999;
+      f.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    }
+    design_cache::clear();
+    BOOST_CHECK(outputs(*D::cached(44100, 100, 8000, 16), x) == y);
+
+    design_cache::clear();
+    BOOST_CHECK(outputs(*D::cached(44100, 100, 8000, 16), x) == y);
+  }
+
+  design_cache::set_directory("");
+  design_cache::clear();
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE(recording_works)
+{
+  using irs = detail::ir_cache<double>;
+  design_cache::clear();
+
+  // requests of other threads are not recorded
+  std::vector<irs::key_type> keys;
+  irs::record(&keys);
+  std::thread([](){irs::attenuate(1000, 130, 44100, -60);}).join();
+  irs::attenuate(2000, 240, 44100, -60);
+  irs::record(nullptr);
+  irs::attenuate(3000, 350, 44100, -60);
+
+  BOOST_REQUIRE_EQUAL(keys.size(), 1);
+  BOOST_CHECK_EQUAL(keys[0][0], 2000);
+  BOOST_CHECK_EQUAL(irs::size(), 3);
+  design_cache::clear();
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE(clear_works)
+{
+  detail::ir_cache<float>::attenuate(1000, 130, 44100, -60);
+  detail::ir_cache<double>::attenuate(1000, 130, 44100, -60);
+  detail::ir_cache<long double>::attenuate(1000, 130, 44100, -60);
+
+  design_cache::clear();
+  BOOST_CHECK_EQUAL(detail::ir_cache<float>::size(), 0);
+  BOOST_CHECK_EQUAL(detail::ir_cache<double>::size(), 0);
+  BOOST_CHECK_EQUAL(detail::ir_cache<long double>::size(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,7 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/test_case_template.hpp>
 #include <filterbank_types.h>
+#include <gammatone/core/cooke1993_bank.hpp>
 #include <test_utils.hpp>
 using namespace gammatone;
 
@@ -33,6 +34,18 @@ protected:
 };
 
 
+// banks checked in both precisions
+using precision_types = boost::mpl::list
+  <
+  gammatone::filterbank<double,a1>,
+  gammatone::filterbank<double,a2>,
+  gammatone::filterbank<double,a3>,
+  gammatone::filterbank<float,a1>,
+  gammatone::filterbank<float,a2>,
+  gammatone::filterbank<float,a3>
+  >;
+
+
 BOOST_AUTO_TEST_SUITE(filterbank_concrete_test)
 
 
@@ -59,6 +72,73 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(accessors_works, F, filterbank_types<double>, f
 
 //================================================
 
+BOOST_AUTO_TEST_CASE(envelope_works)
+{
+  using T = double;
+  gammatone::filterbank<T,a1> f(44100, 500, 8000);
+  core::cooke1993_bank<T> bank(44100, f.center_frequency(), f.bandwidth());
+
+  f.set_decimation(441);
+  bank.set_decimation(441);
+  const auto& cf = f;
+  BOOST_CHECK_EQUAL(cf.decimation(), 441);
+
+  const auto x = utils::random<T>(-1.0, 1.0, 10000);
+  std::vector<T> e1((x.size()/441 + 1)*f.nb_channels()), e2(e1.size());
+  const std::size_t n = f.compute_envelope(x.size(), x.data(), e1.data());
+  BOOST_CHECK_EQUAL(n, x.size()/441);
+  BOOST_CHECK_EQUAL(bank.compute_envelope(x.size(), x.data(), e2.data()), n);
+  for(std::size_t i = 0; i < n*f.nb_channels(); i++)
+    BOOST_CHECK_EQUAL(e1[i], e2[i]);
+}
+
+//================================================
+
+// banks having an analytic output
+using analytic_types = boost::mpl::list
+  <
+  gammatone::filterbank<double,a1>,
+  gammatone::filterbank<float,a1>,
+  gammatone::filterbank<double,a3>
+  >;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(analytic_works, F, analytic_types)
+{
+  using T = typename F::scalar_type;
+  F f1(44100, 500, 8000), f2(f1), f3(f1);
+  const std::size_t n = f1.nb_channels();
+
+  const auto x = utils::random<T>(-1.0, 1.0, 5000);
+  std::vector<T> y(x.size()*n), e(y.size()), p(y.size());
+  std::vector<std::complex<T> > z(y.size());
+  f1.compute_ptr(x.size(), x.data(), y.data());
+  f2.compute_ptr_complex(x.size(), x.data(), z.data());
+  f3.compute_ptr_envelope(x.size(), x.data(), e.data());
+  f3.reset();
+  f3.compute_ptr_phase(x.size(), x.data(), p.data());
+
+  for(std::size_t k = 0; k < y.size(); k++)
+    {
+      BOOST_CHECK_EQUAL(z[k].real(), y[k]);
+      BOOST_CHECK_EQUAL(e[k], std::sqrt(z[k].real()*z[k].real() + z[k].imag()*z[k].imag()));
+      BOOST_CHECK_EQUAL(p[k], std::atan2(z[k].imag(), z[k].real()));
+    }
+
+  // each channel is the one of a single filter
+  std::vector<std::complex<T> > zj(x.size());
+  std::size_t j = 0;
+  for(auto filter : f1)
+    {
+      filter.reset();
+      filter.compute_ptr_complex(x.size(), x.data(), zj.data());
+      for(std::size_t i = 0; i < x.size(); i++)
+        BOOST_CHECK_EQUAL(zj[i], z[i*n + j]);
+      j++;
+    }
+}
+
+//================================================
+
 BOOST_AUTO_TEST_CASE(center_frequencies_works)
 {
   using T = double;
@@ -120,4 +200,140 @@ BOOST_FIXTURE_TEST_CASE_TEMPLATE(compute_works, F, filterbank_types<double>, fix
         }
 }
 
+//================================================
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(engine_works, F, precision_types, fixture<F>)
+{
+    using T = typename F::scalar_type;
+
+    const auto x = utils::random<T>(-1.0, 1.0, 1000);
+
+    F f(this->m_sample_frequency, this->m_low, this->m_high);
+    const auto ysize = f.nb_channels();
+
+    std::vector<T> y(x.size()*ysize);
+    f.compute_ptr(x.size(), x.data(), y.data());
+
+    // the engine must give the same result as each filter taken apart
+    std::size_t j = 0;
+    for(auto filter : f)
+    {
+        filter.reset();
+        for(std::size_t i=0; i < x.size(); i++)
+        {
+            T yy;
+            filter.compute(x[i], yy);
+            BOOST_CHECK_EQUAL(yy, y[i*ysize+j]);
+        }
+        j++;
+    }
+}
+
+//================================================
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(parallel_works, F, filterbank_types<double>, fixture<F>)
+{
+    using T = typename F::scalar_type;
+
+    const auto x = utils::random<T>(-1.0, 1.0, 1000);
+
+    F f1(this->m_sample_frequency, this->m_low, this->m_high);
+    F f2(f1), f3(f1), f4(f1);
+    const auto ysize = f1.nb_channels();
+
+    std::vector<T> y1(x.size()*ysize), y2(y1.size()), y3(y1.size()), y4(y1.size());
+    f1.compute_ptr(x.size(), x.data(), y1.data());
+    f2.compute_ptr(x.size(), x.data(), y2.data(), layout::planar);
+
+    // process in two calls to check the state is kept
+    for(std::size_t n : {1, 3, 0})
+    {
+        f3.reset();
+        f4.reset();
+        f3.compute_ptr_parallel(300, x.data(), y3.data(), layout::interleaved, n);
+        f3.compute_ptr_parallel(700, x.data()+300, y3.data()+300*ysize, layout::interleaved, n);
+        f4.compute_ptr_parallel(x.size(), x.data(), y4.data(), layout::planar, n);
+
+        for(std::size_t i=0; i < x.size(); i++)
+            for(std::size_t j=0; j < ysize; j++)
+            {
+                BOOST_CHECK_EQUAL(y1[i*ysize+j], y2[j*x.size()+i]);
+                BOOST_CHECK_EQUAL(y1[i*ysize+j], y3[i*ysize+j]);
+                BOOST_CHECK_EQUAL(y1[i*ysize+j], y4[j*x.size()+i]);
+            }
+    }
+}
+
+//================================================
+
+template<class T> using recursive_filterbank_types = boost::mpl::list
+  <
+  gammatone::filterbank<T,a1>,
+  gammatone::filterbank<T,a2>
+  >;
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(chunked_works, F, recursive_filterbank_types<double>, fixture<F>)
+{
+    using T = typename F::scalar_type;
+
+    const auto x = utils::random<T>(-1.0, 1.0, 1000);
+
+    F f1(this->m_sample_frequency, this->m_low, this->m_high);
+    F f2(f1), f3(f1);
+    const auto ysize = f1.nb_channels();
+
+    std::vector<T> y1(x.size()*ysize), y2(y1.size()), y3(y1.size());
+    f1.compute_ptr(x.size(), x.data(), y1.data());
+    f2.compute_ptr_chunked(x.size(), x.data(), y2.data(), layout::interleaved, 5);
+    f3.compute_ptr_chunked(x.size(), x.data(), y3.data(), layout::planar, 3);
+
+    // outputs scale varies a lot across channels
+    std::vector<T> scale(ysize, 0);
+    for(std::size_t i=0; i < y1.size(); i++)
+        scale[i%ysize] = std::max(scale[i%ysize], std::abs(y1[i]));
+
+    for(std::size_t i=0; i < x.size(); i++)
+        for(std::size_t j=0; j < ysize; j++)
+        {
+            BOOST_CHECK_SMALL(y1[i*ysize+j] - y2[i*ysize+j], 1e-7*scale[j]);
+            BOOST_CHECK_SMALL(y1[i*ysize+j] - y3[j*x.size()+i], 1e-7*scale[j]);
+        }
+
+    // the final states are the sequential ones
+    f1.compute_ptr(x.size(), x.data(), y1.data());
+    f2.compute_ptr(x.size(), x.data(), y2.data());
+    for(std::size_t i=0; i < y1.size(); i++)
+        BOOST_CHECK_SMALL(y1[i] - y2[i], 1e-7*scale[i%ysize]);
+}
+
+//================================================
+
+BOOST_FIXTURE_TEST_CASE_TEMPLATE(overlapped_works, F, filterbank_types<double>, fixture<F>)
+{
+    using T = typename F::scalar_type;
+
+    const auto x = utils::random<T>(-1.0, 1.0, 10000);
+
+    F f1(this->m_sample_frequency, this->m_low, this->m_high);
+    F f2(f1), f3(f1);
+    const auto ysize = f1.nb_channels();
+
+    std::vector<T> y1(x.size()*ysize), y2(y1.size()), y3(y1.size());
+    f1.compute_ptr(x.size(), x.data(), y1.data());
+    f2.compute_ptr_overlapped(x.size(), x.data(), y2.data(), layout::interleaved, -120, 5);
+    f3.compute_ptr_overlapped(x.size(), x.data(), y3.data(), layout::planar, -120, 3);
+
+    std::vector<T> scale(ysize, 0);
+    for(std::size_t i=0; i < y1.size(); i++)
+        scale[i%ysize] = std::max(scale[i%ysize], std::abs(y1[i]));
+
+    // -120 dB attenuation of the impulse responses
+    for(std::size_t i=0; i < x.size(); i++)
+        for(std::size_t j=0; j < ysize; j++)
+        {
+            BOOST_CHECK_SMALL(y1[i*ysize+j] - y2[i*ysize+j], 1e-5*scale[j]);
+            BOOST_CHECK_SMALL(y1[i*ysize+j] - y3[j*x.size()+i], 1e-5*scale[j]);
+        }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -18,7 +18,12 @@
 */
 
 #include <gammatone/detail/interface.hpp>
+#include <gammatone/polymorphic.hpp>
+#include <gammatone/filter.hpp>
+#include <gammatone/filterbank.hpp>
 #include <boost/test/unit_test.hpp>
+#include <test_utils.hpp>
+#include <memory>
 
 template<class Scalar>
 class child : public gammatone::detail::interface<Scalar,Scalar>
@@ -70,4 +75,40 @@ BOOST_AUTO_TEST_CASE(sample_frequency_works)
   BOOST_CHECK_EQUAL(d.sample_frequency()[2],true);
 }
 
+//================================================
+
+BOOST_AUTO_TEST_CASE(polymorphic_works)
+{
+  using filter = gammatone::filter<double>;
+  using filterbank = gammatone::filterbank<double>;
+  const auto x = utils::random<double>(-1.0, 1.0, 1000);
+
+  // filter through the virtual interface
+  filter f1(44100, 1000);
+  std::unique_ptr<gammatone::detail::interface<double,double> > f2(
+      new gammatone::polymorphic<filter>(f1));
+
+  BOOST_CHECK_EQUAL(f1.sample_frequency(), f2->sample_frequency());
+  BOOST_CHECK_EQUAL(f1.center_frequency(), f2->center_frequency());
+  BOOST_CHECK_EQUAL(f1.bandwidth(), f2->bandwidth());
+
+  std::vector<double> y1(x.size()), y2(x.size());
+  f1.compute_ptr(x.size(), x.data(), y1.data());
+  f2->compute_ptr(x.size(), x.data(), y2.data());
+  for(std::size_t i = 0; i < x.size(); i++)
+    BOOST_CHECK_EQUAL(y1[i], y2[i]);
+
+  // filterbank through the virtual interface
+  filterbank b1(44100, 500, 8000);
+  gammatone::polymorphic<filterbank> b2(b1);
+  gammatone::detail::interface<double,std::vector<double> >& b3 = b2;
+
+  BOOST_CHECK_EQUAL(b1.center_frequency().size(), b3.center_frequency().size());
+  const auto z1 = b1.compute_allocate(x[0]);
+  const auto z2 = b3.compute_allocate(x[0]);
+  BOOST_CHECK_EQUAL(z1.size(), b1.nb_channels());
+  for(std::size_t j = 0; j < z1.size(); j++)
+    BOOST_CHECK_EQUAL(z1[j], z2[j]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
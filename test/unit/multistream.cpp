@@ -0,0 +1,175 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <filterbank_types.h>
+#include <gammatone/multistream.hpp>
+#include <test_utils.hpp>
+using namespace gammatone;
+
+// multistreams checked in both precisions
+using multistream_types = boost::mpl::list
+  <
+  gammatone::multistream<double,a1>,
+  gammatone::multistream<double,a2>,
+  gammatone::multistream<double,a3>,
+  gammatone::multistream<float,a1>,
+  gammatone::multistream<float,a2>,
+  gammatone::multistream<float,a3>
+  >;
+
+using stream_scalars = boost::mpl::list<float,double>;
+
+// Outputs of a filterbank on each stream of an interleaved input,
+// stream k starting at [k*size*channels]
+template<class Filterbank, class T>
+std::vector<T> reference(const Filterbank& design, const std::vector<T>& x,
+                         const std::size_t& streams, const layout& l)
+{
+  const std::size_t size = x.size() / streams, channels = design.nb_channels();
+  std::vector<T> y(x.size() * channels), xk(size);
+  for(std::size_t k = 0; k < streams; ++k)
+    {
+      Filterbank f(design);
+      f.reset();
+      for(std::size_t i = 0; i < size; ++i) xk[i] = x[i*streams + k];
+      f.compute_ptr(size, xk.data(), y.data() + k*size*channels, l);
+    }
+  return y;
+}
+
+
+BOOST_AUTO_TEST_SUITE(multistream_test)
+
+//================================================
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(compute_works, F, multistream_types)
+{
+    using T = typename F::scalar_type;
+    const std::size_t streams = 5, size = 1000;
+
+    const typename F::filterbank_type design(44100, 500, 8000);
+    F m(design, streams);
+    BOOST_CHECK_EQUAL(m.nb_streams(), streams);
+    BOOST_CHECK_EQUAL(m.nb_channels(), design.nb_channels());
+    BOOST_CHECK_EQUAL(m.sample_frequency(), design.sample_frequency());
+
+    const std::size_t channels = m.nb_channels();
+    const auto x = utils::random<T>(-1.0, 1.0, size*streams);
+
+    // each stream gives the outputs of its own filterbank
+    for(const layout l : {layout::interleaved, layout::planar})
+    {
+        const auto y1 = reference(design, x, streams, l);
+
+        std::vector<T> y2(y1.size());
+        m.reset();
+        m.compute_ptr(size, x.data(), y2.data(), layout::interleaved, l);
+        BOOST_CHECK(y1 == y2);
+
+        // planar input
+        std::vector<T> xp(x.size());
+        for(std::size_t i = 0; i < size; ++i)
+            for(std::size_t k = 0; k < streams; ++k)
+                xp[k*size + i] = x[i*streams + k];
+
+        std::fill(y2.begin(), y2.end(), 0);
+        m.reset();
+        m.compute_ptr(size, xp.data(), y2.data(), layout::planar, l);
+        BOOST_CHECK(y1 == y2);
+    }
+
+    // streams taken from an interleaved PCM buffer with an extra
+    // channel, in two calls to check the states are kept
+    std::vector<T> pcm(size*(streams+1), 2);
+    for(std::size_t i = 0; i < size; ++i)
+        for(std::size_t k = 0; k < streams; ++k)
+            pcm[i*(streams+1) + k] = x[i*streams + k];
+
+    const auto y1 = reference(design, x, streams, layout::interleaved);
+    std::vector<T> y2(y1.size());
+    m.reset();
+    m.compute_strided(300, pcm.data(), streams+1, 1,
+                      y2.data(), channels, 1, size*channels);
+    m.compute_strided(700, pcm.data() + 300*(streams+1), streams+1, 1,
+                      y2.data() + 300*channels, channels, 1, size*channels);
+    BOOST_CHECK(y1 == y2);
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(kernels_works, T, stream_scalars)
+{
+    using streams_type = core::cooke1993_streams<T>;
+    using isa = typename streams_type::kernel_type;
+    const std::size_t size = 600;
+
+    // a number of channels which is not a multiple of the vector size
+    const std::vector<T> cf = {100, 1000, 4000}, bw = {50, 150, 500};
+    const std::size_t channels = cf.size();
+
+    // odd and even stream counts
+    for(const std::size_t streams : {1, 4, 7})
+    {
+        const auto x = utils::random<T>(-1.0, 1.0, size*streams);
+
+        // the scalar code is as many single channel cores
+        streams_type scalar(44100, cf, bw, streams);
+        BOOST_CHECK(scalar.set_kernel(isa::scalar));
+        std::vector<T> ref(x.size()*channels);
+        scalar.compute_strided(size, x.data(), streams, 1, ref.data(), channels, 1, size*channels);
+
+        for(std::size_t k = 0; k < streams; ++k)
+            for(std::size_t j = 0; j < channels; ++j)
+            {
+                core::cooke1993<T> c(44100, cf[j], bw[j]);
+                for(std::size_t i = 0; i < size; ++i)
+                {
+                    T y;
+                    c.compute(x[i*streams + k], y);
+                    BOOST_CHECK_EQUAL(y, ref[k*size*channels + i*channels + j]);
+                }
+            }
+
+        for(auto kernel : {isa::sse2, isa::avx2, isa::avx512})
+        {
+            streams_type s(44100, cf, bw, streams);
+            if(! s.set_kernel(kernel))
+            {
+                BOOST_CHECK(! detail::simd::supported(kernel));
+                continue;
+            }
+
+            // planar outputs in two calls, to check the states are kept
+            std::vector<T> y(ref.size());
+            s.compute_strided(400, x.data(), streams, 1, y.data(), 1, size, size*channels);
+            s.compute_strided(size - 400, x.data() + 400*streams, streams, 1,
+                              y.data() + 400, 1, size, size*channels);
+
+            for(std::size_t k = 0; k < streams; ++k)
+                for(std::size_t i = 0; i < size; ++i)
+                    for(std::size_t j = 0; j < channels; ++j)
+                        BOOST_CHECK_EQUAL(ref[k*size*channels + i*channels + j],
+                                          y[k*size*channels + j*size + i]);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
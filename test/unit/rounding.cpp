@@ -0,0 +1,61 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <gammatone/policy/rounding.hpp>
+#include <cstdint>
+
+using namespace gammatone::policy::rounding;
+
+
+BOOST_AUTO_TEST_SUITE(policy_rounding)
+
+
+//================================================
+
+BOOST_AUTO_TEST_CASE(rounding_works)
+{
+  // x / 4 for x in [-6, 6]
+  const std::int32_t x[] =     {-6, -5, -4, -3, -2, -1, 0, 1, 2, 3, 4, 5, 6};
+  const std::int32_t near[] =  {-1, -1, -1, -1,  0,  0, 0, 0, 1, 1, 1, 1, 2};
+  const std::int32_t even[] =  {-2, -1, -1, -1,  0,  0, 0, 0, 0, 1, 1, 1, 2};
+  const std::int32_t floor[] = {-2, -2, -1, -1, -1, -1, 0, 0, 0, 0, 1, 1, 1};
+
+  for(std::size_t i = 0; i < 13; i++)
+    {
+      BOOST_CHECK_EQUAL(nearest::shift(x[i], 2), near[i]);
+      BOOST_CHECK_EQUAL(convergent::shift(x[i], 2), even[i]);
+      BOOST_CHECK_EQUAL(truncate::shift(x[i], 2), floor[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(wide_types_works)
+{
+  const std::int64_t x = (std::int64_t(1) << 62) + (std::int64_t(1) << 30);
+
+  // ties
+  BOOST_CHECK_EQUAL(nearest::shift(x, 31), (std::int64_t(1) << 31) + 1);
+  BOOST_CHECK_EQUAL(convergent::shift(x, 31), std::int64_t(1) << 31);
+  BOOST_CHECK_EQUAL(truncate::shift(x, 31), std::int64_t(1) << 31);
+  BOOST_CHECK_EQUAL(nearest::shift(-x, 31), -(std::int64_t(1) << 31));
+  BOOST_CHECK_EQUAL(truncate::shift(-x, 31), -(std::int64_t(1) << 31) - 1);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
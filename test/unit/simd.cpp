@@ -0,0 +1,234 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/test_case_template.hpp>
+#include <boost/mpl/list.hpp>
+#include <gammatone/core/cooke1993_bank.hpp>
+#include <gammatone/core/slaney1993_bank.hpp>
+#include <gammatone/detail/slaney1993_simd.hpp>
+#include <gammatone/detail/dot_product.hpp>
+#include <gammatone/detail/simd.hpp>
+#include <gammatone/detail/utils.hpp>
+#include <gammatone/policy/bandwidth.hpp>
+#include <test_utils.hpp>
+using namespace gammatone;
+
+using simd_scalars = boost::mpl::list<float,double>;
+using detail::simd::isa;
+
+BOOST_AUTO_TEST_SUITE(simd_test)
+
+//================================================
+
+BOOST_AUTO_TEST_CASE(isa_works)
+{
+    BOOST_CHECK(detail::simd::supported(isa::scalar));
+    BOOST_CHECK(detail::simd::supported(detail::simd::best()));
+
+    BOOST_CHECK_EQUAL(detail::simd::padded_size<double>(0), 0);
+    BOOST_CHECK_EQUAL(detail::simd::padded_size<double>(1), 8);
+    BOOST_CHECK_EQUAL(detail::simd::padded_size<float>(17), 32);
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(aligned_allocator_works, T, simd_scalars)
+{
+    std::vector<T, detail::simd::aligned_allocator<T> > v(13, 1.0);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(v.data()) % 64, 0);
+
+    v.resize(1000, 2.0);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(v.data()) % 64, 0);
+    BOOST_CHECK_EQUAL(v[12], 1.0);
+    BOOST_CHECK_EQUAL(v[13], 2.0);
+}
+
+//================================================
+
+using bank_types = boost::mpl::list
+  <
+  core::cooke1993_bank<float>,
+  core::cooke1993_bank<double>,
+  core::slaney1993_bank<float>,
+  core::slaney1993_bank<double>
+  >;
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(kernels_works, bank, bank_types)
+{
+    using T = typename bank::scalar_type;
+    const T fs = 44100;
+
+    // a number of channels which is not a multiple of the vector size
+    const std::size_t nb_channels = 37;
+    const auto cf = detail::linspace<T>(T(100), T(8000), nb_channels);
+    std::vector<T> bw(nb_channels);
+    for(std::size_t j = 0; j < nb_channels; j++)
+        bw[j] = policy::bandwidth::glasberg1990<T>::bandwidth(cf[j]);
+
+    const auto x = utils::random<T>(-1.0, 1.0, 1000);
+
+    bank scalar(fs, cf, bw);
+    BOOST_CHECK(scalar.set_kernel(isa::scalar));
+    BOOST_CHECK(scalar.kernel() == isa::scalar);
+    std::vector<T> ref(x.size() * nb_channels);
+    scalar.compute_ptr(x.size(), x.data(), ref.data());
+
+    for(auto k : {isa::sse2, isa::avx2, isa::avx512})
+    {
+        bank b(fs, cf, bw);
+        if(! b.set_kernel(k))
+        {
+            BOOST_CHECK(! detail::simd::supported(k));
+            continue;
+        }
+        BOOST_CHECK(b.kernel() == k);
+
+        // compute in two calls to check states are kept
+        std::vector<T> y(x.size() * nb_channels);
+        b.compute_ptr(400, x.data(), y.data());
+        b.compute_ptr(x.size() - 400, x.data() + 400, y.data() + 400*nb_channels);
+
+        for(std::size_t i = 0; i < y.size(); i++)
+            BOOST_CHECK_EQUAL(ref[i], y[i]);
+    }
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(unaligned_slices_works, bank, bank_types)
+{
+    using T = typename bank::scalar_type;
+    const T fs = 44100;
+
+    // slice boundaries within a group of lanes of every kernel
+    const std::size_t nb_channels = 10;
+    const auto cf = detail::linspace<T>(T(100), T(8000), nb_channels);
+    std::vector<T> bw(nb_channels);
+    for(std::size_t j = 0; j < nb_channels; j++)
+        bw[j] = policy::bandwidth::glasberg1990<T>::bandwidth(cf[j]);
+
+    const auto x = utils::random<T>(-1.0, 1.0, 1000);
+
+    for(auto k : {isa::scalar, isa::sse2, isa::avx2, isa::avx512})
+    {
+        bank whole(fs, cf, bw), sliced(fs, cf, bw);
+        if(! whole.set_kernel(k)) continue;
+        sliced.set_kernel(k);
+
+        std::vector<T> ref(x.size() * nb_channels), y(x.size() * nb_channels);
+        whole.compute_ptr(x.size(), x.data(), ref.data());
+
+        // sequential slices, each channel being computed once per block
+        for(std::size_t i = 0; i < x.size(); i += 500)
+            for(auto s : {std::make_pair(0, 3), std::make_pair(3, 5), std::make_pair(5, 10)})
+                sliced.compute_ptr(500, x.data() + i, y.data() + i*nb_channels,
+                                   layout::interleaved, s.first, s.second);
+
+        for(std::size_t i = 0; i < y.size(); i++)
+            BOOST_CHECK_EQUAL(ref[i], y[i]);
+    }
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(pipeline_kernels_works, T, simd_scalars)
+{
+    const auto x = utils::random<T>(-1.0, 1.0, 100);
+
+    // the reference, one stage after the other
+    detail::slaney1993_cascade<T> c1;
+    c1.gain = 2;
+    for(std::size_t k = 0; k < 4; k++)
+    {
+        c1.a0[k] = T(0.1)*(k+1); c1.a1[k] = -T(0.05)*k; c1.a2[k] = T(0.01);
+        c1.b1[k] = -T(1.8); c1.b2[k] = T(0.9);
+        c1.z1[k] = T(0.01)*k; c1.z2[k] = -T(0.02)*k;
+    }
+    std::vector<T> y1(x.size());
+    for(std::size_t i = 0; i < x.size(); i++)
+    {
+        y1[i] = x[i] / c1.gain;
+        for(std::size_t k = 0; k < 4; k++) y1[i] = c1.step(k, y1[i]);
+    }
+
+    // all sizes around the pipeline depth, in place
+    for(auto k : {isa::sse2, isa::avx2, isa::avx512})
+        for(std::size_t n : {3, 4, 5, 100})
+        {
+            if(! detail::simd::supported(k)) continue;
+
+            detail::slaney1993_cascade<T> c2 = c1;
+            for(std::size_t s = 0; s < 4; s++)
+            {
+                c2.z1[s] = T(0.01)*s;
+                c2.z2[s] = -T(0.02)*s;
+            }
+            std::vector<T> y2(x.begin(), x.begin() + n);
+            BOOST_CHECK(detail::slaney1993_pipeline_dispatch(k, c2, y2.data(), y2.data(), n));
+            for(std::size_t i = 0; i < n; i++)
+                BOOST_CHECK_EQUAL(y1[i], y2[i]);
+            if(n == x.size())
+                for(std::size_t s = 0; s < 4; s++)
+                {
+                    BOOST_CHECK_EQUAL(c1.z1[s], c2.z1[s]);
+                    BOOST_CHECK_EQUAL(c1.z2[s], c2.z2[s]);
+                }
+        }
+
+    detail::slaney1993_cascade<T> c3 = c1;
+    BOOST_CHECK(! detail::slaney1993_pipeline_dispatch(detail::simd::best(), c3, x.data(), y1.data(), 2));
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(dot_product_kernels_works, T, simd_scalars)
+{
+    const auto a = utils::random<T>(-1.0, 1.0, 300);
+    const auto b = utils::random<T>(-1.0, 1.0, 300);
+
+    for(auto k : {isa::scalar, isa::sse2, isa::avx2, isa::avx512})
+    {
+        if(! detail::simd::supported(k)) continue;
+
+        // sizes around the vector and the unrolled loop widths
+        for(std::size_t n = 0; n < a.size(); n += (n < 70 ? 1 : 37))
+        {
+            const T ref = std::inner_product(a.begin(), a.begin() + n, b.begin(), T(0));
+            const T y = detail::dot_product_dispatch(k, a.data(), b.data(), n);
+            if(k == isa::scalar)
+                BOOST_CHECK_EQUAL(ref, y);
+            else
+                BOOST_CHECK_SMALL(ref - y, T(n) * std::numeric_limits<T>::epsilon());
+        }
+    }
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE(clipping_disables_kernels)
+{
+    using bank = core::cooke1993_bank<double, policy::gain::forall_0dB, policy::clipping::on>;
+    bank b(44100, {1000}, {100});
+
+    BOOST_CHECK(b.kernel() == isa::scalar);
+    BOOST_CHECK(! b.set_kernel(isa::sse2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
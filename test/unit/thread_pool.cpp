@@ -0,0 +1,108 @@
+/*
+  Copyright (C) 2015, 2016 Mathieu Bernard <mathieu_bernard@laposte.net>
+
+  This file is part of libgammatone
+
+  libgammatone is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with libgammatone. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <gammatone/detail/thread_pool.hpp>
+#include <atomic>
+#include <chrono>
+#include <numeric>
+#include <vector>
+
+using namespace gammatone::detail;
+
+BOOST_AUTO_TEST_SUITE(detail_thread_pool)
+
+//================================================
+
+BOOST_AUTO_TEST_CASE(parallel_for_works)
+{
+    thread_pool pool(3);
+    BOOST_CHECK_EQUAL(pool.size(), 3);
+
+    std::vector<int> v(1000, 0);
+    pool.parallel_for(v.size(), [&](const std::size_t& k){v[k] += k;});
+    for(std::size_t k = 0; k < v.size(); k++)
+        BOOST_CHECK_EQUAL(v[k], k);
+
+    // nested calls must not deadlock
+    std::atomic<std::size_t> count(0);
+    pool.parallel_for(8, [&](const std::size_t&){
+            pool.parallel_for(8, [&](const std::size_t&){count++;});
+        });
+    BOOST_CHECK_EQUAL(count, 64);
+
+    // empty loop
+    pool.parallel_for(0, [&](const std::size_t&){count++;});
+    BOOST_CHECK_EQUAL(count, 64);
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE(parallel_for_stealing_works)
+{
+    thread_pool pool(3);
+
+    // unbalanced calls, each index being called once
+    std::vector<std::atomic<int> > calls(1000);
+    for(auto& c : calls) c = 0;
+    std::atomic<bool> bad_worker(false);
+    pool.parallel_for_stealing(calls.size(), 0, [&](const std::size_t& w, const std::size_t& k){
+            if(w >= pool.concurrency()) bad_worker = true;
+            if(k < 10) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            calls[k]++;
+        });
+    BOOST_CHECK(! bad_worker);
+    for(std::size_t k = 0; k < calls.size(); k++)
+        BOOST_CHECK_EQUAL(calls[k], 1);
+
+    // more workers than calls, or than threads
+    std::atomic<std::size_t> count(0);
+    pool.parallel_for_stealing(2, 8, [&](const std::size_t&, const std::size_t&){count++;});
+    pool.parallel_for_stealing(100, 8, [&](const std::size_t&, const std::size_t&){count++;});
+    BOOST_CHECK_EQUAL(count, 102);
+
+    // empty loop
+    pool.parallel_for_stealing(0, 0, [&](const std::size_t&, const std::size_t&){count++;});
+    BOOST_CHECK_EQUAL(count, 102);
+}
+
+//================================================
+
+BOOST_AUTO_TEST_CASE(split_works)
+{
+    const auto b1 = split(100, 4);
+    BOOST_CHECK_EQUAL(b1.size(), 5);
+    BOOST_CHECK_EQUAL(b1.front(), 0);
+    BOOST_CHECK_EQUAL(b1.back(), 100);
+
+    const auto b2 = split(37, 3, 8);
+    BOOST_CHECK_EQUAL(b2.size(), 4);
+    for(std::size_t k = 0; k + 1 < b2.size(); k++)
+    {
+        BOOST_CHECK_EQUAL(b2[k] % 8, 0);
+        BOOST_CHECK_LT(b2[k], b2[k+1]);
+    }
+    BOOST_CHECK_EQUAL(b2.back(), 37);
+
+    // less slices than requested
+    BOOST_CHECK_EQUAL(split(10, 4, 8).size(), 3);
+    BOOST_CHECK_EQUAL(split(0, 4).size(), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()